@@ -15,6 +15,10 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 #include "dwgreader.h"
 #include "drw_textcodec.h"
 #include "drw_dbg.h"
@@ -909,31 +913,153 @@ bool dwgReader::readPlineVertex(DRW_Polyline& pline, dwgBuffer *dbuf){
     return ret;
 }
 
-bool dwgReader::readDwgEntities(DRW_Interface& intfa, dwgBuffer *dbuf){
+/**
+ * Reads the polyline vertices from the already extracted raw objects,
+ * the handles of the vertices and seqend are returned in consumed
+ */
+bool dwgReader::readPlineVertex(DRW_Polyline& pline, const std::unordered_map<duint32, const dwgRawObject*>& rawIndex,
+                                std::vector<duint32>& consumed){
     bool ret = true;
+    auto parseVertex = [&](duint32 handle, duint32 &nextLink) {
+        auto mit = rawIndex.find(handle);
+        if (mit == rawIndex.end()) {
+            DRW_DBG("\nWARNING: pline vertex not found\n");
+            ret = false;
+            return false;
+        }
+        const dwgRawObject *raw = mit->second;
+        consumed.push_back(handle);
+        DRW_Vertex vt;
+        dwgBuffer buff(const_cast<duint8*>(raw->data.data()), raw->data.size(), &decoder);
+        bool ret2 = vt.parseDwg(version, &buff, raw->bs, pline.basePoint.z);
+        pline.addVertex(vt);
+        nextLink = vt.nextEntLink;
+        ret = ret && ret2;
+        return true;
+    };
 
-    DRW_DBG("\nobject map total size= "); DRW_DBG(ObjectMap.size());
-    auto itB=ObjectMap.begin();
-    auto itE=ObjectMap.end();
-    while (itB != itE) {
-        if (ret) {
-            // once readDwgEntity() failed, just clear the ObjectMap
-            ret = readDwgEntity( dbuf, itB->second, intfa);
+    duint32 nextLink = 0;
+    if (version < DRW::AC1018) { //pre 2004
+        duint32 nextH = pline.firstEH;
+        while (nextH != 0){
+            if (!parseVertex(nextH, nextLink))
+                break;//end while if entity not found
+            if (nextH == pline.lastEH)
+                nextH = 0; //redundant, but prevent read errors
+            else
+                nextH = nextLink;
         }
-        ObjectMap.erase( itB);
-        itB = ObjectMap.begin();
+    } else {//2004+
+        for (duint32 nextH: pline.hadlesList)
+            parseVertex(nextH, nextLink);
     }
+    consumed.push_back(pline.seqEndH.ref);
+
     return ret;
 }
 
 /**
- * Reads a dwg drawing entity (dwg object entity) given its offset in the file
+ * Reads the drawing entities in two phases: the raw bytes of all objects are
+ * extracted first walking the object stream in file order, then the entities
+ * are decoded in parallel chunks and delivered in file order to DRW_Interface.
  */
-bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& intfa){
+bool dwgReader::readDwgEntities(DRW_Interface& intfa, dwgBuffer *dbuf){
     bool ret = true;
-    duint32 bs = 0;
 
-    nextEntLink = prevEntLink = 0;// set to 0 to skip unimplemented entities
+    DRW_DBG("\nobject map total size= "); DRW_DBG(ObjectMap.size());
+    std::vector<objHandle> objs;
+    objs.reserve(ObjectMap.size());
+    for (const auto& it: ObjectMap) {
+        objs.push_back(it.second);
+    }
+    ObjectMap.clear();
+    std::sort(objs.begin(), objs.end(), [](const objHandle& a, const objHandle& b) {
+        return a.loc < b.loc;
+    });
+
+    //phase 1: sequential extraction, a failed read stops like a failed entity
+    std::vector<dwgRawObject> raws(objs.size());
+    std::size_t count = 0;
+    for (; count < objs.size(); ++count) {
+        if (!readRawObject(dbuf, objs[count], raws[count])) {
+            ret = false;
+            break;
+        }
+    }
+    raws.resize(count);
+    std::unordered_map<duint32, const dwgRawObject*> rawIndex;
+    rawIndex.reserve(count);
+    for (const dwgRawObject& raw: raws) {
+        rawIndex[raw.obj.handle] = &raw;
+    }
+
+    //phase 2: parallel decoding, the debug printer is not thread safe
+    unsigned int threads = std::thread::hardware_concurrency();
+    if (threads == 0 || DRW_DBGGL == DRW_dbg::Level::Debug)
+        threads = 1;
+    const std::size_t chunkSize = 4096;
+    std::vector<dwgDecodedEntity> decoded;
+    std::vector<objHandle> objects;
+    std::unordered_set<duint32> consumed;
+    bool delivering = true;
+    for (std::size_t first = 0; first < count && delivering; first += chunkSize) {
+        std::size_t last = std::min(count, first + chunkSize);
+        decoded.clear();
+        decoded.resize(last - first);
+        std::atomic<std::size_t> next{first};
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < last; i = next++) {
+                dwgDecodedEntity &d = decoded[i - first];
+                d.entity = parseDwgEntity(raws[i], d.ret);
+                duint32 oType = raws[i].obj.type;
+                if (d.ret && d.entity != nullptr && (oType == 15 || oType == 16 || oType == 29)) {
+                    readPlineVertex(static_cast<DRW_Polyline&>(*d.entity), rawIndex, d.consumed);
+                }
+            }
+        };
+        std::size_t workers = std::min<std::size_t>(threads, (last - first + 255) / 256);
+        std::vector<std::thread> pool;
+        for (std::size_t t = 1; t < workers; ++t)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& t: pool)
+            t.join();
+
+        //in-order delivery
+        for (std::size_t i = first; i < last; ++i) {
+            dwgDecodedEntity &d = decoded[i - first];
+            objHandle &obj = raws[i].obj;
+            consumed.insert(d.consumed.begin(), d.consumed.end());
+            if (d.entity == nullptr) {
+                if (!d.ret) {
+                    ret = delivering = false;
+                    break;
+                }
+                //not supported or are object, add to remaining map when all are read
+                objects.push_back(obj);
+                continue;
+            }
+            if (!d.ret) {
+                DRW_DBG("Warning: Entity type "); DRW_DBG(obj.type);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+                ret = delivering = false;
+                break;
+            }
+            addDwgEntity(d.entity.get(), obj.type, intfa);
+        }
+    }
+    //polyline vertices and seqend are read with the polyline, even when found before it
+    for (const objHandle& obj: objects) {
+        if (consumed.count(obj.handle) == 0)
+            objObjectMap[obj.handle] = obj;
+    }
+    return ret;
+}
+
+/**
+ * Reads the raw bytes of a dwg object given its offset in the file
+ */
+bool dwgReader::readRawObject(dwgBuffer *dbuf, const objHandle& obj, dwgRawObject& raw){
+    raw.obj = obj;
     dbuf->setPosition(obj.loc);
     //verify if position is ok:
     if (!dbuf->isGood()){
@@ -942,24 +1068,36 @@ bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
     }
     int size = dbuf->getModularShort();
     if (version > DRW::AC1021) {//2010+
-        bs = dbuf->getUModularChar();
+        raw.bs = dbuf->getUModularChar();
     }
-    std::vector<duint8> tmpByteStr(size);
-    dbuf->getBytes(tmpByteStr.data(), size);
+    raw.data.resize(size);
+    dbuf->getBytes(raw.data.data(), size);
     //verify if getBytes is ok:
     if (!dbuf->isGood()) {
         DRW_DBG(" Warning: readDwgEntity, bad size\n");
         return false;
     }
-    dwgBuffer buff(tmpByteStr.data(), size, &decoder);
+    return true;
+}
+
+/**
+ * Decodes a drawing entity from its raw bytes, only reads the shared tables
+ * so it can run concurrently for different objects.
+ * Returns nullptr for unsupported entities and objects, ret is set to false
+ * if the object can not be decoded.
+ */
+std::unique_ptr<DRW_Entity> dwgReader::parseDwgEntity(dwgRawObject& raw, bool& ret){
+    ret = true;
+    dwgBuffer buff(raw.data.data(), raw.data.size(), &decoder);
     dint16 oType = buff.getObjType(version);
     buff.resetPosition();
 
     if (oType > 499){
         auto it = classesmap.find(oType);
         if (it == classesmap.end()){//fail, not found in classes set error
-            DRW_DBG("Class "); DRW_DBG(oType);DRW_DBG("not found, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
-            return false;
+            DRW_DBG("Class "); DRW_DBG(oType);DRW_DBG("not found, handle: "); DRW_DBG(raw.obj.handle); DRW_DBG("\n");
+            ret = false;
+            return nullptr;
         } else {
             DRW_Class *cl = it->second;
             if (cl->dwgType != 0)
@@ -967,201 +1105,148 @@ bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
         }
     }
 
-    obj.type = oType;
+    raw.obj.type = oType;
+    std::unique_ptr<DRW_Entity> e;
     switch (oType) {
-        case 17: {
-            DRW_Arc e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addArc(e);
-            }
-            break; }
-        case 18: {
-            DRW_Circle e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addCircle(e);
-            }
-            break; }
-        case 19:{
-            DRW_Line e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addLine(e);
-            }
-            break;}
-        case 27: {
-            DRW_Point e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addPoint(e);
-            }
-            break; }
-        case 35: {
-            DRW_Ellipse e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addEllipse(e);
-            }
-            break; }
+        case 17: e = std::make_unique<DRW_Arc>(); break;
+        case 18: e = std::make_unique<DRW_Circle>(); break;
+        case 19: e = std::make_unique<DRW_Line>(); break;
+        case 27: e = std::make_unique<DRW_Point>(); break;
+        case 35: e = std::make_unique<DRW_Ellipse>(); break;
         case 7:
-        case 8: {//minsert = 8
-            DRW_Insert e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.name = findTableName(DRW::BLOCK_RECORD,
-                                       e.blockRecH.ref);//RLZ: find as block or blockrecord (ps & ps0)
-                intfa.addInsert(e);
-            }
-            break; }
-        case 77: {
-            DRW_LWPolyline e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addLWPolyline(e);
-            }
-            break; }
-        case 1: {
-            DRW_Text e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::STYLE, e.styleH.ref);
-                intfa.addText(e);
-            }
+        case 8: e = std::make_unique<DRW_Insert>(); break;//minsert = 8
+        case 77: e = std::make_unique<DRW_LWPolyline>(); break;
+        case 1: e = std::make_unique<DRW_Text>(); break;
+        case 44: e = std::make_unique<DRW_MText>(); break;
+        case 28: e = std::make_unique<DRW_3Dface>(); break;
+        case 20: e = std::make_unique<DRW_DimOrdinate>(); break;
+        case 21: e = std::make_unique<DRW_DimLinear>(); break;
+        case 22: e = std::make_unique<DRW_DimAligned>(); break;
+        case 23: e = std::make_unique<DRW_DimAngular3p>(); break;
+        case 24: e = std::make_unique<DRW_DimAngular>(); break;
+        case 25: e = std::make_unique<DRW_DimRadial>(); break;
+        case 26: e = std::make_unique<DRW_DimDiametric>(); break;
+        case 45: e = std::make_unique<DRW_Leader>(); break;
+        case 31: e = std::make_unique<DRW_Solid>(); break;
+        case 78: e = std::make_unique<DRW_Hatch>(); break;
+        case 32: e = std::make_unique<DRW_Trace>(); break;
+        case 34: e = std::make_unique<DRW_Viewport>(); break;
+        case 36: e = std::make_unique<DRW_Spline>(); break;
+        case 40: e = std::make_unique<DRW_Ray>(); break;
+        case 15:    // pline 2D
+        case 16:    // pline 3D
+        case 29:    // pline PFACE
+            e = std::make_unique<DRW_Polyline>(); break;
+//        case 30: // MESH (not pline)
+        case 41: e = std::make_unique<DRW_Xline>(); break;
+        case 101: e = std::make_unique<DRW_Image>(); break;
+        default:
+            //not supported or are object
+            return nullptr;
+    }
+
+    ret = e->parseDwg(version, &buff, raw.bs);
+    if (!ret)
+        return e;
+    parseAttribs(e.get());
+    switch (oType) {
+        case 7:
+        case 8: {
+            auto ins = static_cast<DRW_Insert*>(e.get());
+            ins->name = findTableName(DRW::BLOCK_RECORD,
+                                      ins->blockRecH.ref);//RLZ: find as block or blockrecord (ps & ps0)
             break; }
+        case 1:
         case 44: {
-            DRW_MText e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::STYLE, e.styleH.ref);
-                intfa.addMText(e);
-            }
-            break; }
-        case 28: {
-            DRW_3Dface e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.add3dFace(e);
-            }
-            break; }
-        case 20: {
-            DRW_DimOrdinate e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimOrdinate(&e);
-            }
-            break; }
-        case 21: {
-            DRW_DimLinear e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimLinear(&e);
-            }
-            break; }
-        case 22: {
-            DRW_DimAligned e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimAlign(&e);
-            }
-            break; }
-        case 23: {
-            DRW_DimAngular3p e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimAngular3P(&e);
-            }
-            break; }
-        case 24: {
-            DRW_DimAngular e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimAngular(&e);
-            }
-            break; }
-        case 25: {
-            DRW_DimRadial e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimRadial(&e);
-            }
+            auto txt = static_cast<DRW_Text*>(e.get());
+            txt->style = findTableName(DRW::STYLE, txt->styleH.ref);
             break; }
+        case 20:
+        case 21:
+        case 22:
+        case 23:
+        case 24:
+        case 25:
         case 26: {
-            DRW_DimDiametric e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addDimDiametric(&e);
-            }
+            auto dim = static_cast<DRW_Dimension*>(e.get());
+            dim->style = findTableName(DRW::DIMSTYLE, dim->dimStyleH.ref);
             break; }
         case 45: {
-            DRW_Leader e;
-            if (entryParse( e, buff, bs, ret)) {
-                e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-                intfa.addLeader(&e);
-            }
-            break; }
-        case 31: {
-            DRW_Solid e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addSolid(e);
-            }
-            break; }
-        case 78: {
-            DRW_Hatch e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addHatch(&e);
-            }
-            break; }
-        case 32: {
-            DRW_Trace e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addTrace(e);
-            }
-            break; }
-        case 34: {
-            DRW_Viewport e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addViewport(e);
-            }
-            break; }
-        case 36: {
-            DRW_Spline e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addSpline(&e);
-            }
+            auto leader = static_cast<DRW_Leader*>(e.get());
+            leader->style = findTableName(DRW::DIMSTYLE, leader->dimStyleH.ref);
             break; }
-        case 40: {
-            DRW_Ray e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addRay(e);
-            }
-            break; }
-        case 15:    // pline 2D
-        case 16:    // pline 3D
-        case 29: {  // pline PFACE
-            DRW_Polyline e;
-            if (entryParse( e, buff, bs, ret)) {
-                readPlineVertex(e, dbuf);
-                intfa.addPolyline(e);
-            }
-            break; }
-//        case 30: {
-//            DRW_Polyline e;// MESH (not pline)
-//            ENTRY_PARSE(e)
-//            intfa.addRay(e);
-//            break; }
-        case 41: {
-            DRW_Xline e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addXline(e);
-            }
-            break; }
-        case 101: {
-            DRW_Image e;
-            if (entryParse( e, buff, bs, ret)) {
-                intfa.addImage(&e);
-            }
-            break; }
-
         default:
-            //not supported or are object add to remaining map
-            objObjectMap[obj.handle]= obj;
             break;
     }
-    if (!ret){
-        DRW_DBG("Warning: Entity type "); DRW_DBG(oType);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+    return e;
+}
+
+/**
+ * Sends a decoded drawing entity of type oType to the interface
+ */
+void dwgReader::addDwgEntity(DRW_Entity* e, duint32 oType, DRW_Interface& intfa){
+    switch (oType) {
+        case 17: intfa.addArc(*static_cast<DRW_Arc*>(e)); break;
+        case 18: intfa.addCircle(*static_cast<DRW_Circle*>(e)); break;
+        case 19: intfa.addLine(*static_cast<DRW_Line*>(e)); break;
+        case 27: intfa.addPoint(*static_cast<DRW_Point*>(e)); break;
+        case 35: intfa.addEllipse(*static_cast<DRW_Ellipse*>(e)); break;
+        case 7:
+        case 8: intfa.addInsert(*static_cast<DRW_Insert*>(e)); break;
+        case 77: intfa.addLWPolyline(*static_cast<DRW_LWPolyline*>(e)); break;
+        case 1: intfa.addText(*static_cast<DRW_Text*>(e)); break;
+        case 44: intfa.addMText(*static_cast<DRW_MText*>(e)); break;
+        case 28: intfa.add3dFace(*static_cast<DRW_3Dface*>(e)); break;
+        case 20: intfa.addDimOrdinate(static_cast<DRW_DimOrdinate*>(e)); break;
+        case 21: intfa.addDimLinear(static_cast<DRW_DimLinear*>(e)); break;
+        case 22: intfa.addDimAlign(static_cast<DRW_DimAligned*>(e)); break;
+        case 23: intfa.addDimAngular3P(static_cast<DRW_DimAngular3p*>(e)); break;
+        case 24: intfa.addDimAngular(static_cast<DRW_DimAngular*>(e)); break;
+        case 25: intfa.addDimRadial(static_cast<DRW_DimRadial*>(e)); break;
+        case 26: intfa.addDimDiametric(static_cast<DRW_DimDiametric*>(e)); break;
+        case 45: intfa.addLeader(static_cast<DRW_Leader*>(e)); break;
+        case 31: intfa.addSolid(*static_cast<DRW_Solid*>(e)); break;
+        case 78: intfa.addHatch(static_cast<DRW_Hatch*>(e)); break;
+        case 32: intfa.addTrace(*static_cast<DRW_Trace*>(e)); break;
+        case 34: intfa.addViewport(*static_cast<DRW_Viewport*>(e)); break;
+        case 36: intfa.addSpline(static_cast<DRW_Spline*>(e)); break;
+        case 40: intfa.addRay(*static_cast<DRW_Ray*>(e)); break;
+        case 15:
+        case 16:
+        case 29: intfa.addPolyline(*static_cast<DRW_Polyline*>(e)); break;
+        case 41: intfa.addXline(*static_cast<DRW_Xline*>(e)); break;
+        case 101: intfa.addImage(static_cast<DRW_Image*>(e)); break;
+        default: break;
     }
+}
 
+/**
+ * Reads a dwg drawing entity (dwg object entity) given its offset in the file
+ */
+bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& intfa){
+    nextEntLink = prevEntLink = 0;// set to 0 to skip unimplemented entities
+    dwgRawObject raw;
+    if (!readRawObject(dbuf, obj, raw))
+        return false;
+
+    bool ret = true;
+    std::unique_ptr<DRW_Entity> e = parseDwgEntity(raw, ret);
+    obj.type = raw.obj.type;
+    if (e == nullptr) {
+        //not supported or are object add to remaining map
+        if (ret)
+            objObjectMap[obj.handle]= obj;
+        return ret;
+    }
+    if (!ret){
+        DRW_DBG("Warning: Entity type "); DRW_DBG(obj.type);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+        return ret;
+    }
+    nextEntLink = e->nextEntLink;
+    prevEntLink = e->prevEntLink;
+    if (obj.type == 15 || obj.type == 16 || obj.type == 29)
+        readPlineVertex(static_cast<DRW_Polyline&>(*e), dbuf);
+    addDwgEntity(e.get(), obj.type, intfa);
     return ret;
 }
 
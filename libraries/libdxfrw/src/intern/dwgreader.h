@@ -16,6 +16,7 @@
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <vector>
 #include "drw_textcodec.h"
 #include "dwgutil.h"
 #include "dwgbuffer.h"
@@ -34,6 +35,22 @@ public:
     duint32 loc{0};
 };
 
+/** Raw bytes of a dwg object, extracted from the object stream */
+class dwgRawObject{
+public:
+    objHandle obj;
+    duint32 bs{0};
+    std::vector<duint8> data;
+};
+
+/** Entity decoded from a dwgRawObject, waiting for its in-order delivery */
+class dwgDecodedEntity{
+public:
+    std::unique_ptr<DRW_Entity> entity;
+    std::vector<duint32> consumed; //vertices & seqend read with a polyline
+    bool ret{true};
+};
+
 //until 2000 = 2000-
 //since 2004 except 2007 = 2004+
 // 2007 = 2007
@@ -155,6 +172,11 @@ protected:
     bool readDwgEntities(DRW_Interface& intfa, dwgBuffer *dbuf);
     bool readDwgObjects(DRW_Interface& intfa, dwgBuffer *dbuf);
     bool readPlineVertex(DRW_Polyline& pline, dwgBuffer *dbuf);
+    bool readPlineVertex(DRW_Polyline& pline, const std::unordered_map<duint32, const dwgRawObject*>& rawIndex,
+                         std::vector<duint32>& consumed);
+    bool readRawObject(dwgBuffer *dbuf, const objHandle& obj, dwgRawObject& raw);
+    std::unique_ptr<DRW_Entity> parseDwgEntity(dwgRawObject& raw, bool& ret);
+    void addDwgEntity(DRW_Entity* e, duint32 oType, DRW_Interface& intfa);
 
 public:
     std::unordered_map<duint32, objHandle>ObjectMap;
@@ -190,20 +212,6 @@ protected:
 //    duint32 blockCtrl;
     duint32 nextEntLink{0};
     duint32 prevEntLink{0};
-
-private:
-    template <class T>
-    bool entryParse(T &e, dwgBuffer &buff, duint32 bs, bool &ret) {
-        ret = e.parseDwg( version, &buff, bs);
-        if (ret) {
-            parseAttribs(&e);
-            nextEntLink = e.nextEntLink;
-            prevEntLink = e.prevEntLink;
-        }
-
-        return ret;
-    }
-
 };
 
 
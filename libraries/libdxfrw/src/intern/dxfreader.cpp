@@ -10,8 +10,11 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <charconv>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <locale>
 #include <string>
 #include <sstream>
 #include "dxfreader.h"
@@ -95,19 +98,21 @@ bool dxfReader::readRec(int *codeData) {
         //break in binary files because the conduct is unpredictable
         return false;
 
-    return (filestr->good());
+    return good();
+}
+
+bool dxfReader::good() const {
+    return filestr->good();
 }
+
 int dxfReader::getHandleString(){
-    int res;
-#if defined(__APPLE__)
-    int Succeeded = sscanf ( strData.c_str(), "%x", &res );
-    if ( !Succeeded || Succeeded == EOF )
+    int res {0};
+    std::string_view text {strData};
+    size_t first = text.find_first_not_of(" \t");
+    if (first != std::string_view::npos)
+        text.remove_prefix(first);
+    if (std::from_chars(text.data(), text.data() + text.size(), res, 16).ec != std::errc())
         res = 0;
-#else
-    std::istringstream Convert(strData);
-    if ( !(Convert >> std::hex >>res) )
-        res = 0;
-#endif
     return res;
 }
 
@@ -204,28 +209,116 @@ bool dxfReaderBinary::readBool() {
     return (filestr->good());
 }
 
+namespace {
+//! size of the blocks read from ascii files
+constexpr size_t blockSize {1 << 22};
+
+std::string_view trimmed(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos)
+        return {};
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+//like atoi(), 0 for invalid values
+int toInt(std::string_view text) {
+    text = trimmed(text);
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+    int value {0};
+    if (std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc())
+        value = 0;
+    return value;
+}
+
+bool toDouble(std::string_view text, double *value) {
+    text = trimmed(text);
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+#if defined(__cpp_lib_to_chars)
+    if (std::from_chars(text.data(), text.data() + text.size(), *value).ec == std::errc())
+        return true;
+#endif
+    //no floating point from_chars(), or a value it doesn't accept
+    std::istringstream sd{std::string(text)};
+    sd.imbue(std::locale::classic());
+    return static_cast<bool>(sd >> *value);
+}
+}
+
+/**
+ * Moves the unread rest of the buffer to its begin and appends the next
+ * block of the file.
+ * @return false at the end of the file
+ */
+bool dxfReaderAscii::fillBuffer() {
+    if (!filestr->good())
+        return false;
+    size_t rest = bufferSize - bufferPos;
+    if (rest > 0 && bufferPos > 0)
+        std::memmove(buffer.data(), buffer.data() + bufferPos, rest);
+    bufferPos = 0;
+    bufferSize = rest;
+    if (buffer.size() < bufferSize + blockSize)
+        buffer.resize(bufferSize + blockSize);
+    filestr->read(buffer.data() + bufferSize, blockSize);
+    size_t count = static_cast<size_t>(filestr->gcount());
+    bufferSize += count;
+    return count > 0;
+}
+
+/**
+ * Reads the next line without its line end. The line points into the
+ * buffer and is valid until the next read.
+ * @return false when the line isn't terminated by a line end, like
+ * std::getline() followed by good()
+ */
+bool dxfReaderAscii::readLine(std::string_view *line) {
+    size_t searched = bufferPos;
+    for (;;) {
+        const char *begin = buffer.data() + bufferPos;
+        const char *end = buffer.data() + bufferSize;
+        const char *from = buffer.data() + searched;
+        const char *eol = from < end ? static_cast<const char*>(std::memchr(from, '\n', end - from)) : nullptr;
+        if (eol != nullptr) {
+            *line = std::string_view(begin, eol - begin);
+            bufferPos = eol - buffer.data() + 1;
+            lineGood = true;
+            break;
+        }
+        searched = bufferSize - bufferPos;
+        if (!fillBuffer()) {
+            *line = std::string_view(buffer.data() + bufferPos, bufferSize - bufferPos);
+            bufferPos = bufferSize;
+            lineGood = false;
+            break;
+        }
+    }
+    if (!line->empty() && line->back() == '\r')
+        line->remove_suffix(1);
+    return lineGood;
+}
+
 bool dxfReaderAscii::readCode(int *code) {
-    std::string text;
-    std::getline(*filestr, text);
-    *code = atoi(text.c_str());
+    std::string_view text;
+    readLine(&text);
+    *code = toInt(text);
     DRW_DBG(*code); DRW_DBG("\n");
-    return (filestr->good());
+    return lineGood;
 }
 bool dxfReaderAscii::readString(std::string *text) {
     type = STRING;
-    std::getline(*filestr, *text);
-    if (!text->empty() && text->at(text->size()-1) == '\r')
-        text->erase(text->size()-1);
-    return (filestr->good());
+    std::string_view line;
+    readLine(&line);
+    text->assign(line.data(), line.size());
+    return lineGood;
 }
 
 bool dxfReaderAscii::readString() {
-    type = STRING;
-    std::getline(*filestr, strData);
-    if (!strData.empty() && strData.at(strData.size()-1) == '\r')
-        strData.erase(strData.size()-1);
+    readString(&strData);
     DRW_DBG(strData); DRW_DBG("\n");
-    return (filestr->good());
+    return lineGood;
 }
 
 bool dxfReaderAscii::readBinary() {
@@ -234,9 +327,9 @@ bool dxfReaderAscii::readBinary() {
 
 bool dxfReaderAscii::readInt16() {
     type = INT32;
-    std::string text;
-    if (readString(&text)){
-        intData = atoi(text.c_str());
+    std::string_view text;
+    if (readLine(&text)){
+        intData = toInt(text);
         DRW_DBG(intData); DRW_DBG("\n");
         return true;
     } else
@@ -255,20 +348,15 @@ bool dxfReaderAscii::readInt64() {
 
 bool dxfReaderAscii::readDouble() {
     type = DOUBLE;
-    std::string text;
-    if (readString(&text)){
-#if defined(__APPLE__)
-        int succeeded=sscanf( & (text[0]), "%lg", &doubleData);
-        if(succeeded != 1) {
+    std::string_view text;
+    if (readLine(&text)){
+        if (!toDouble(text, &doubleData)) {
+            doubleData = 0.0;
             DRW_DBG("dxfReaderAscii::readDouble(): reading double error: ");
-            DRW_DBG(text);
+            DRW_DBG(std::string(text));
             DRW_DBG('\n');
         }
-#else
-        std::istringstream sd(text);
-        sd >> doubleData;
         DRW_DBG(doubleData); DRW_DBG('\n');
-#endif
         return true;
     } else
         return false;
@@ -277,12 +365,11 @@ bool dxfReaderAscii::readDouble() {
 //saved as int or add a bool member??
 bool dxfReaderAscii::readBool() {
     type = BOOL;
-    std::string text;
-    if (readString(&text)){
-        intData = atoi(text.c_str());
+    std::string_view text;
+    if (readLine(&text)){
+        intData = toInt(text);
         DRW_DBG(intData); DRW_DBG("\n");
         return true;
     } else
         return false;
 }
-
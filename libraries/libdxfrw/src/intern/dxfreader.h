@@ -13,6 +13,8 @@
 #ifndef DXFREADER_H
 #define DXFREADER_H
 
+#include <string_view>
+#include <vector>
 #include "drw_textcodec.h"
 
 class dxfReader {
@@ -49,6 +51,7 @@ public:
     void setIgnoreComments(const bool bValue) {m_bIgnoreComments = bValue;}
 
 protected:
+    virtual bool good() const; //state of the last read, like std::istream::good()
     virtual bool readCode(int *code) = 0; //return true if successful (not EOF)
     virtual bool readString(std::string *text) = 0;
     virtual bool readString() = 0;
@@ -85,9 +88,14 @@ public:
     bool readBool() override;
 };
 
+/**
+ * Reads ascii dxf files in large blocks and parses the lines in place,
+ * without a string and a stream for each group code and value.
+ */
 class dxfReaderAscii : public dxfReader {
 public:
     dxfReaderAscii(std::ifstream *stream):dxfReader(stream){skip = true; }
+    bool good() const override {return lineGood;}
     bool readCode(int *code) override;
     bool readString(std::string *text) override;
     bool readString() override;
@@ -97,6 +105,14 @@ public:
     bool readInt32() override;
     bool readInt64() override;
     bool readBool() override;
+private:
+    bool readLine(std::string_view *line);
+    bool fillBuffer();
+
+    std::vector<char> buffer;
+    size_t bufferPos {0};
+    size_t bufferSize {0};
+    bool lineGood {true};
 };
 
 #endif // DXFREADER_H
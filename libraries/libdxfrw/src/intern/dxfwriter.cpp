@@ -10,12 +10,20 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
 ******************************************************************************/
 
+#include <charconv>
 #include <cstdlib>
 #include <fstream>
+#include <locale>
+#include <sstream>
 #include <string>
 #include <algorithm>
 #include "dxfwriter.h"
 
+namespace {
+//size of the blocks written to the file by dxfWriterAscii
+constexpr size_t blockSize = 4 * 1024 * 1024;
+}
+
 //RLZ TODO change std::endl to x0D x0A (13 10)
 /*bool dxfWriter::readRec(int *codeData, bool skip) {
 //    std::string text;
@@ -103,6 +111,11 @@ bool dxfWriter::writeUtf8Caps(int code, std::string text) {
     return writeString(code, t);
 }
 
+bool dxfWriter::flush() {
+    filestr->flush();
+    return (filestr->good());
+}
+
 bool dxfWriterBinary::writeString(int code, std::string text) {
     char bufcode[2];
     bufcode[0] =code & 0xFF;
@@ -215,27 +228,75 @@ bool dxfWriterBinary::writeBool(int code, bool data) {
 }
 
 dxfWriterAscii::dxfWriterAscii(std::ofstream *stream):dxfWriter(stream){
-    filestr->precision(16);
+    buffer.reserve(blockSize + 4096);
 }
 
-bool dxfWriterAscii::writeString(int code, std::string text) {
-//    *filestr << code << std::endl << text << std::endl ;
-    filestr->width(3);
-    *filestr << std::right << code << '\n';
-    filestr->width(0);
-    *filestr << std::left << text << '\n';
-    /*    std::getline(*filestr, strData, '\0');
-    DBG(strData); DBG("\n");*/
+dxfWriterAscii::~dxfWriterAscii() {
+    if (!buffer.empty())
+        flush();
+}
+
+/**
+ * Appends an integer right aligned in a field of width characters,
+ * like the stream does with width() and std::right.
+ */
+template <typename T>
+void dxfWriterAscii::appendNumber(T data, int width) {
+    char str[24];
+    std::to_chars_result res = std::to_chars(str, str + sizeof(str), data);
+    int len = static_cast<int>(res.ptr - str);
+    if (len < width)
+        buffer.append(static_cast<size_t>(width - len), ' ');
+    buffer.append(str, res.ptr);
+}
+
+/**
+ * Appends a double formatted like "%.16g", byte for byte the output of the
+ * stream with precision(16) which was used before.
+ */
+void dxfWriterAscii::appendDouble(double data) {
+#if defined(__cpp_lib_to_chars)
+    char str[32];
+    std::to_chars_result res = std::to_chars(str, str + sizeof(str), data, std::chars_format::general, 16);
+    buffer.append(str, res.ptr);
+#else
+    //no floating point to_chars()
+    std::ostringstream sd;
+    sd.imbue(std::locale::classic());
+    sd.precision(16);
+    sd << data;
+    buffer.append(sd.str());
+#endif
+}
+
+/** Ends the current record, the buffer is written when a block is full */
+bool dxfWriterAscii::endRecord() {
+    buffer.push_back('\n');
+    if (buffer.size() >= blockSize)
+        return flush();
     return (filestr->good());
 }
 
+bool dxfWriterAscii::flush() {
+    if (!buffer.empty()) {
+        filestr->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    return dxfWriter::flush();
+}
+
+bool dxfWriterAscii::writeString(int code, std::string text) {
+    appendNumber(code, 3);
+    buffer.push_back('\n');
+    buffer.append(text);
+    return endRecord();
+}
+
 bool dxfWriterAscii::writeInt16(int code, int data) {
-//    *filestr << std::right << code << std::endl << data << std::endl;
-    filestr->width(3);
-    *filestr << std::right << code << '\n';
-    filestr->width(5);
-    *filestr << data << '\n';
-    return (filestr->good());
+    appendNumber(code, 3);
+    buffer.push_back('\n');
+    appendNumber(data, 5);
+    return endRecord();
 }
 
 bool dxfWriterAscii::writeInt32(int code, int data) {
@@ -243,28 +304,23 @@ bool dxfWriterAscii::writeInt32(int code, int data) {
 }
 
 bool dxfWriterAscii::writeInt64(int code, unsigned long long int data) {
-//    *filestr << code << std::endl << data << std::endl;
-    filestr->width(3);
-    *filestr << std::right << code << '\n';
-    filestr->width(5);
-    *filestr << data << '\n';
-    return (filestr->good());
+    appendNumber(code, 3);
+    buffer.push_back('\n');
+    appendNumber(data, 5);
+    return endRecord();
 }
 
 bool dxfWriterAscii::writeDouble(int code, double data) {
-//    std::streamsize prec = filestr->precision();
-//    filestr->precision(12);
-//    *filestr << code << std::endl << data << std::endl;
-    filestr->width(3);
-    *filestr << std::right << code << '\n';
-    *filestr << data << '\n';
-//    filestr->precision(prec);
-    return (filestr->good());
+    appendNumber(code, 3);
+    buffer.push_back('\n');
+    appendDouble(data);
+    return endRecord();
 }
 
 //saved as int or add a bool member??
 bool dxfWriterAscii::writeBool(int code, bool data) {
-    *filestr << code << '\n' << data << '\n';
-    return (filestr->good());
+    appendNumber(code, 0);
+    buffer.push_back('\n');
+    buffer.push_back(data ? '1' : '0');
+    return endRecord();
 }
-
@@ -13,6 +13,7 @@
 #ifndef DXFWRITER_H
 #define DXFWRITER_H
 
+#include <string>
 #include "drw_textcodec.h"
 
 class dxfWriter {
@@ -28,6 +29,7 @@ public:
     virtual bool writeInt64(int code, unsigned long long int data) = 0;
     virtual bool writeDouble(int code, double data) = 0;
     virtual bool writeBool(int code, bool data) = 0;
+    virtual bool flush();
     void setVersion(const std::string &v, bool dxfFormat){encoder.setVersion(v, dxfFormat);}
     void setCodePage(const std::string &c){encoder.setCodePage(c, true);}
     std::string getCodePage(){return encoder.getCodePage();}
@@ -48,15 +50,29 @@ public:
     bool writeBool(int code, bool data) override;
 };
 
+/**
+ * Ascii writer, formats the records into a memory buffer, written to the
+ * stream in large blocks.
+ */
 class dxfWriterAscii : public dxfWriter {
 public:
     dxfWriterAscii(std::ofstream *stream);
+    ~dxfWriterAscii() override;
     bool writeString(int code, std::string text) override;
     bool writeInt16(int code, int data) override;
     bool writeInt32(int code, int data) override;
     bool writeInt64(int code, unsigned long long int data) override;
     bool writeDouble(int code, double data) override;
     bool writeBool(int code, bool data) override;
+    bool flush() override;
+
+private:
+    template <typename T>
+    void appendNumber(T data, int width);
+    void appendDouble(double data);
+    bool endRecord();
+
+    std::string buffer;
 };
 
 #endif // DXFWRITER_H
@@ -156,9 +156,8 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         writer->writeString(0, "ENDSEC");
     }
     writer->writeString(0, "EOF");
-    filestr.flush();
+    isOk = writer->flush();
     filestr.close();
-    isOk = true;
     delete writer;
     writer = NULL;
     return isOk;
@@ -74,8 +74,8 @@ void RS_ActionLayersTogglePrint::deselectEntities(RS_Layer* layer)
 {
     if (!layer) return;
 
-    for(auto e: *container){ // // fixme - sand -  iteration over all entities in container
-        if (e && e->isVisible() && e->getLayer() == layer) {
+    for(auto e: document->getLayerEntities(layer)){
+        if (e->isVisible()) {
             e->setSelected(false);
         }
     }
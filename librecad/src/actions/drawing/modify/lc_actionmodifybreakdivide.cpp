@@ -23,13 +23,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <cfloat>
 
 #include "lc_actionmodifybreakdivide.h"
+#include "lc_intersections.h"
 #include "lc_linemath.h"
 #include "lc_modifybreakdivideoptions.h"
 #include "rs_arc.h"
 #include "rs_circle.h"
 #include "rs_entitycontainer.h"
 #include "rs_graphicview.h"
-#include "rs_information.h"
 #include "rs_math.h"
 #include "rs_pen.h"
 
@@ -579,47 +579,13 @@ LC_ActionModifyBreakDivide::CircleSegmentData *LC_ActionModifyBreakDivide::calcu
  */
 QVector<RS_Vector> LC_ActionModifyBreakDivide::collectAllIntersectionsWithEntity(RS_Entity *entity){
     QVector<RS_Vector> result;
-    RS_VectorSolutions sol;
-    // iterate over all entities
-    for (auto* e: *container) {
-        // consider only visible entities
-        if (e && e->isVisible()){
-            // select containers / groups:
-            if (e->isContainer()){
-                // additional handling for containers
-                auto *ec = (RS_EntityContainer *) e;
-
-                for (RS_Entity *e2 = ec->firstEntity(RS2::ResolveAll); e2;
-                     e2 = ec->nextEntity(RS2::ResolveAll)) {
-                    sol = RS_Information::getIntersection(entity, e2, true);
-                    addPointsFromSolutionToList(sol, result);
-                }
-            } else {
-                // just find intersections between entities
-                sol = RS_Information::getIntersection(entity, e, true);
-                // and collect them
-                addPointsFromSolutionToList(sol, result);
-            }
-        }
+    // only visible entities with borders overlapping the entity are intersected,
+    // containers are resolved into their sub-entities
+    for (const LC_Intersections::Intersection &info: LC_Intersections::findWith(entity, *container)) {
+        result.append(info.point);
     }
     return result;
 }
-/**
- * Utility method that collects all valid intersection points for vector solutions to vector
- * @param sol vector solutions with intersections
- * @param result resulting vector
- */
-void LC_ActionModifyBreakDivide::addPointsFromSolutionToList(RS_VectorSolutions &sol, QVector<RS_Vector> &result) const{
-    if (sol.hasValid()){
-        size_t size = sol.size();
-        for (size_t i = 0; i < size; i++) {
-            const RS_Vector point = sol.at(i);
-            if (point.valid){
-                result.append(point);
-            }
-        }
-    }
-}
 
 /**
  * Method finds edges (start and end point) for the segment of line, selected by the user.
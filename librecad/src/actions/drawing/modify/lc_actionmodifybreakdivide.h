@@ -107,7 +107,6 @@ protected:
     void doPreparePreviewEntities(LC_MouseEvent *e, RS_Vector &snap, QList<RS_Entity *> &list, int status) override;
     LineSegmentData *calculateLineSegment(RS_Line *line, RS_Vector &snap);
     QVector<RS_Vector>  collectAllIntersectionsWithEntity(RS_Entity *entity);
-    void addPointsFromSolutionToList(RS_VectorSolutions &sol, QVector<RS_Vector> &result) const;
     LineSegmentData *findLineSegmentEdges(RS_Line *line, RS_Vector &snap, QVector<RS_Vector> intersections);
     LC_ActionOptionsWidget* createOptionsWidget() override;
     void createEntitiesForLine(RS_Line *line, RS_Vector &snap, QList<RS_Entity *> &list, bool preview);
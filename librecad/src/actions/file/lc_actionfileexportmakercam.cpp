@@ -24,8 +24,7 @@
 
 #include "lc_actionfileexportmakercam.h"
 
-#include <QFile>
-#include <QTextStream>
+#include <QSaveFile>
 
 #include "lc_makercamsvg.h"
 #include "lc_xmlwriterqxmlstreamwriter.h"
@@ -42,11 +41,11 @@ namespace {
     }
 
 // create an SVG generator
-    std::unique_ptr<LC_MakerCamSVG> getGenerator()
+    std::unique_ptr<LC_MakerCamSVG> getGenerator(std::unique_ptr<LC_XMLWriterQXmlStreamWriter> xmlWriter)
     {
         LC_GROUP_GUARD("ExportMakerCam");
         {
-            auto generator = std::make_unique<LC_MakerCamSVG>(std::make_unique<LC_XMLWriterQXmlStreamWriter>(),
+            auto generator = std::make_unique<LC_MakerCamSVG>(std::move(xmlWriter),
                                                               LC_GET_BOOL("ExportInvisibleLayers"),
                                                               LC_GET_BOOL("ExportConstructionLayers"),
                                                               LC_GET_BOOL("WriteBlocksInline"),
@@ -80,21 +79,23 @@ bool LC_ActionFileExportMakerCam::writeSvg(const QString& fileName, RS_Graphic&
         return false;
     }
 
-    auto generator = getGenerator();
-    if (generator->generate(&graphic)) {
-        QFile file{fileName};
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            LC_ERR<<__func__<<"(): failed in creating file "<<fileName<<", no SVG is generated";
-            return false;
-        }
+    // the document is streamed to a temporary file, which replaces the file only when complete,
+    // like RS_FileIO::fileExportAtomic()
+    QSaveFile file{fileName};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        LC_ERR<<__func__<<"(): failed in creating file "<<fileName<<", no SVG is generated";
+        return false;
+    }
 
-        QTextStream out(&file);
-        out << QString::fromStdString(generator->resultAsString());
+    auto generator = getGenerator(std::make_unique<LC_XMLWriterQXmlStreamWriter>(&file));
+    if (!generator->generate(&graphic) || !generator->finish() || !file.commit()) {
+        // an uncommitted QSaveFile is discarded, keeping any previous file
+        LC_ERR<<__func__<<"(): failed in writing file "<<fileName;
+        return false;
     }
     return true;
 }
 
-
 void LC_ActionFileExportMakerCam::trigger() {
 
 	RS_DEBUG->print("LC_ActionFileExportMakerCam::trigger()");
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include<cmath>
+#include <QElapsedTimer>
 #include <QMouseEvent>
 
 #include "lc_linemath.h"
@@ -48,6 +49,7 @@
 #include "rs_units.h"
 #include "lc_cursoroverlayinfo.h"
 #include "lc_overlayentitiescontainer.h"
+#include "lc_snapworker.h"
 #include "rs_math.h"
 
 namespace {
@@ -359,11 +361,46 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         return pImpData->snapSpot;
     }
 
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
     RS_Vector mouseCoord = toGraph(e);
     double ds2Min=RS_MAXDOUBLE*RS_MAXDOUBLE;
 
+    if (snapMode.snapMiddle) {
+        //todo: accept value from widget QG_SnapMiddleOptions
+        RS_DIALOGFACTORY->requestSnapMiddleOptions(&middlePoints, snapMode.snapMiddle);
+    }
+    if (snapMode.snapDistance) {
+        //todo: accept value from widget QG_SnapDistOptions
+        RS_DIALOGFACTORY->requestSnapDistOptions(&m_SnapDistance, snapMode.snapDistance);
+    }
+
+    // snap points of all enabled kinds are found by one pass over the entities near the mouse
+    QElapsedTimer timer;
+    timer.start();
+    RS_EntityContainer::LC_SnapQuery query;
+    query.endpoint = snapMode.snapEndpoint;
+    query.center = snapMode.snapCenter;
+    query.middle = snapMode.snapMiddle;
+    query.middlePoints = middlePoints;
+    query.distance = snapMode.snapDistance;
+    query.distanceToEndpoint = m_SnapDistance;
+    query.intersection = snapMode.snapIntersection;
+    query.onEntity = snapMode.snapOnEntity;
+    // while the mouse moves, intersections are solved by the worker, and the view moves the mouse
+    // again when they are done. A click needs the intersection at once
+    LC_SnapWorker *snapWorker = graphicView->getSnapWorker();
+    query.deferIntersections = snapWorker != nullptr && graphicView->getContainer() == container
+                               && e->type() == QEvent::MouseMove;
+    const RS_EntityContainer::LC_SnapPoints points = container->getNearestSnapPoints(mouseCoord, query);
+    if (points.unsolvedIntersections != nullptr) {
+        snapWorker->solveIntersections(points.unsolvedIntersections);
+    }
+    m_snapTimings.entities = timer.nsecsElapsed();
+
     if (snapMode.snapEndpoint) {
-        t = snapEndpoint(mouseCoord);
+        t = points.endpoint;
         double ds2=mouseCoord.squaredTo(t);
 
         if (t.valid && ds2 < ds2Min){
@@ -373,7 +410,7 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         }
     }
     if (snapMode.snapCenter) {
-        t = snapCenter(mouseCoord);
+        t = points.center;
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
             ds2Min=ds2;
@@ -382,10 +419,7 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         }
     }
     if (snapMode.snapMiddle) {
-        //this is still brutal force
-        //todo: accept value from widget QG_SnapMiddleOptions
-        RS_DIALOGFACTORY->requestSnapMiddleOptions(&middlePoints, snapMode.snapMiddle);
-        t = snapMiddle(mouseCoord);
+        t = points.middle;
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
             ds2Min=ds2;
@@ -394,10 +428,7 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         }
     }
     if (snapMode.snapDistance) {
-        //this is still brutal force
-        //todo: accept value from widget QG_SnapDistOptions
-        RS_DIALOGFACTORY->requestSnapDistOptions(&m_SnapDistance, snapMode.snapDistance);
-        t = snapDist(mouseCoord);
+        t = points.distance;
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
             ds2Min=ds2;
@@ -406,7 +437,7 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         }
     }
     if (snapMode.snapIntersection) {
-        t = snapIntersection(mouseCoord);
+        t = points.intersection;
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
             ds2Min=ds2;
@@ -416,7 +447,10 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
     }
 
     if (snapMode.snapOnEntity && pImpData->snapSpot.distanceTo(mouseCoord) > m_distanceBeforeSwitchToFreeSnap) {
-        t = snapOnEntity(mouseCoord);
+        t = points.onEntity;
+        if (points.onEntityKey != nullptr) {
+            keyEntity = points.onEntityKey;
+        }
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
             ds2Min=ds2;
@@ -425,8 +459,11 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
         }
     }
 
+    m_snapTimings.grid = 0;
     if (isSnapToGrid()) {
+        timer.restart();
         t = snapGrid(mouseCoord);
+        m_snapTimings.grid = timer.nsecsElapsed();
         double ds2=mouseCoord.squaredTo(t);
         if (ds2 < ds2Min){
 //            ds2Min=ds2;
@@ -496,6 +533,13 @@ RS_Vector RS_Snapper::snapPoint(QMouseEvent* e){
     //}
     //else snapCoord = snapSpot;
 
+    m_snapTimings.total = totalTimer.nsecsElapsed();
+    RS_DEBUG->print(RS_Debug::D_DEBUGGING,
+                    "RS_Snapper::snapPoint: entities %lld ns, grid %lld ns, total %lld ns",
+                    static_cast<long long>(m_snapTimings.entities),
+                    static_cast<long long>(m_snapTimings.grid),
+                    static_cast<long long>(m_snapTimings.total));
+
     snapPoint(pImpData->snapSpot, false);
 
     return pImpData->snapCoord;
@@ -782,27 +826,37 @@ RS_Entity* RS_Snapper::catchEntity(const RS_Vector& pos, RS2::EntityType enType,
             break;
     }
 
-    // fixme - iteration over all elements of drawing
-    for(RS_Entity* en= container->firstEntity(level);en;en=container->nextEntity(level)){
-        if(en->isVisible()==false) continue;
+    const double catchDistance = getCatchDistance(getSnapRange(), m_catchEntityGuiRange);
+    auto addCandidate = [&ec, enType, isContainer](RS_Entity* en) {
+        if(en->isVisible()==false) return;
         if(en->rtti() != enType && isContainer){
             //whether this entity is a member of member of the type enType
             RS_Entity* parent(en->getParent());
-            bool matchFound{false};
             while(parent ) {
 //                    std::cout<<"RS_Snapper::catchEntity(): parent->rtti()="<<parent->rtti()<<" enType= "<<enType<<std::endl;
                 if(parent->rtti() == enType) {
-                    matchFound=true;
                     ec.addEntity(en);
-                    break;
+                    return;
                 }
                 parent=parent->getParent();
             }
-            if(!matchFound) continue;
+            return;
         }
         if (en->rtti() == enType){
             ec.addEntity(en);
         }
+    };
+
+    // only entities close to the cursor are candidates, resolved by level
+    for(RS_Entity* candidate: container->getEntitiesNear(pos, catchDistance)){
+        if (RS_EntityContainer::resolvesInto(candidate, level)) {
+            auto* sub = static_cast<RS_EntityContainer*>(candidate);
+            for(RS_Entity* en= sub->firstEntity(level);en;en=sub->nextEntity(level)){
+                addCandidate(en);
+            }
+        } else {
+            addCandidate(candidate);
+        }
     }
     if (ec.count() == 0 ) return nullptr;
     double dist(0.);
@@ -814,7 +868,7 @@ RS_Entity* RS_Snapper::catchEntity(const RS_Vector& pos, RS2::EntityType enType,
         idx = entity->getParent()->findEntity(entity);
     }
 
-    if (entity != nullptr && dist <= getCatchDistance(getSnapRange(), m_catchEntityGuiRange)) {
+    if (entity != nullptr && dist <= catchDistance) {
         // highlight:
         RS_DEBUG->print("RS_Snapper::catchEntity: found: %d", idx);
         return entity;
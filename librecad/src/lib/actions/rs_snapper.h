@@ -116,6 +116,16 @@ using EntityTypeList = QList<RS2::EntityType>;
 class RS_Snapper: public QObject{
     Q_OBJECT
 public:
+    /**
+     * Durations of the last snapPoint() call in nanoseconds, for diagnostics
+     */
+    struct LC_SnapTimings{
+        /** query of the entity snap points, all snap kinds in one pass */
+        qint64 entities = 0;
+        qint64 grid = 0;
+        qint64 total = 0;
+    };
+
     RS_Snapper(RS_EntityContainer &container, RS_GraphicView &graphicView);
     virtual ~RS_Snapper();
     void init();
@@ -135,6 +145,10 @@ public:
         return keyEntity;
     }
 
+    const LC_SnapTimings& getSnapTimings() const{
+        return m_snapTimings;
+    }
+
     /** Sets a new snap mode. */
     void setSnapMode(const RS_SnapMode &snapMode);
     RS_SnapMode const *getSnapMode() const;
@@ -310,6 +324,7 @@ private:
 
     struct ImpData;
     std::unique_ptr<ImpData> pImpData;
+    LC_SnapTimings m_snapTimings;
     struct Indicator;
     std::unique_ptr<Indicator> snap_indicator;
 };
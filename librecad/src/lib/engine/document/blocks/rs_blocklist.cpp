@@ -53,6 +53,7 @@ RS_BlockList::RS_BlockList(bool owner) {
  */
 void RS_BlockList::clear() {
     blocks.clear();
+    blockIndex.clear();
 	activeBlock = nullptr;
 	setModified(true);
 }
@@ -98,6 +99,7 @@ bool RS_BlockList::add(RS_Block* block, bool notify) {
     RS_Block* b = find(block->getName());
 	if (!b) {
         blocks.append(block);
+        blockIndex.insert(block->getName(), block);
 
         if (notify) {
             addNotification();
@@ -139,7 +141,9 @@ void RS_BlockList::remove(RS_Block* block) {
     RS_DEBUG->print("RS_BlockList::removeBlock()");
 
     // here the block is removed from the list but not deleted
-    blocks.removeOne(block);
+    if (blocks.removeOne(block) && blockIndex.value(block->getName()) == block) {
+        blockIndex.remove(block->getName());
+    }
 
 	for(auto l: blockListListeners){
 		l->blockRemoved(block);
@@ -175,6 +179,10 @@ bool RS_BlockList::rename(RS_Block* block, const QString& name) {
 		if (!find(name)) {
 			QString oldName = block->getName();
 			block->setName(name);
+			if (blockIndex.value(oldName) == block) {
+				blockIndex.remove(oldName);
+			}
+			blockIndex.insert(name, block);
 			setModified(true);
 
 			// when the renamed block is nested within other block, we need to rename its inserts as well
@@ -212,22 +220,12 @@ void RS_BlockList::editBlock(RS_Block* block, const RS_Block& source) {
  * \p nullptr if no such block was found.
  */
 RS_Block* RS_BlockList::find(const QString& name) {
-    try {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): %s", name.toLatin1().constData());
-    }
-    catch(...) {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): wrong name to find");
-        return nullptr;
+    RS_Block* b = blockIndex.value(name, nullptr);
+    if (b != nullptr && b->getName() == name) {
+        return b;
     }
-	// Todo : reduce this from O(N) to O(log(N)) complexity based on sorted list or hash
-	//DFS
-	for(RS_Block* b: blocks) {
-		if (b->getName()==name) {
-			return b;
-		}
-	}
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): bad");
-	return nullptr;
+    // blocks are only renamed by rename(), so a miss is a miss
+    return nullptr;
 }
 
 /**
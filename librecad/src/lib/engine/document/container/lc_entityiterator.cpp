@@ -0,0 +1,84 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+#include "lc_entityiterator.h"
+#include "rs_entitycontainer.h"
+
+LC_EntityIterator::LC_EntityIterator(const RS_EntityContainer& container, RS2::ResolveLevel level):
+    m_level{level}
+{
+    m_positions.emplace_back(container.begin(), container.end());
+    findEntity();
+}
+
+LC_EntityIterator& LC_EntityIterator::operator++() {
+    if (!m_positions.empty()) {
+        ++m_positions.back().first;
+        findEntity();
+    }
+    return *this;
+}
+
+LC_EntityIterator LC_EntityIterator::operator++(int) {
+    LC_EntityIterator ret = *this;
+    ++*this;
+    return ret;
+}
+
+void LC_EntityIterator::findEntity() {
+    while (!m_positions.empty()) {
+        auto& [position, end] = m_positions.back();
+        if (position == end) {
+            // continue after the finished container
+            m_positions.pop_back();
+            if (!m_positions.empty()) {
+                ++m_positions.back().first;
+            }
+            continue;
+        }
+        RS_Entity* e = *position;
+        if (RS_EntityContainer::resolvesInto(e, m_level)) {
+            // empty containers are skipped, as by nextEntity()
+            auto* container = static_cast<const RS_EntityContainer*>(e);
+            m_positions.emplace_back(container->begin(), container->end());
+            continue;
+        }
+        m_current = e;
+        return;
+    }
+    m_current = nullptr;
+}
+
+LC_EntityRange::LC_EntityRange(const RS_EntityContainer& container, RS2::ResolveLevel level):
+    m_container{container}
+    , m_level{level}
+{
+}
+
+LC_EntityIterator LC_EntityRange::begin() const {
+    return {m_container, m_level};
+}
+
+LC_EntityIterator LC_EntityRange::end() const {
+    return {};
+}
@@ -0,0 +1,104 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+#ifndef LC_ENTITYITERATOR_H
+#define LC_ENTITYITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <QList>
+
+#include "rs.h"
+
+class RS_Entity;
+class RS_EntityContainer;
+
+/**
+ * Iterator over the entities of a container, resolving sub-containers by
+ * the same rules as RS_EntityContainer::firstEntity()/nextEntity().
+ *
+ * Unlike firstEntity()/nextEntity(), the position is kept by the iterator,
+ * not by the containers. Iterations may be nested, and any number of
+ * readers may traverse the same container at the same time, as long as
+ * the container is not modified. Containers with deferred entities, like
+ * inserts, create those on their first traversal, which must be done by
+ * one thread only.
+ */
+class LC_EntityIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = RS_Entity*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = RS_Entity* const*;
+    using reference = RS_Entity* const&;
+
+    /** the end iterator */
+    LC_EntityIterator() = default;
+    LC_EntityIterator(const RS_EntityContainer& container, RS2::ResolveLevel level);
+
+    reference operator*() const {
+        return m_current;
+    }
+    LC_EntityIterator& operator++();
+    LC_EntityIterator operator++(int);
+
+    // an entity is only found once in the tree of a container
+    bool operator==(const LC_EntityIterator& other) const {
+        return m_current == other.m_current;
+    }
+    bool operator!=(const LC_EntityIterator& other) const {
+        return m_current != other.m_current;
+    }
+
+private:
+    /** moves to the next entity, which isn't resolved, from the current position */
+    void findEntity();
+
+    using Position = QList<RS_Entity*>::const_iterator;
+    /** the position in each container from the top container down */
+    std::vector<std::pair<Position, Position>> m_positions;
+    RS_Entity* m_current = nullptr;
+    RS2::ResolveLevel m_level = RS2::ResolveNone;
+};
+
+/**
+ * Range of the entities in a container for range based loops:
+ *
+ *     for (RS_Entity* e: LC_EntityRange{*container, RS2::ResolveAll}) {...}
+ */
+class LC_EntityRange {
+public:
+    explicit LC_EntityRange(const RS_EntityContainer& container, RS2::ResolveLevel level = RS2::ResolveNone);
+
+    LC_EntityIterator begin() const;
+    LC_EntityIterator end() const;
+
+private:
+    const RS_EntityContainer& m_container;
+    RS2::ResolveLevel m_level;
+};
+
+#endif
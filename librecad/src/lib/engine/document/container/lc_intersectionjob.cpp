@@ -0,0 +1,89 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+
+#include <cstdlib>
+
+#include "lc_intersectionjob.h"
+#include "rs_information.h"
+#include "rs_layer.h"
+
+LC_IntersectionJob::LC_IntersectionJob(const RS_EntityContainer* container, RS_Entity* entity,
+                                       unsigned long generation)
+    : m_container{container}
+    , m_entity{entity}
+    , m_generation{generation}
+    , m_copies{nullptr, true} {
+    m_entityCopy = addCopy(entity);
+}
+
+LC_IntersectionJob::~LC_IntersectionJob() = default;
+
+RS_Entity* LC_IntersectionJob::addCopy(const RS_Entity* entity) {
+    RS_Entity* copy = entity->clone();
+    // the copies are solved without their parents, which may be changed meanwhile.
+    // The layer of a sub-entity is the one of its parent: a construction layer makes it infinite
+    copy->setParent(&m_copies);
+    RS_Layer* layer = entity->getLayer(true);
+    if (layer != nullptr) {
+        std::unique_ptr<RS_Layer>& layerCopy = m_layers[layer];
+        if (layerCopy == nullptr) {
+            layerCopy.reset(layer->clone());
+        }
+        copy->setLayer(layerCopy.get());
+    }
+    m_copies.addEntity(copy);
+    return copy;
+}
+
+void LC_IntersectionJob::addPartner(RS_Entity* partner) {
+    if (partner == m_entity) {
+        return;
+    }
+    // the neighbouring segments of a spline meet at their end points, which are no intersections.
+    // RS_Information::getIntersection() finds neighbours by the parent, which the copies don't share
+    RS_EntityContainer* parent = m_entity->getParent();
+    if (parent != nullptr && parent == partner->getParent() && parent->rtti() == RS2::EntitySpline
+        && std::abs(parent->findEntity(m_entity) - parent->findEntity(partner)) <= 1) {
+        return;
+    }
+    m_partners.emplace_back(partner, addCopy(partner));
+}
+
+void LC_IntersectionJob::solve() {
+    m_solutions.clear();
+    m_solutions.reserve(m_partners.size());
+    for (const auto& [partner, copy]: m_partners) {
+        m_solutions.push_back(RS_Information::getIntersection(m_entityCopy, copy, true));
+    }
+}
+
+std::vector<std::pair<RS_Entity*, RS_VectorSolutions>> LC_IntersectionJob::takeResult() {
+    std::vector<std::pair<RS_Entity*, RS_VectorSolutions>> result;
+    result.reserve(m_solutions.size());
+    for (size_t i = 0; i < m_solutions.size(); ++i) {
+        result.emplace_back(m_partners[i].first, std::move(m_solutions[i]));
+    }
+    m_solutions.clear();
+    return result;
+}
@@ -0,0 +1,83 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+#ifndef LC_INTERSECTIONJOB_H
+#define LC_INTERSECTIONJOB_H
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rs_entitycontainer.h"
+#include "rs_vector.h"
+
+class RS_Layer;
+
+/**
+ * Intersections of an entity with the entities around it, solved apart from the
+ * document, e.g. by a worker thread while the GUI thread keeps handling events.
+ *
+ * The job is prepared by RS_EntityContainer::prepareIntersectionJob() in the thread
+ * of the document. It keeps copies of the entities and of their layers, so solve()
+ * reads nothing of the document and may run in any thread. The result is stored in
+ * the container by RS_EntityContainer::takeIntersectionJob(), which drops it if the
+ * container was changed since the job was prepared.
+ */
+class LC_IntersectionJob {
+public:
+    LC_IntersectionJob(const RS_EntityContainer* container, RS_Entity* entity, unsigned long generation);
+    ~LC_IntersectionJob();
+
+    const RS_EntityContainer* getContainer() const {
+        return m_container;
+    }
+    RS_Entity* getEntity() const {
+        return m_entity;
+    }
+    /** the generation of the container when the job was prepared */
+    unsigned long getGeneration() const {
+        return m_generation;
+    }
+
+    /** Adds an entity to intersect with the entity of the job, called before solve() */
+    void addPartner(RS_Entity* partner);
+    void solve();
+    /** @return the entities added by addPartner() with their intersections, after solve() */
+    std::vector<std::pair<RS_Entity*, RS_VectorSolutions>> takeResult();
+
+private:
+    RS_Entity* addCopy(const RS_Entity* entity);
+
+    const RS_EntityContainer* m_container = nullptr;
+    RS_Entity* m_entity = nullptr;
+    unsigned long m_generation = 0;
+    /** owner and parent of the copies */
+    RS_EntityContainer m_copies;
+    std::map<const RS_Layer*, std::unique_ptr<RS_Layer>> m_layers;
+    RS_Entity* m_entityCopy = nullptr;
+    std::vector<std::pair<RS_Entity*, RS_Entity*>> m_partners;
+    std::vector<RS_VectorSolutions> m_solutions;
+};
+
+#endif // LC_INTERSECTIONJOB_H
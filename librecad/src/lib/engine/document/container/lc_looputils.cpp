@@ -29,6 +29,7 @@
 #include <random>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/numeric/ublas/matrix.hpp>
@@ -37,6 +38,7 @@
 #include <boost/geometry/geometries/register/point.hpp>
 #include <boost/geometry/index/rtree.hpp>
 
+#include "lc_endpointgraph.h"
 #include "lc_looputils.h"
 #include "rs_circle.h"
 #include "rs_debug.h"
@@ -200,12 +202,32 @@ struct LoopExtractor::LoopData {
     {
         edges.forcedCalculateBorders();
         size = edges.getSize().magnitude();
+        graph.reset(g_contourGapTolerance);
+        for (RS_Entity* edge: edges)
+            graph.insert(edge);
     }
+
+    bool isProcessed(RS_Entity* edge) const
+    {
+        return processed.count(edge) != 0;
+    }
+
+    // add an edge to the current loop: it's no longer connected to unprocessed edges
+    void process(RS_Entity* edge)
+    {
+        processed.insert(edge);
+        graph.remove(edge);
+    }
+
     double size = 0.;
     RS_Vector vertex;
     RS_Vector vertexTarget;
     RS_Entity* current = nullptr;
     RS_EntityContainer& edges;
+    // unprocessed edges by end points
+    LC_EndpointGraph graph;
+    // edges added to loops, removed from edges at once when the extraction is done
+    std::unordered_set<RS_Entity*> processed;
 };
 
 LoopExtractor::LoopExtractor(RS_EntityContainer &edges) :
@@ -219,15 +241,15 @@ LoopExtractor::LoopExtractor(RS_EntityContainer &edges) :
 //------------------------------------------------------------------------------------//
 std::vector<RS_Entity*> LoopExtractor::getConnected() const
 {
-    std::vector<RS_Entity *> connected;
-    std::copy_if(m_data->edges.begin(), m_data->edges.end(), std::back_inserter(connected),
-                 [vertex = m_data->vertex, current = m_data->current](const RS_Entity *e) {
+    std::vector<RS_Entity *> connected = m_data->graph.getConnected(m_data->vertex);
+    connected.erase(std::remove_if(connected.begin(), connected.end(),
+                                   [vertex = m_data->vertex, current = m_data->current](const RS_Entity *e) {
         if (e == current)
-            return false;
+            return true;
         double dist = RS_MAXDOUBLE;
         e->getNearestEndpoint(vertex, &dist);
-        return dist < g_contourGapTolerance;
-    });
+        return dist >= g_contourGapTolerance;
+    }), connected.end());
     return connected;
 }
 
@@ -245,8 +267,10 @@ LoopExtractor::~LoopExtractor() = default;
 RS_Entity* LoopExtractor::findFirst() const
 {
 
-    // draw a line crossing the first edge
-    RS_Entity* first = m_data->edges.firstEntity();
+    // draw a line crossing the first unprocessed edge
+    RS_Entity* first = *std::find_if(m_data->edges.begin(), m_data->edges.end(), [this](RS_Entity* edge) {
+        return !m_data->isProcessed(edge);
+    });
     RS_Vector p0 = first->getMiddlePoint();
     RS_Vector t0 = first->getTangentDirection(p0).normalize();
     // The dP0 direction is off the normal direction by a random angle smaller than 0.06*Pi
@@ -261,6 +285,8 @@ RS_Entity* LoopExtractor::findFirst() const
     double dist=RS_MAXDOUBLE * RS_MAXDOUBLE;
     for(RS_Entity* edge: m_data->edges)
     {
+        if (m_data->isProcessed(edge))
+            continue;
         RS_VectorSolutions sol0 = RS_Information::getIntersection(&line0, edge, true);
         if (!sol0.empty()) {
             for (const RS_Vector& p00: sol0) {
@@ -287,7 +313,7 @@ RS_Entity* LoopExtractor::findFirst() const
     m_data->current = first;
     m_loop = std::make_unique<RS_EntityContainer>(nullptr, false);
     m_loop->addEntity(m_data->current);
-    m_data->edges.removeEntity(first);
+    m_data->process(first);
     return first;
 }
 
@@ -352,7 +378,7 @@ bool LoopExtractor::findNext() const
     }
     m_data->vertex = (m_data->vertex.squaredTo(m_data->current->getStartpoint()) > RS_TOLERANCE) ? m_data->current->getStartpoint() : m_data->current->getEndpoint();
     m_loop->addEntity(m_data->current);
-    m_data->edges.removeEntity(m_data->current);
+    m_data->process(m_data->current);
     return true;
 }
 
@@ -365,7 +391,7 @@ std::vector<std::unique_ptr<RS_EntityContainer>> LoopExtractor::extract() {
         return loops;
 
     bool success = true;
-    while(success && !m_data->edges.isEmpty()) {
+    while(success && m_data->processed.size() < m_data->edges.count()) {
         findFirst();
         while(success && m_data->vertex.squaredTo(m_data->vertexTarget) > RS_TOLERANCE) {
             LC_LOG<<m_data->vertex.x<<", "<< m_data->vertex.y<<" : "<<" : ds2 = "
@@ -377,6 +403,7 @@ std::vector<std::unique_ptr<RS_EntityContainer>> LoopExtractor::extract() {
             LC_ERR << __func__<<"(): invalid loop of size = "<<m_loop->count();
         loops.push_back(std::move(m_loop));
     }
+    m_data->edges.removeEntities(std::set<RS_Entity*>{m_data->processed.cbegin(), m_data->processed.cend()});
     LC_LOG<<__func__<<"(): loops.size() = "<<loops.size();
     return loops;
 }
@@ -24,17 +24,23 @@
 **
 **********************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <set>
+#include <unordered_set>
 
 #include <QtGlobal>
+#include "lc_entityiterator.h"
+#include "lc_intersectionjob.h"
 #include "lc_looputils.h"
+#include "lc_rect.h"
 
 #include "qg_dialogfactory.h"
 
 #include "rs_constructionline.h"
 #include "rs_debug.h"
+#include "rs_document.h"
 #include "rs_dimension.h"
 #include "rs_dialogfactory.h"
 #include "rs_ellipse.h"
@@ -43,6 +49,7 @@
 #include "rs_information.h"
 #include "rs_insert.h"
 #include "rs_layer.h"
+#include "rs_layerlist.h"
 #include "rs_line.h"
 #include "rs_solid.h"
 #include "rs_painter.h"
@@ -73,6 +80,86 @@ namespace {
         entity.getNearestEndpoint(point, &distance);
         return distance;
     }
+
+// the minimum number of entities to build a spatial index
+    constexpr unsigned spatialIndexMinSize = 64;
+
+// The closest candidate found by a nearest query. With equal distances, the
+// candidate kept is the same as a linear scan in the container order would keep:
+// the first one, or the last one, if preferLast is true
+    struct NearestCandidate {
+        explicit NearestCandidate(bool preferLast = false):
+            preferLast{preferLast}
+        {}
+
+        bool accept(double dist, long order) {
+            bool closer = found ? dist < distance : (preferLast ? dist <= distance : dist < distance);
+            if (found && dist == distance) {
+                closer = preferLast ? order > this->order : order < this->order;
+            }
+            if (closer) {
+                distance = dist;
+                this->order = order;
+                found = true;
+            }
+            return closer;
+        }
+
+        // whether an entity at the given lower bound distance may still be accepted
+        bool reachable(double lowerBound) const {
+            return distance < 0. || lowerBound <= distance;
+        }
+
+        bool preferLast = false;
+        bool found = false;
+        double distance = RS_MAXDOUBLE;
+        long order = 0;
+    };
+
+// Merge the extent of all snap points of an entity: the entity borders, and
+// reference points which may be off the entity, like centers of arcs
+    void mergeSnapExtent(const RS_Entity &entity, RS_Vector &vMin, RS_Vector &vMax) {
+        // deferred sub-entities are within the borders, don't create them for the index
+        bool deferred = entity.isContainer()
+                        && static_cast<const RS_EntityContainer *>(&entity)->hasDeferredEntities();
+        if (!entity.isContainer() || deferred || entity.count() > 0) {
+            vMin = RS_Vector::minimum(entity.getMin(), vMin);
+            vMax = RS_Vector::maximum(entity.getMax(), vMax);
+        }
+        for (const RS_Vector &ref: entity.getRefPoints()) {
+            if (ref.valid) {
+                vMin = RS_Vector::minimum(ref, vMin);
+                vMax = RS_Vector::maximum(ref, vMax);
+            }
+        }
+        // hatch patterns are always within the hatch borders
+        if (entity.isContainer() && !deferred && entity.rtti() != RS2::EntityHatch) {
+            for (const RS_Entity *child: *static_cast<const RS_EntityContainer *>(&entity)) {
+                mergeSnapExtent(*child, vMin, vMax);
+            }
+        }
+    }
+
+// Find the extent for the spatial index, returns false for entities without
+// a finite extent
+    bool getSnapExtent(const RS_Entity &entity, LC_Rect &extent) {
+        if (entity.rtti() == RS2::EntityConstructionLine) {
+            return false;
+        }
+        RS_Vector vMin{RS_MAXDOUBLE, RS_MAXDOUBLE};
+        RS_Vector vMax{RS_MINDOUBLE, RS_MINDOUBLE};
+        mergeSnapExtent(entity, vMin, vMax);
+        if (!(vMin.x <= vMax.x && vMin.y <= vMax.y)
+            || vMin.x <= RS_MINDOUBLE || vMin.y <= RS_MINDOUBLE
+            || vMax.x >= RS_MAXDOUBLE || vMax.y >= RS_MAXDOUBLE) {
+            return false;
+        }
+        // allow rounding errors in borders
+        double tolerance = RS_TOLERANCE * (1. + std::max({std::abs(vMin.x), std::abs(vMin.y),
+                                                          std::abs(vMax.x), std::abs(vMax.y)}));
+        extent = LC_Rect{vMin, vMax}.increaseBy(tolerance);
+        return true;
+    }
 }
 
 /**
@@ -181,6 +268,8 @@ void RS_EntityContainer::detach() {
 
     // clear shared pointers:
     entities.clear();
+    invalidateSpatialIndex();
+    entityListChanged();
     setOwner(autoDel);
 
     // point to new deep copies:
@@ -216,6 +305,7 @@ void RS_EntityContainer::setVisible(bool v) {
  * @return Total length of all entities in this container.
  */
 double RS_EntityContainer::getLength() const {
+    ensureEntities();
     double ret = 0.0;
 
     for (auto e: std::as_const(entities)) {
@@ -240,7 +330,8 @@ bool RS_EntityContainer::setSelected(bool select) {
     // This entity's select:
     if (RS_Entity::setSelected(select)) {
 
-        // All sub-entity's select:
+        // All sub-entity's select. Deferred sub-entities take the selection
+        // of this container when they are created.
         for (auto e: entities) {
             if (e->isVisible()) {
                 e->setSelected(select);
@@ -272,6 +363,7 @@ bool RS_EntityContainer::toggleSelected() {
 }
 
 void RS_EntityContainer::setHighlighted(bool on) {
+    // deferred sub-entities take the highlighting of this container when they are created
     for (auto e: entities) {
         e->setHighlighted(on);
     }
@@ -444,12 +536,17 @@ void RS_EntityContainer::addEntity(RS_Entity *entity) {
     if (entity->rtti() == RS2::EntityImage ||
         entity->rtti() == RS2::EntityHatch) {
         entities.prepend(entity);
+        addToSpatialIndex(entity, true);
+        entityAdded(entity, true);
     } else {
         entities.append(entity);
+        addToSpatialIndex(entity, false);
+        entityAdded(entity, false);
     }
     if (autoUpdateBorders) {
         adjustBorders(entity);
     }
+    updateInParent();
 }
 
 /**
@@ -460,8 +557,11 @@ void RS_EntityContainer::appendEntity(RS_Entity *entity) {
     if (!entity)
         return;
     entities.append(entity);
+    addToSpatialIndex(entity, false);
+    entityAdded(entity, false);
     if (autoUpdateBorders)
         adjustBorders(entity);
+    updateInParent();
 }
 
 /**
@@ -471,8 +571,11 @@ void RS_EntityContainer::appendEntity(RS_Entity *entity) {
 void RS_EntityContainer::prependEntity(RS_Entity *entity) {
     if (!entity) return;
     entities.prepend(entity);
+    addToSpatialIndex(entity, true);
+    entityAdded(entity, true);
     if (autoUpdateBorders)
         adjustBorders(entity);
+    updateInParent();
 }
 
 /**
@@ -508,6 +611,9 @@ void RS_EntityContainer::moveEntity(int index, QList<RS_Entity *> &entList) {
     for (auto e: entList) {
         entities.insert(ci++, e);
     }
+    // the entity order is changed
+    invalidateSpatialIndex();
+    entityListChanged();
 }
 
 /**
@@ -518,10 +624,21 @@ void RS_EntityContainer::insertEntity(int index, RS_Entity *entity) {
     if (!entity) return;
 
     entities.insert(index, entity);
+    if (index <= 0) {
+        addToSpatialIndex(entity, true);
+        entityAdded(entity, true);
+    } else if (index >= entities.size() - 1) {
+        addToSpatialIndex(entity, false);
+        entityAdded(entity, false);
+    } else {
+        invalidateSpatialIndex();
+        entityListChanged();
+    }
 
     if (autoUpdateBorders) {
         adjustBorders(entity);
     }
+    updateInParent();
 }
 
 /**
@@ -554,6 +671,15 @@ bool RS_EntityContainer::removeEntity(RS_Entity *entity) {
     //    and sets 'entIdx' in next() or last() if 'entity' is the last item in the list.
     //    in LibreCAD is never called with nullptr
     bool ret = entities.removeOne(entity);
+    if (QueryCache *cache = findQueryCache()) {
+        cache->spatialIndex.Remove(entity);
+        cache->staleEntities.erase(entity);
+        cache->endpointGraph.remove(entity);
+    }
+    if (ret) {
+        clearIntersectionCache();
+        entityRemoved(entity);
+    }
 
     if (autoDelete && ret) {
         delete entity;
@@ -561,9 +687,57 @@ bool RS_EntityContainer::removeEntity(RS_Entity *entity) {
     if (autoUpdateBorders) {
         calculateBorders();
     }
+    if (ret) {
+        updateInParent();
+    }
     return ret;
 }
 
+/**
+ * Removes the given entities with a single pass over the entity list,
+ * instead of searching the list for each of them like removeEntity().
+ *
+ * @return Number of entities removed.
+ */
+int RS_EntityContainer::removeEntities(const std::set<RS_Entity *> &toRemove) {
+    if (toRemove.empty()) {
+        return 0;
+    }
+    QList<RS_Entity *> kept;
+    kept.reserve(entities.size());
+    QList<RS_Entity *> removed;
+    for (RS_Entity *e: std::as_const(entities)) {
+        if (toRemove.count(e) == 0) {
+            kept.append(e);
+        } else {
+            removed.append(e);
+        }
+    }
+    if (removed.isEmpty()) {
+        return 0;
+    }
+    entities.swap(kept);
+    entityListChanged();
+    clearIntersectionCache();
+
+    QueryCache *cache = findQueryCache();
+    for (RS_Entity *e: std::as_const(removed)) {
+        if (cache != nullptr) {
+            cache->spatialIndex.Remove(e);
+            cache->staleEntities.erase(e);
+            cache->endpointGraph.remove(e);
+        }
+        if (autoDelete) {
+            delete e;
+        }
+    }
+    if (autoUpdateBorders) {
+        calculateBorders();
+    }
+    updateInParent();
+    return removed.size();
+}
+
 /**
  * Erases all entities in this container and resets the borders..
  */
@@ -576,10 +750,14 @@ void RS_EntityContainer::clear() {
     } else {
         entities.clear();
     }
+    invalidateSpatialIndex();
+    entityListChanged();
     resetBorders();
+    updateInParent();
 }
 
 unsigned int RS_EntityContainer::count() const {
+    ensureEntities();
     return entities.size();
 }
 
@@ -600,6 +778,7 @@ unsigned int RS_EntityContainer::countDeep() const {
  * Counts the selected entities in this container.
  */
 unsigned RS_EntityContainer::countSelected(bool deep, QList<RS2::EntityType> const &types) {
+    ensureEntities();
     unsigned c = 0;
     std::set<RS2::EntityType> type{types.cbegin(), types.cend()};
 
@@ -609,14 +788,21 @@ unsigned RS_EntityContainer::countSelected(bool deep, QList<RS2::EntityType> con
             if (!types.size() || type.count(t->rtti()))
                 c++;
 
-        if (t->isContainer()) 
-            c += dynamic_cast<RS_EntityContainer *>(t)->countSelected(deep); // fixme - hm... - what about entity types there? and deep flag?
+        if (t->isContainer()) {
+            auto *container = static_cast<RS_EntityContainer *>(t);
+            // deferred sub-entities take the selection of their container, so there are none selected
+            // in a container which is not selected, and there is no need to create them
+            if (t->isSelected() || !container->hasDeferredEntities()) {
+                c += container->countSelected(deep); // fixme - hm... - what about entity types there? and deep flag?
+            }
+        }
     }
 
     return c;
 }
 
 void RS_EntityContainer::collectSelected(std::vector<RS_Entity*> &collect, bool deep, QList<RS2::EntityType> const &types) {    
+    ensureEntities();
     std::set<RS2::EntityType> type{types.cbegin(), types.cend()};
 
     for (RS_Entity *e: entities) {
@@ -635,6 +821,7 @@ void RS_EntityContainer::collectSelected(std::vector<RS_Entity*> &collect, bool
 }
 // fixme - sand - avoid usage in actions as it enumerates all entities. Rework or rely on entities list!!!!
 RS_EntityContainer::LC_SelectionInfo RS_EntityContainer::getSelectionInfo(/*bool deep, */const QList<RS2::EntityType> &types) {
+    ensureEntities();
     LC_SelectionInfo result;
 
     std::set<RS2::EntityType> type{types.cbegin(), types.cend()};
@@ -661,6 +848,7 @@ RS_EntityContainer::LC_SelectionInfo RS_EntityContainer::getSelectionInfo(/*bool
  * Counts the selected entities in this container.
  */
 double RS_EntityContainer::totalSelectedLength() {
+    ensureEntities();
     double ret(0.0);
     for (RS_Entity *e: entities) {
 
@@ -703,8 +891,8 @@ void RS_EntityContainer::adjustBorders(RS_Entity *entity) {
  * Recalculates the borders of this entity container.
  */
 void RS_EntityContainer::calculateBorders() {
-    RS_DEBUG->print("RS_EntityContainer::calculateBorders");
-
+    const RS_Vector previousMin = minV;
+    const RS_Vector previousMax = maxV;
     resetBorders();
     for (RS_Entity *e: entities) {
 
@@ -719,9 +907,6 @@ void RS_EntityContainer::calculateBorders() {
         }
     }
 
-    RS_DEBUG->print("RS_EntityContainer::calculateBorders: size 1: %f,%f",
-                    getSize().x, getSize().y);
-
     // needed for correcting corrupt data (PLANS.dxf)
     if (minV.x > maxV.x || minV.x > RS_MAXDOUBLE || maxV.x > RS_MAXDOUBLE
         || minV.x < RS_MINDOUBLE || maxV.x < RS_MINDOUBLE) {
@@ -736,8 +921,7 @@ void RS_EntityContainer::calculateBorders() {
         maxV.y = 0.0;
     }
 
-    RS_DEBUG->print("RS_EntityContainer::calculateBorders: size: %f,%f",
-                    getSize().x, getSize().y);
+    updateInParent(previousMin, previousMax);
 
     //RS_DEBUG->print("  borders: %f/%f %f/%f", minV.x, minV.y, maxV.x, maxV.y);
 
@@ -761,7 +945,14 @@ void RS_EntityContainer::calculateBorders() {
  */
 void RS_EntityContainer::forcedCalculateBorders() {
     //RS_DEBUG->print("RS_EntityContainer::calculateBorders");
+    if (deferredEntities) {
+        // the borders don't depend on visibility of entities not created yet
+        calculateBorders();
+        return;
+    }
 
+    const RS_Vector previousMin = minV;
+    const RS_Vector previousMax = maxV;
     resetBorders();
     for (RS_Entity *e: entities) {
 
@@ -788,6 +979,7 @@ void RS_EntityContainer::forcedCalculateBorders() {
         minV.y = 0.0;
         maxV.y = 0.0;
     }
+    updateInParent(previousMin, previousMax);
 
     //RS_DEBUG->print("  borders: %f/%f %f/%f", minV.x, minV.y, maxV.x, maxV.y);
 
@@ -820,6 +1012,8 @@ void RS_EntityContainer::updateDimensions(bool autoText) {
         }
     }
 
+    // dimensions are regenerated in place
+    invalidateSpatialIndex();
     RS_DEBUG->print("RS_EntityContainer::updateDimensions() OK");
 }
 
@@ -849,6 +1043,8 @@ void RS_EntityContainer::updateInserts() {
                             idTypeId.c_str());
         }
     }
+    // inserts are regenerated in place
+    invalidateSpatialIndex();
     RS_DEBUG->print("RS_EntityContainer::updateInserts() ID/type: %s", idTypeId.c_str());
 }
 
@@ -898,6 +1094,7 @@ void RS_EntityContainer::updateSplines() {
         }
     }
 
+    invalidateSpatialIndex();
     RS_DEBUG->print("RS_EntityContainer::updateSplines() OK");
 }
 
@@ -909,6 +1106,7 @@ void RS_EntityContainer::update() {
     for (RS_Entity *e: entities) {
         e->update();
     }
+    invalidateSpatialIndex();
 }
 
 void RS_EntityContainer::addRectangle(RS_Vector const &v0, RS_Vector const &v1) {
@@ -930,6 +1128,7 @@ void RS_EntityContainer::addRectangle(RS_Vector const& v0, RS_Vector const& v1,R
  * @param level
  */
 RS_Entity *RS_EntityContainer::firstEntity(RS2::ResolveLevel level) const {
+    ensureEntities();
     RS_Entity *e = nullptr;
     entIdx = -1;
     switch (level) {
@@ -1011,6 +1210,7 @@ RS_Entity *RS_EntityContainer::firstEntity(RS2::ResolveLevel level) const {
  *              \li \p 2 all Entity Containers are resolved
  */
 RS_Entity *RS_EntityContainer::lastEntity(RS2::ResolveLevel level) const {
+    ensureEntities();
     RS_Entity *e = nullptr;
     if (!entities.size()) return nullptr;
     entIdx = entities.size() - 1;
@@ -1266,6 +1466,7 @@ RS_Entity *RS_EntityContainer::prevEntity(RS2::ResolveLevel level) const {
  * @return Entity at the given index or nullptr if the index is out of range.
  */
 RS_Entity *RS_EntityContainer::entityAt(int index) {
+    ensureEntities();
     if (entities.size() > index && index >= 0)
         return entities.at(index);
     else
@@ -1274,6 +1475,8 @@ RS_Entity *RS_EntityContainer::entityAt(int index) {
 
 
 void RS_EntityContainer::setEntityAt(int index, RS_Entity *en) {
+    invalidateSpatialIndex();
+    entityListChanged();
     if (autoDelete && entities.at(index)) {
         delete entities.at(index);
     }
@@ -1293,6 +1496,7 @@ int RS_EntityContainer::entityAt() {
  * Finds the given entity and makes it the current entity if found.
  */
 int RS_EntityContainer::findEntity(RS_Entity const *const entity) {
+    ensureEntities();
     entIdx = entities.indexOf(const_cast<RS_Entity *>(entity));
     return entIdx;
 }
@@ -1305,12 +1509,15 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(
     const RS_Vector &coord,
     double *dist) const {
 
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
 
-    for (RS_Entity *en: entities) {
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->isVisible()){
             auto parent = en->getParent();
             bool checkForEndpoint = true;
@@ -1319,16 +1526,16 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(
             }
             if (checkForEndpoint) {//no end point for Insert, text, Dim
                 point = en->getNearestEndpoint(coord, &curDist);
-                if (point.valid && curDist < minDist) {
+                if (point.valid && nearest.accept(curDist, order)) {
                     closestPoint = point;
-                    minDist = curDist;
                     if (dist) {
-                        *dist = minDist;
+                        *dist = nearest.distance;
                     }
                 }
             }
         }
-    }
+        return true;
+    });
 
     return closestPoint;
 }
@@ -1342,32 +1549,30 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(
     const RS_Vector &coord,
     double *dist, RS_Entity **pEntity) const {
 
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
 
-    //QListIterator<RS_Entity> it = createIterator();
-    //RS_Entity* en;
-    //while ( (en = it.current())  ) {
-    //    ++it;
-
-    for (auto en: entities) {
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->getParent() == nullptr || !en->getParent()->ignoredOnModification()) {//no end point for Insert, text, Dim
             //            std::cout<<"find nearest for entity "<<i0<<std::endl;
             point = en->getNearestEndpoint(coord, &curDist);
-            if (point.valid && curDist < minDist) {
+            if (point.valid && nearest.accept(curDist, order)) {
                 closestPoint = point;
-                minDist = curDist;
                 if (dist) {
-                    *dist = minDist;
+                    *dist = nearest.distance;
                 }
                 if (pEntity) {
                     *pEntity = en;
                 }
             }
         }
-    }
+        return true;
+    });
 
     //    std::cout<<__FILE__<<" : "<<__func__<<" : line "<<__LINE__<<std::endl;
     //    std::cout<<"count()="<<const_cast<RS_EntityContainer*>(this)->count()<<"\tminDist= "<<minDist<<"\tclosestPoint="<<closestPoint;
@@ -1396,25 +1601,27 @@ RS_Vector RS_EntityContainer::getNearestPointOnEntity(
 RS_Vector RS_EntityContainer::getNearestCenter(
     const RS_Vector &coord,
     double *dist) const {
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
 
-    for (auto en: entities) {
-
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->isVisible()
             && !en->getParent()->ignoredSnap()
             ) {//no center point for spline, text, Dim
             point = en->getNearestCenter(coord, &curDist);
-            if (point.valid && curDist < minDist) {
+            if (point.valid && nearest.accept(curDist, order)) {
                 closestPoint = point;
-                minDist = curDist;
             }
         }
-    }
+        return true;
+    });
     if (dist) {
-        *dist = minDist;
+        *dist = nearest.distance;
     }
 
     return closestPoint;
@@ -1427,25 +1634,27 @@ RS_Vector RS_EntityContainer::getNearestMiddle(
     double *dist,
     int middlePoints
 ) const {
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
 
-    for (auto en: entities) {
-
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->isVisible()
             && !en->getParent()->ignoredSnap()
             ) {//no midle point for spline, text, Dim
             point = en->getNearestMiddle(coord, &curDist, middlePoints);
-            if (point.valid && curDist < minDist) {
+            if (point.valid && nearest.accept(curDist, order)) {
                 closestPoint = point;
-                minDist = curDist;
             }
         }
-    }
+        return true;
+    });
     if (dist) {
-        *dist = minDist;
+        *dist = nearest.distance;
     }
 
     return closestPoint;
@@ -1474,30 +1683,29 @@ RS_Vector RS_EntityContainer::getNearestDist(
 RS_Vector RS_EntityContainer::getNearestIntersection(
     const RS_Vector &coord,
     double *dist) {
+    RS_Entity *closestEntity = getNearestEntity(coord, nullptr, RS2::ResolveAllButTextImage);
+    return getNearestIntersectionWith(closestEntity, coord, dist);
+}
+
+/**
+ * @return The intersection of the given entity nearest to 'coord'
+ */
+RS_Vector RS_EntityContainer::getNearestIntersectionWith(
+    RS_Entity *closestEntity,
+    const RS_Vector &coord,
+    double *dist) {
 
     double minDist = RS_MAXDOUBLE;  // minimum measured distance
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
-    RS_VectorSolutions sol;
-    RS_Entity *closestEntity;
-
-    closestEntity = getNearestEntity(coord, nullptr, RS2::ResolveAllButTextImage);
 
     if (closestEntity) {
-        for (RS_Entity *en = firstEntity(RS2::ResolveAllButTextImage);
-             en;
-             en = nextEntity(RS2::ResolveAllButTextImage)) {
-            if (
-                !en->isVisible()
-                || en->getParent()->ignoredSnap()
-                ) {
+        for (const IntersectionInfo &info: getIntersections(closestEntity)) {
+            if (!info.entity->isVisible()) {
                 continue;
             }
-
-            sol = RS_Information::getIntersection(closestEntity,
-                                                  en,
-                                                  true);
+            const RS_VectorSolutions &sol = info.intersections;
 
             point = sol.getClosest(coord, &curDist, nullptr);
             if (sol.getNumber() > 0 && curDist < minDist) {
@@ -1514,6 +1722,119 @@ RS_Vector RS_EntityContainer::getNearestIntersection(
     return closestPoint;
 }
 
+/**
+ * Finds the closest snap point of each queried kind in a single visit of the
+ * entities near 'coord'. Each kind is evaluated until no closer candidate of
+ * that kind is possible, so the points are the same as found by
+ * getNearestEndpoint(), getNearestCenter(), getNearestMiddle(), getNearestDist(),
+ * getNearestIntersection() and getNearestPointOnEntity(). Deferred intersections
+ * which are not cached yet are not found, see LC_SnapQuery::deferIntersections.
+ */
+RS_EntityContainer::LC_SnapPoints RS_EntityContainer::getNearestSnapPoints(
+    const RS_Vector &coord,
+    const LC_SnapQuery &query) {
+
+    LC_SnapPoints result;
+    NearestCandidate endpoint;
+    NearestCandidate center;
+    NearestCandidate middle;
+    // the nearest entity, for snapping on entity and by distance, and the nearest
+    // resolved entity, for intersections; see getDistanceToPoint()
+    NearestCandidate entity{true};
+    NearestCandidate intersectionEntity{true};
+    RS_Entity *closestEntity = nullptr;
+    RS_Entity *closestIntersectionEntity = nullptr;
+    const bool queryEntity = query.distance || query.onEntity;
+    double curDist = RS_MAXDOUBLE;  // currently measured distance
+    RS_Vector point;                // snap point found
+
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        const bool checkEndpoint = query.endpoint && endpoint.reachable(lowerBound);
+        const bool checkCenter = query.center && center.reachable(lowerBound);
+        const bool checkMiddle = query.middle && middle.reachable(lowerBound);
+        const bool checkEntity = queryEntity && entity.reachable(lowerBound);
+        const bool checkIntersection = query.intersection && intersectionEntity.reachable(lowerBound);
+        if (!(checkEndpoint || checkCenter || checkMiddle || checkEntity || checkIntersection)) {
+            return false;
+        }
+        if (!en->isVisible()) {
+            return true;
+        }
+        RS_EntityContainer *parent = en->getParent();
+        if (checkEndpoint && (parent == nullptr || !parent->ignoredOnModification())) {
+            point = en->getNearestEndpoint(coord, &curDist);
+            if (point.valid && endpoint.accept(curDist, order)) {
+                result.endpoint = point;
+            }
+        }
+        if ((checkCenter || checkMiddle) && !parent->ignoredSnap()) {
+            if (checkCenter) {
+                point = en->getNearestCenter(coord, &curDist);
+                if (point.valid && center.accept(curDist, order)) {
+                    result.center = point;
+                }
+            }
+            if (checkMiddle) {
+                point = en->getNearestMiddle(coord, &curDist, query.middlePoints);
+                if (point.valid && middle.accept(curDist, order)) {
+                    result.middle = point;
+                }
+            }
+        }
+        if ((checkEntity || checkIntersection) && (en->getLayer() == nullptr || !en->getLayer()->isLocked())) {
+            RS_Entity *subEntity = nullptr;
+            double entityDist = RS_MAXDOUBLE;
+            if (checkEntity) {
+                entityDist = en->getDistanceToPoint(coord, &subEntity, RS2::ResolveNone, RS_MAXDOUBLE);
+                if (entity.accept(entityDist, order)) {
+                    closestEntity = en;
+                }
+            }
+            // bug#426, need to ignore Images to find nearest intersections
+            if (checkIntersection && en->rtti() != RS2::EntityImage) {
+                // the distance to an atomic entity doesn't depend on the resolve level. Deferred
+                // sub-entities are created for the nearest container only, see below
+                const bool deferred = en->isContainer() && static_cast<RS_EntityContainer *>(en)->hasDeferredEntities();
+                if (!checkEntity || (en->isContainer() && !deferred)) {
+                    entityDist = en->getDistanceToPoint(coord, &subEntity,
+                                                        deferred ? RS2::ResolveNone : RS2::ResolveAllButTextImage,
+                                                        RS_MAXDOUBLE);
+                }
+                if (intersectionEntity.accept(entityDist, order)) {
+                    closestIntersectionEntity = deferred ? en : subEntity;
+                }
+            }
+        }
+        return true;
+    });
+
+    if (closestEntity != nullptr) {
+        if (query.distance) {
+            result.distance = closestEntity->getNearestDist(query.distanceToEndpoint, coord, nullptr);
+        }
+        if (query.onEntity && !closestEntity->getParent()->ignoredSnap()) {
+            result.onEntity = closestEntity->getNearestPointOnEntity(coord, true, nullptr, &result.onEntityKey);
+        }
+    }
+    if (closestIntersectionEntity != nullptr && closestIntersectionEntity->isContainer()
+        && static_cast<RS_EntityContainer *>(closestIntersectionEntity)->hasDeferredEntities()) {
+        closestIntersectionEntity->getDistanceToPoint(coord, &closestIntersectionEntity,
+                                                      RS2::ResolveAllButTextImage, RS_MAXDOUBLE);
+    }
+    if (closestIntersectionEntity != nullptr && closestIntersectionEntity->isVisible()) {
+        const QueryCache *cache = findQueryCache();
+        const bool cached = cache != nullptr && cache->intersectionCacheEntity == closestIntersectionEntity
+                            && !cache->intersectionCache.empty();
+        if (query.deferIntersections && !cached && getSpatialIndex() != nullptr) {
+            result.unsolvedIntersections = closestIntersectionEntity;
+        } else {
+            result.intersection = getNearestIntersectionWith(closestIntersectionEntity, coord, nullptr);
+        }
+    }
+
+    return result;
+}
+
 RS_Vector RS_EntityContainer::getNearestVirtualIntersection(
     const RS_Vector &coord,
     const double &angle,
@@ -1532,7 +1853,7 @@ RS_Vector RS_EntityContainer::getNearestVirtualIntersection(
         auto line = new RS_ConstructionLine(this, data);
 
         sol = RS_Information::getIntersection(closestEntity, line, true);
-        if (sol.getVector().empty()) {
+        if (sol.empty()) {
             return coord;
         } else {
             point = sol.getClosest(coord, dist, nullptr);
@@ -1548,24 +1869,26 @@ RS_Vector RS_EntityContainer::getNearestRef(
     const RS_Vector &coord,
     double *dist) const {
 
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
 
-    for (auto en: entities) {
-
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->isVisible()) {
             point = en->getNearestRef(coord, &curDist);
-            if (point.valid && curDist < minDist) {
+            if (point.valid && nearest.accept(curDist, order)) {
                 closestPoint = point;
-                minDist = curDist;
                 if (dist) {
-                    *dist = minDist;
+                    *dist = nearest.distance;
                 }
             }
         }
-    }
+        return true;
+    });
 
     return closestPoint;
 }
@@ -1581,27 +1904,29 @@ RS_Vector RS_EntityContainer::getNearestSelectedRef(
 RS_EntityContainer::RefInfo RS_EntityContainer::getNearestSelectedRefInfo(
     const RS_Vector &coord,
     double *dist) const {
-    double minDist = RS_MAXDOUBLE;  // minimum measured distance
+    NearestCandidate nearest;
     double curDist;                 // currently measured distance
     RefInfo result;
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
     RS_Entity *closestPointEntity = nullptr;
 
-    for (auto en: entities) { // fixme - sand - iteration of ver all entities
-
+    visitNearest(coord, [&](RS_Entity *en, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (en->isVisible() && en->isSelected() && !en->isParentSelected()) {
             point = en->getNearestSelectedRef(coord, &curDist);
-            if (point.valid && curDist < minDist) {
+            if (point.valid && nearest.accept(curDist, order)) {
                 closestPoint = point;
                 closestPointEntity = en;
-                minDist = curDist;
                 if (dist) {
-                    *dist = minDist;
+                    *dist = nearest.distance;
                 }
             }
         }
-    }
+        return true;
+    });
 
     result.ref = closestPoint;
     result.entity = closestPointEntity;
@@ -1619,17 +1944,21 @@ double RS_EntityContainer::getDistanceToPoint(
     RS_DEBUG->print("RS_EntityContainer::getDistanceToPoint");
 
 
-    double minDist = RS_MAXDOUBLE;      // minimum measured distance
+    // prefer the last one of equidistant entities, see below
+    NearestCandidate nearest{true};
     double curDist;                     // currently measured distance
     RS_Entity *closestEntity = nullptr;    // closest entity found
     RS_Entity *subEntity = nullptr;
 
-    for (auto e: entities) {
+    visitNearest(coord, [&](RS_Entity *e, double lowerBound, long order) {
+        if (!nearest.reachable(lowerBound)) {
+            return false;
+        }
         if (e->isVisible() && (e->getLayer() == nullptr || !e->getLayer()->isLocked())) {
             RS_DEBUG->print("entity: getDistanceToPoint");
             RS_DEBUG->print("entity: %d", e->rtti());
             // bug#426, need to ignore Images to find nearest intersections
-            if (level == RS2::ResolveAllButTextImage && e->rtti() == RS2::EntityImage) continue;
+            if (level == RS2::ResolveAllButTextImage && e->rtti() == RS2::EntityImage) return true;
             curDist = e->getDistanceToPoint(coord, &subEntity, level, solidDist);
 
             RS_DEBUG->print("entity: getDistanceToPoint: OK");
@@ -1643,7 +1972,7 @@ double RS_EntityContainer::getDistanceToPoint(
              * tend to want to reference entities that they see or have recently drawn as opposed
              * to deeper more forgotten and invisible ones...
              */
-            if (curDist <= minDist) {
+            if (nearest.accept(curDist, order)) {
                 switch (level) {
                     case RS2::ResolveAll:
                     case RS2::ResolveAllButTextImage:
@@ -1652,17 +1981,17 @@ double RS_EntityContainer::getDistanceToPoint(
                     default:
                         closestEntity = e;
                 }
-                minDist = curDist;
             }
         }
-    }
+        return true;
+    });
 
     if (entity) {
         *entity = closestEntity;
     }
     RS_DEBUG->print("RS_EntityContainer::getDistanceToPoint: OK");
 
-    return minDist;
+    return nearest.distance;
 }
 
 RS_Entity *RS_EntityContainer::getNearestEntity(
@@ -1710,7 +2039,6 @@ bool RS_EntityContainer::optimizeContours() {
 
     //    DEBUG_HEADER
     //    std::cout<<"loop with count()="<<count()<<std::endl;
-    RS_DEBUG->print("RS_EntityContainer::optimizeContours");
 
     RS_EntityContainer tmp;
     tmp.setAutoUpdateBorders(false);
@@ -1834,6 +2162,7 @@ bool RS_EntityContainer::optimizeContours() {
 }
 
 bool RS_EntityContainer::hasEndpointsWithinWindow(const RS_Vector &v1, const RS_Vector &v2) {
+    ensureEntities();
     for (auto e: entities) {
         if (e->hasEndpointsWithinWindow(v1, v2)) {
             return true;
@@ -1843,6 +2172,7 @@ bool RS_EntityContainer::hasEndpointsWithinWindow(const RS_Vector &v1, const RS_
 }
 
 void RS_EntityContainer::move(const RS_Vector &offset) {
+    invalidateSpatialIndex();
     moveBorders(offset);
     for (auto *e: entities) {
         e->move(offset);
@@ -1857,6 +2187,7 @@ void RS_EntityContainer::rotate(const RS_Vector &center, double angle) {
 }
 
 void RS_EntityContainer::rotate(const RS_Vector &center, const RS_Vector &angleVector) {
+    invalidateSpatialIndex();
     resetBorders();
 
     for (auto *e: entities) {
@@ -1869,6 +2200,7 @@ void RS_EntityContainer::rotate(const RS_Vector &center, const RS_Vector &angleV
 
 void RS_EntityContainer::scale(const RS_Vector &center, const RS_Vector &factor) {
     if (std::abs(factor.x) > RS_TOLERANCE && std::abs(factor.y) > RS_TOLERANCE) {
+        invalidateSpatialIndex();
         scaleBorders(center, factor);
         for (auto *e: entities) {
             e->scale(center, factor);
@@ -1882,6 +2214,7 @@ void RS_EntityContainer::scale(const RS_Vector &center, const RS_Vector &factor)
 void RS_EntityContainer::mirror(const RS_Vector &axisPoint1, const RS_Vector &axisPoint2) {
     if (axisPoint1.distanceTo(axisPoint2) > RS_TOLERANCE) {
 
+        invalidateSpatialIndex();
         resetBorders();
         for (auto *e: entities) {
             e->mirror(axisPoint1, axisPoint2);
@@ -1891,6 +2224,7 @@ void RS_EntityContainer::mirror(const RS_Vector &axisPoint1, const RS_Vector &ax
 }
 
 RS_Entity &RS_EntityContainer::shear(double k) {
+    invalidateSpatialIndex();
     for (auto *e: *this)
         e->shear(k);
     calculateBorders();
@@ -1903,6 +2237,7 @@ void RS_EntityContainer::stretch(
     const RS_Vector &secondCorner,
     const RS_Vector &offset) {
 
+    invalidateSpatialIndex();
     if (getMin().isInWindow(firstCorner, secondCorner) &&
         getMax().isInWindow(firstCorner, secondCorner)) {
 
@@ -1923,6 +2258,7 @@ void RS_EntityContainer::moveRef(
     const RS_Vector &ref,
     const RS_Vector &offset) {
 
+    invalidateSpatialIndex();
     resetBorders();
     for (auto *e: entities) {
         e->moveRef(ref, offset);
@@ -1937,6 +2273,7 @@ void RS_EntityContainer::moveSelectedRef(
     const RS_Vector &ref,
     const RS_Vector &offset) {
 
+    invalidateSpatialIndex();
     resetBorders();
     for (auto *e: entities) {
         e->moveSelectedRef(ref, offset);
@@ -1948,6 +2285,8 @@ void RS_EntityContainer::moveSelectedRef(
 }
 
 void RS_EntityContainer::revertDirection() {
+    invalidateSpatialIndex();
+    entityListChanged();
     // revert entity order in the container
     for (int k = 0; k < entities.size() / 2; ++k) {
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 13, 0))
@@ -1968,12 +2307,14 @@ void RS_EntityContainer::revertDirection() {
  * @param view
  */
 void RS_EntityContainer::draw(RS_Painter *painter) {
+    ensureEntities();
     foreach (auto *e, entities){
         painter->drawEntity(e);
     }
 }
 
 void RS_EntityContainer::drawAsChild(RS_Painter *painter) {
+    ensureEntities();
     foreach (auto *e, entities){
         painter->drawAsChild(e);
     }
@@ -1985,6 +2326,7 @@ void RS_EntityContainer::drawAsChild(RS_Painter *painter) {
  * @return line integral \oint x dy along the entity
  */
 double RS_EntityContainer::areaLineIntegral() const {
+    ensureEntities();
     //TODO make sure all contour integral is by counter-clockwise
     double contourArea = 0.;
     //closed area is always positive
@@ -2068,27 +2410,371 @@ bool RS_EntityContainer::ignoredSnap() const
     return ignoredOnModification();
 }
 
+void RS_EntityContainer::setSpatialIndexEnabled(bool enable) {
+    spatialIndexEnabled = enable;
+    if (!enable) {
+        invalidateSpatialIndex();
+    }
+}
+
+void RS_EntityContainer::invalidateSpatialIndex() {
+    if (QueryCache *cache = findQueryCache()) {
+        cache->spatialIndex.Invalidate();
+        cache->staleEntities.clear();
+        cache->endpointGraph.invalidate();
+    }
+    clearIntersectionCache();
+}
+
+void RS_EntityContainer::updateSpatialIndex(RS_Entity *entity) {
+    clearIntersectionCache();
+    QueryCache *cache = findQueryCache();
+    if (cache == nullptr) {
+        return;
+    }
+    cache->endpointGraph.invalidate();
+    if (entity == nullptr || !cache->spatialIndex.IsValid()) {
+        return;
+    }
+    cache->staleEntities.erase(entity);
+    LC_Rect extent;
+    if (getSnapExtent(*entity, extent)) {
+        cache->spatialIndex.Update(entity, extent);
+    } else {
+        cache->spatialIndex.UpdateUnbounded(entity);
+    }
+}
+
+void RS_EntityContainer::markSpatialIndexStale(RS_Entity *entity) {
+    clearIntersectionCache();
+    if (QueryCache *cache = findQueryCache()) {
+        cache->endpointGraph.invalidate();
+        // a container may tell its parent before it's added, e.g. a polyline being drawn
+        if (entity != nullptr && cache->spatialIndex.Contains(entity)) {
+            cache->staleEntities.insert(entity);
+        }
+    }
+    // the intersections cached by the parents contain the sub-entities of this container
+    updateInParent();
+}
+
+void RS_EntityContainer::updateInParent() {
+    if (parent != nullptr && !materializing && !parentUpdatesSuspended) {
+        parent->markSpatialIndexStale(this);
+    }
+}
+
+void RS_EntityContainer::updateInParent(const RS_Vector &previousMin, const RS_Vector &previousMax) {
+    if (minV.x != previousMin.x || minV.y != previousMin.y
+        || maxV.x != previousMax.x || maxV.y != previousMax.y) {
+        updateInParent();
+    }
+}
+
+const LC_EntityRTree *RS_EntityContainer::getSpatialIndex() const {
+    if (!spatialIndexEnabled || count() < spatialIndexMinSize) {
+        return nullptr;
+    }
+    QueryCache &cache = getQueryCache();
+    if (!cache.spatialIndex.IsValid()) {
+        RS_DEBUG->print("RS_EntityContainer::getSpatialIndex: building index of %u entities", count());
+        clearIntersectionCache();
+        cache.staleEntities.clear();
+        cache.spatialIndex.Reset();
+        for (RS_Entity *e: entities) {
+            addToSpatialIndex(e, false);
+        }
+    }
+    // entities changed in place since the last query
+    for (RS_Entity *e: cache.staleEntities) {
+        LC_Rect extent;
+        if (getSnapExtent(*e, extent)) {
+            cache.spatialIndex.Update(e, extent);
+        } else {
+            cache.spatialIndex.UpdateUnbounded(e);
+        }
+    }
+    cache.staleEntities.clear();
+    return &cache.spatialIndex;
+}
+
+void RS_EntityContainer::addToSpatialIndex(RS_Entity *entity, bool front) const {
+    if (entity == nullptr) {
+        return;
+    }
+    clearIntersectionCache();
+    // without a cache, there is no index or graph to keep
+    QueryCache *cache = findQueryCache();
+    if (cache == nullptr) {
+        return;
+    }
+    if (front) {
+        // the graph keeps the entity order
+        cache->endpointGraph.invalidate();
+    } else {
+        cache->endpointGraph.insert(entity);
+    }
+    if (!cache->spatialIndex.IsValid()) {
+        return;
+    }
+    LC_Rect extent;
+    if (getSnapExtent(*entity, extent)) {
+        cache->spatialIndex.Insert(entity, extent, front);
+    } else {
+        cache->spatialIndex.InsertUnbounded(entity, front);
+    }
+}
+
+void RS_EntityContainer::visitNearest(const RS_Vector &coord, const LC_EntityRTree::Visitor &visitor) const {
+    const LC_EntityRTree *index = getSpatialIndex();
+    if (index != nullptr) {
+        index->VisitNearest(coord, visitor);
+        return;
+    }
+    ensureEntities();
+    long order = 0;
+    for (RS_Entity *e: entities) {
+        if (!visitor(e, 0., order++)) {
+            return;
+        }
+    }
+}
+
+std::vector<RS_Entity *> RS_EntityContainer::getEntitiesNear(const RS_Vector &coord, double range) const {
+    return getEntitiesInBox(coord - std::abs(range), coord + std::abs(range));
+}
+
+std::vector<RS_Entity *> RS_EntityContainer::getEntitiesInBox(const RS_Vector &corner1, const RS_Vector &corner2) const {
+    const LC_EntityRTree *index = getSpatialIndex();
+    if (index == nullptr) {
+        ensureEntities();
+        return {entities.cbegin(), entities.cend()};
+    }
+    return index->EntitiesInBox(LC_Rect{corner1, corner2});
+}
+
+std::vector<RS_Entity *> RS_EntityContainer::getIntersectionCandidates(const RS_Vector &corner1,
+                                                                       const RS_Vector &corner2) const {
+    std::vector<RS_Entity *> candidates = getEntitiesInBox(corner1, corner2);
+    if (candidates.size() == count()) {
+        return candidates;
+    }
+    // entities on construction layers are infinite, wherever their borders are
+    RS_Document *document = getDocument();
+    RS_LayerList *layerList = document != nullptr ? document->getLayerList() : nullptr;
+    if (layerList == nullptr
+        || std::none_of(layerList->begin(), layerList->end(),
+                        [](const RS_Layer *layer) { return layer->isConstruction(); })) {
+        return candidates;
+    }
+
+    std::unordered_set<RS_Entity *> found{candidates.cbegin(), candidates.cend()};
+    auto add = [&](RS_Entity *entity) {
+        if (entity->isConstruction() && found.insert(entity).second) {
+            candidates.push_back(entity);
+        }
+    };
+    if (document == this) {
+        for (RS_Layer *layer: *layerList) {
+            if (layer->isConstruction()) {
+                for (RS_Entity *entity: document->getLayerEntities(layer)) {
+                    add(entity);
+                }
+            }
+        }
+    } else {
+        for (RS_Entity *entity: entities) {
+            add(entity);
+        }
+    }
+    return candidates;
+}
+
+bool RS_EntityContainer::isUnbounded(const RS_Entity *entity) {
+    return entity->rtti() == RS2::EntityConstructionLine || entity->isConstruction();
+}
+
+const LC_EndpointGraph &RS_EntityContainer::getEndpointGraph(double tolerance) const {
+    LC_EndpointGraph &endpointGraph = getQueryCache().endpointGraph;
+    if (!endpointGraph.isValid() || endpointGraph.getTolerance() != tolerance) {
+        ensureEntities();
+        RS_DEBUG->print("RS_EntityContainer::getEndpointGraph: building graph of %u entities", count());
+        endpointGraph.reset(tolerance);
+        for (RS_Entity *e: entities) {
+            endpointGraph.insert(e);
+        }
+    }
+    return endpointGraph;
+}
+
+bool RS_EntityContainer::resolvesInto(const RS_Entity *entity, RS2::ResolveLevel level) {
+    if (entity == nullptr || !entity->isContainer()) {
+        return false;
+    }
+    switch (level) {
+        case RS2::ResolveAll:
+            return true;
+        case RS2::ResolveAllButInserts:
+            return entity->rtti() != RS2::EntityInsert;
+        case RS2::ResolveAllButTextImage:
+        case RS2::ResolveAllButTexts:
+            return entity->rtti() != RS2::EntityText && entity->rtti() != RS2::EntityMText;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Finds the intersections of an entity with all other entities, resolved by
+ * RS2::ResolveAllButTextImage. With a spatial index, only entities with overlapping
+ * bounding boxes are solved for intersections, and the result is kept until the
+ * container is changed.
+ */
+const std::vector<RS_EntityContainer::IntersectionInfo> &RS_EntityContainer::getIntersections(RS_Entity *entity) {
+    constexpr RS2::ResolveLevel level = RS2::ResolveAllButTextImage;
+
+    // the cache is cleared, when sub-entities created while solving change the borders of their container
+    std::vector<IntersectionInfo> intersections;
+    if (getSpatialIndex() == nullptr) {
+        // no index: solve with all entities
+        for (RS_Entity *en: LC_EntityRange{*this, level}) {
+            if (!en->isVisible() || en->getParent()->ignoredSnap()) {
+                continue;
+            }
+            intersections.push_back({en, RS_Information::getIntersection(entity, en, true)});
+        }
+        QueryCache &cache = getQueryCache();
+        cache.intersectionCache = std::move(intersections);
+        cache.intersectionCacheEntity = nullptr;
+        return cache.intersectionCache;
+    }
+
+    QueryCache &cache = getQueryCache();
+    if (cache.intersectionCacheEntity == entity && !cache.intersectionCache.empty()) {
+        return cache.intersectionCache;
+    }
+
+    for (RS_Entity *en: getIntersectionPartners(entity)) {
+        intersections.push_back({en, RS_Information::getIntersection(entity, en, true)});
+    }
+
+    // keep an empty result from being solved again
+    if (intersections.empty()) {
+        intersections.push_back({entity, RS_VectorSolutions{}});
+    }
+    cache.intersectionCache = std::move(intersections);
+    cache.intersectionCacheEntity = entity;
+    return cache.intersectionCache;
+}
+
+std::vector<RS_Entity *> RS_EntityContainer::getIntersectionPartners(RS_Entity *entity) {
+    constexpr RS2::ResolveLevel level = RS2::ResolveAllButTextImage;
+    // entities are only intersected within their borders
+    const bool bounded = !isUnbounded(entity);
+    const LC_Rect box{entity->getMin(), entity->getMax()};
+    std::vector<RS_Entity *> candidates = bounded ? getIntersectionCandidates(entity->getMin(), entity->getMax())
+                                                  : std::vector<RS_Entity *>{entities.cbegin(), entities.cend()};
+
+    std::vector<RS_Entity *> partners;
+    unsigned long culled = 0;
+    auto intersect = [&](RS_Entity *en) {
+        // visibility is checked on use, as it may change without changing the container
+        if (en->getParent()->ignoredSnap()) {
+            return;
+        }
+        if (bounded && !isUnbounded(en)
+            && !box.intersects(LC_Rect{en->getMin(), en->getMax()}, RS_TOLERANCE)) {
+            ++culled;
+            return;
+        }
+        partners.push_back(en);
+    };
+    for (RS_Entity *candidate: candidates) {
+        if (resolvesInto(candidate, level)) {
+            auto *sub = static_cast<RS_EntityContainer *>(candidate);
+            for (RS_Entity *en: LC_EntityRange{*sub, level}) {
+                intersect(en);
+            }
+        } else {
+            intersect(candidate);
+        }
+    }
+    // solver calls avoided: entities not returned by the index, plus candidates culled by borders
+    const unsigned long avoided = bounded ? count() - (unsigned long) candidates.size() + culled : culled;
+    RS_DEBUG->print(RS_Debug::D_DEBUGGING,
+                    "RS_EntityContainer::getIntersectionPartners: %lu candidates of %u entities, %lu solved, %lu culled by borders, %lu solver calls avoided",
+                    (unsigned long) candidates.size(), count(), (unsigned long) partners.size(), culled, avoided);
+    return partners;
+}
+
+std::unique_ptr<LC_IntersectionJob> RS_EntityContainer::prepareIntersectionJob(RS_Entity *entity) {
+    if (entity == nullptr || getSpatialIndex() == nullptr) {
+        return nullptr;
+    }
+    auto job = std::make_unique<LC_IntersectionJob>(this, entity, intersectionGeneration);
+    for (RS_Entity *en: getIntersectionPartners(entity)) {
+        job->addPartner(en);
+    }
+    return job;
+}
+
+bool RS_EntityContainer::takeIntersectionJob(LC_IntersectionJob &job) {
+    if (job.getContainer() != this || job.getGeneration() != intersectionGeneration) {
+        return false;
+    }
+    QueryCache &cache = getQueryCache();
+    cache.intersectionCache.clear();
+    cache.intersectionCacheEntity = job.getEntity();
+    for (auto &[en, intersections]: job.takeResult()) {
+        cache.intersectionCache.push_back({en, std::move(intersections)});
+    }
+    if (cache.intersectionCache.empty()) {
+        cache.intersectionCache.push_back({job.getEntity(), RS_VectorSolutions{}});
+    }
+    return true;
+}
+
+RS_EntityContainer::QueryCache &RS_EntityContainer::getQueryCache() const {
+    if (queryCache.cache == nullptr) {
+        queryCache.cache = std::make_unique<QueryCache>();
+    }
+    return *queryCache.cache;
+}
+
+void RS_EntityContainer::clearIntersectionCache() const {
+    if (QueryCache *cache = findQueryCache()) {
+        cache->intersectionCache.clear();
+    }
+    ++intersectionGeneration;
+}
+
 QList<RS_Entity *>::const_iterator RS_EntityContainer::begin() const{
+    ensureEntities();
     return entities.begin();
 }
 
 QList<RS_Entity *>::const_iterator RS_EntityContainer::end() const{
+    ensureEntities();
     return entities.end();
 }
 
 QList<RS_Entity *>::const_iterator RS_EntityContainer::cbegin() const{
+    ensureEntities();
     return entities.cbegin();
 }
 
 QList<RS_Entity *>::const_iterator RS_EntityContainer::cend() const{
+    ensureEntities();
     return entities.cend();
 }
 
 QList<RS_Entity *>::iterator RS_EntityContainer::begin(){
+    ensureEntities();
     return entities.begin();
 }
 
 QList<RS_Entity *>::iterator RS_EntityContainer::end() {
+    ensureEntities();
     return entities.end();
 }
 
@@ -2149,18 +2835,22 @@ std::ostream &operator<<(std::ostream &os, RS_EntityContainer &ec) {
 }
 
 RS_Entity *RS_EntityContainer::first() const {
+    ensureEntities();
     return entities.first();
 }
 
 RS_Entity *RS_EntityContainer::last() const {
+    ensureEntities();
     return entities.last();
 }
 
 const QList<RS_Entity *> &RS_EntityContainer::getEntityList() {
+    ensureEntities();
     return entities;
 }
 
 std::vector<std::unique_ptr<RS_EntityContainer>> RS_EntityContainer::getLoops() const {
+    ensureEntities();
     if (entities.empty())
         return {};
 
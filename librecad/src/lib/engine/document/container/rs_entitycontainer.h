@@ -29,10 +29,16 @@
 #define RS_ENTITYCONTAINER_H
 
 #include <memory>
+#include <set>
+#include <unordered_set>
 #include <vector>
 #include <QList>
+#include "lc_endpointgraph.h"
+#include "lc_rtree.h"
 #include "rs_entity.h"
 
+class LC_IntersectionJob;
+
 /**
  * Class representing a tree of entities.
  * Typical entity containers are graphics, polylines, groups, texts, ...)
@@ -54,6 +60,41 @@ public:
         double length = 0.0;
     };
 
+    /**
+     * Snap kinds evaluated by getNearestSnapPoints()
+     */
+    struct LC_SnapQuery{
+        bool endpoint = false;
+        bool center = false;
+        bool middle = false;
+        int middlePoints = 1;
+        bool distance = false;
+        double distanceToEndpoint = 1.0;
+        bool intersection = false;
+        bool onEntity = false;
+        /**
+         * intersections which are not cached are not solved, but returned as
+         * LC_SnapPoints::unsolvedIntersections, to be solved by prepareIntersectionJob()
+         */
+        bool deferIntersections = false;
+    };
+
+    /**
+     * The closest snap point of each kind, invalid if the kind was not queried or not found
+     */
+    struct LC_SnapPoints{
+        RS_Vector endpoint{false};
+        RS_Vector center{false};
+        RS_Vector middle{false};
+        RS_Vector distance{false};
+        RS_Vector intersection{false};
+        RS_Vector onEntity{false};
+        /** the entity of the point on entity */
+        RS_Entity* onEntityKey = nullptr;
+        /** the entity whose intersections were deferred, see LC_SnapQuery::deferIntersections */
+        RS_Entity* unsolvedIntersections = nullptr;
+    };
+
     RS_EntityContainer(RS_EntityContainer* parent=nullptr, bool owner=true);
     //RS_EntityContainer(const RS_EntityContainer& ec);
 
@@ -106,6 +147,7 @@ public:
     virtual void moveEntity(int index, QList<RS_Entity *>& entList);
     virtual void insertEntity(int index, RS_Entity* entity);
     virtual bool removeEntity(RS_Entity* entity);
+    int removeEntities(const std::set<RS_Entity*>& toRemove);
 
 //!
 //! \brief addRectangle add four lines to form a rectangle by
@@ -184,6 +226,7 @@ public:
                              double* dist = nullptr) const override;
     RS_Vector getNearestIntersection(const RS_Vector& coord,
                                      double* dist = nullptr);
+    LC_SnapPoints getNearestSnapPoints(const RS_Vector& coord, const LC_SnapQuery& query);
     RS_Vector getNearestVirtualIntersection(const RS_Vector& coord,
                                             const double& angle,
                                             double* dist);
@@ -240,7 +283,96 @@ public:
 
     void push_back(RS_Entity* entity) {
         entities.push_back(entity);
+        addToSpatialIndex(entity, false);
+        entityAdded(entity, false);
+        updateInParent();
+    }
+
+    /**
+     * Enables / disables the spatial index of this container. The index is
+     * built on demand for containers with many entities, and is used by the
+     * nearest entity and nearest point queries, so snapping and picking cost
+     * depends on the entities close to the cursor instead of the container size.
+     * By default, only documents use a spatial index.
+     */
+    void setSpatialIndexEnabled(bool enable);
+    bool isSpatialIndexEnabled() const {
+        return spatialIndexEnabled;
+    }
+    /**
+     * Drops the spatial index. It will be rebuilt by the next query.
+     */
+    void invalidateSpatialIndex();
+    /**
+     * Updates the extent of an entity in the spatial index, called when the
+     * entity geometry is changed in place.
+     */
+    void updateSpatialIndex(RS_Entity* entity);
+    /**
+     * Suspends or resumes telling the parent of changes of this container. Used while the
+     * container is updated by another thread, the caller updates the parent afterwards.
+     */
+    void suspendParentUpdates(bool suspend) {
+        parentUpdatesSuspended = suspend;
+    }
+    /**
+     * Called by a child container changed in place, e.g. a polyline getting more
+     * vertices while it's drawn. The extent of the child in the spatial index is
+     * updated by the next query.
+     */
+    void markSpatialIndexStale(RS_Entity* entity);
+    /**
+     * Called by a child entity after its layer was changed from previous.
+     */
+    virtual void entityLayerChanged([[maybe_unused]] RS_Entity* entity, [[maybe_unused]] RS_Layer* previous) {}
+    /**
+     * @brief getEntitiesNear top level entities which may be within the given
+     * range to a point. Without a spatial index, all entities are returned.
+     * @return entities by the order of this container
+     */
+    std::vector<RS_Entity*> getEntitiesNear(const RS_Vector& coord, double range) const;
+    std::vector<RS_Entity*> getEntitiesInBox(const RS_Vector& corner1, const RS_Vector& corner2) const;
+    /**
+     * @brief getIntersectionCandidates top level entities which may intersect an entity within
+     * the box: the entities in the box by the order of this container, followed by the unbounded
+     * entities outside of the box.
+     */
+    std::vector<RS_Entity*> getIntersectionCandidates(const RS_Vector& corner1, const RS_Vector& corner2) const;
+    /**
+     * @return true for entities intersected as infinite curves: construction lines, and
+     * entities on construction layers, by the rules of RS_Information::getIntersection()
+     */
+    static bool isUnbounded(const RS_Entity* entity);
+    /**
+     * @brief getEndpointGraph the entities of this container connected by their start and
+     * end points within the tolerance. The graph is built on demand, kept by adding entities
+     * to the end of this container and by removing entities, and dropped by other changes.
+     */
+    const LC_EndpointGraph& getEndpointGraph(double tolerance) const;
+    /**
+     * @return true, if iterating with the resolve level goes into sub-entities of
+     * the entity, by the same rules as firstEntity()/nextEntity()
+     */
+    static bool resolvesInto(const RS_Entity* entity, RS2::ResolveLevel level);
+    /**
+     * @return true, if the sub-entities are not created yet. They are created
+     * on the first access, the borders are valid without them.
+     */
+    bool hasDeferredEntities() const{
+        return deferredEntities;
     }
+    /**
+     * @brief prepareIntersectionJob copies an entity and the entities which may intersect it, to
+     * solve their intersections in another thread.
+     * @return the job, or nullptr without a spatial index: the intersections are not cached then
+     */
+    std::unique_ptr<LC_IntersectionJob> prepareIntersectionJob(RS_Entity* entity);
+    /**
+     * @brief takeIntersectionJob caches the intersections solved by a job, for the following
+     * intersection snapping of its entity.
+     * @return false, if the job was dropped, as this container was changed since it was prepared
+     */
+    bool takeIntersectionJob(LC_IntersectionJob& job);
 
 /**
  * @brief begin/end to support range based loop
@@ -261,7 +393,7 @@ public:
 
     const QList<RS_Entity*>& getEntityList();
 
-    inline RS_Entity* unsafeEntityAt(int index) const {return entities.at(index);}
+    inline RS_Entity* unsafeEntityAt(int index) const {ensureEntities(); return entities.at(index);}
 
     void drawAsChild(RS_Painter *painter) override;
 
@@ -276,6 +408,49 @@ protected:
      */
     virtual std::vector<std::unique_ptr<RS_EntityContainer>> getLoops() const;
 
+    /**
+     * @brief materializeEntities creates the deferred sub-entities, called once
+     * on the first access when deferredEntities is set. Recalculates the borders
+     * from the created sub-entities.
+     */
+    virtual void materializeEntities() const {}
+    /**
+     * @brief ensureEntities creates the deferred sub-entities before an access to the entity list,
+     * also from const methods. There is no locking: a container with deferred sub-entities may only
+     * be accessed by a single thread, the GUI thread. The worker threads of LC_ParallelUpdate only
+     * update their own entities, and LC_SnapWorker gets copies of resolved entities, made by the GUI thread.
+     * The parent is told once afterwards, if the borders of the created sub-entities differ from the
+     * borders found without them.
+     */
+    void ensureEntities() const{
+        if (deferredEntities) {
+            const RS_Vector previousMin = minV;
+            const RS_Vector previousMax = maxV;
+            deferredEntities = false;
+            materializing = true;
+            materializeEntities();
+            materializing = false;
+            const_cast<RS_EntityContainer*>(this)->updateInParent(previousMin, previousMax);
+        }
+    }
+
+    /**
+     * Notifications of changes of the entity list, for indexes of the entities kept by subclasses.
+     * entityAdded() is called for an entity added at the front or the back of the list, entityRemoved()
+     * for a single removed entity, and entityListChanged() for any other change, e.g. of the order.
+     */
+    virtual void entityAdded([[maybe_unused]] RS_Entity* entity, [[maybe_unused]] bool front) {}
+    virtual void entityRemoved([[maybe_unused]] RS_Entity* entity) {}
+    virtual void entityListChanged() {}
+
+    /**
+     * Tells the parent that the sub-entities of this container changed in place, so the spatial
+     * index and the caches of the parent follow edits of entities already in the parent. The
+     * second form tells it only if the borders differ from the previous ones.
+     */
+    void updateInParent();
+    void updateInParent(const RS_Vector& previousMin, const RS_Vector& previousMax);
+
     /** entities in the container */
     QList<RS_Entity *> entities;
 
@@ -288,15 +463,85 @@ protected:
      */
     bool autoUpdateBorders = true;
 
+    /** sub-entities are created on demand by materializeEntities() */
+    mutable bool deferredEntities = false;
+    /** the deferred sub-entities are being created: their parent doesn't see them as changes */
+    mutable bool materializing = false;
+    /** changes are not told to the parent, see suspendParentUpdates() */
+    bool parentUpdatesSuspended = false;
+
 private:
 /**
  * @brief ignoredSnap whether snapping is ignored
  * @return true when entity of this container won't be considered for snapping points
  */
     bool ignoredSnap() const;
+    /**
+     * @return the spatial index, built on demand, or nullptr if no index is used
+     */
+    const LC_EntityRTree* getSpatialIndex() const;
+    void addToSpatialIndex(RS_Entity* entity, bool front) const;
+    /**
+     * @brief visitNearest visit entities in the order of their distance to coord
+     * With a spatial index, the visited distance is the distance to the entity extent,
+     * otherwise all entities are visited in the container order with zero distance.
+     */
+    void visitNearest(const RS_Vector& coord, const LC_EntityRTree::Visitor& visitor) const;
+
+    /** intersections found with one entity */
+    struct IntersectionInfo {
+        RS_Entity* entity = nullptr;
+        RS_VectorSolutions intersections;
+    };
+    const std::vector<IntersectionInfo>& getIntersections(RS_Entity* entity);
+    /** @return the entities solved for intersections with the entity, resolved, with a spatial index */
+    std::vector<RS_Entity*> getIntersectionPartners(RS_Entity* entity);
+    /** clears the intersection cache after a change of the entities */
+    void clearIntersectionCache() const;
+    RS_Vector getNearestIntersectionWith(RS_Entity* closestEntity, const RS_Vector& coord, double* dist);
+
+    /**
+     * The spatial index and the caches of the queries. Most containers, like polylines or
+     * inserts, are never queried, so the caches are allocated by the first query needing them.
+     */
+    struct QueryCache {
+        /** spatial index of entities, rebuilt on demand */
+        LC_EntityRTree spatialIndex;
+        /** entities changed in place, to be updated in the spatial index by the next query */
+        std::unordered_set<RS_Entity*> staleEntities;
+        /** connectivity of entities by end points, rebuilt on demand */
+        LC_EndpointGraph endpointGraph;
+        /** intersections of the entity last snapped to, cleared by changes of the container */
+        std::vector<IntersectionInfo> intersectionCache;
+        RS_Entity* intersectionCacheEntity = nullptr;
+    };
+    /** owner of the query cache. A copy of a container starts without it, as LC_EntityRTree does */
+    struct QueryCacheHolder {
+        QueryCacheHolder() = default;
+        QueryCacheHolder(const QueryCacheHolder& /*other*/) {}
+        QueryCacheHolder& operator = (const QueryCacheHolder& other) {
+            if (this != &other) {
+                cache.reset();
+            }
+            return *this;
+        }
+        std::unique_ptr<QueryCache> cache;
+    };
+    /** @return the query cache, allocated by the first call */
+    QueryCache& getQueryCache() const;
+    /** @return the query cache, or nullptr if no query needed it yet */
+    QueryCache* findQueryCache() const {
+        return queryCache.cache.get();
+    }
+
     mutable int entIdx = 0;
     bool autoDelete = false;
 
+    mutable QueryCacheHolder queryCache;
+    bool spatialIndexEnabled = false;
+    /** counts the changes clearing the intersection cache, to drop outdated intersection jobs */
+    mutable unsigned long intersectionGeneration = 0;
+
 
 };
 
@@ -0,0 +1,390 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+
+#include "lc_hatchscanline.h"
+#include "rs_arc.h"
+#include "rs_entitycontainer.h"
+#include "rs_information.h"
+#include "rs_line.h"
+#include "rs_math.h"
+
+namespace {
+// largest tile count searched for the period of a pattern line along its own direction
+constexpr int maxLatticeStep = 32;
+
+// relative tolerance for a lattice vector to be parallel to a pattern line
+constexpr double latticeTolerance = 1e-8;
+
+// a single pattern line copy for line families without a period
+struct Carrier {
+    double c = 0.;
+    double t = 0.;
+};
+
+// x, y such that a*x + b*y = gcd(a, b)
+int extendedGcd(int a, int b, int& x, int& y)
+{
+    if (b == 0) {
+        x = a >= 0 ? 1 : -1;
+        y = 0;
+        return std::abs(a);
+    }
+    int x1 = 0;
+    int y1 = 0;
+    const int g = extendedGcd(b, a % b, x1, y1);
+    x = y1;
+    y = x1 - (a / b) * y1;
+    return g;
+}
+
+/**
+ * @brief findPeriod - the shortest tile lattice vector (p*width, q*height) along the direction
+ * @return false, if the direction is not a lattice direction within maxLatticeStep tiles
+ */
+bool findPeriod(const RS_Vector& direction, const RS_Vector& tileSize, int& p, int& q)
+{
+    double best = RS_MAXDOUBLE;
+    for (int i = 0; i <= maxLatticeStep; ++i) {
+        for (int j = -maxLatticeStep; j <= maxLatticeStep; ++j) {
+            if ((i == 0 && j <= 0) || std::gcd(i, j) != 1)
+                continue;
+            const RS_Vector period{i * tileSize.x, j * tileSize.y};
+            const double length = period.magnitude();
+            const double offset = std::abs(period.x * direction.y - period.y * direction.x);
+            if (offset <= latticeTolerance * length && length < best) {
+                best = length;
+                p = i;
+                q = j;
+            }
+        }
+    }
+    return best < RS_MAXDOUBLE;
+}
+
+// extent of an axis aligned box along the axis
+std::pair<double, double> projectBox(const RS_Vector& min, const RS_Vector& max, const RS_Vector& axis)
+{
+    const std::array<RS_Vector, 4> corners{{min, {max.x, min.y}, max, {min.x, max.y}}};
+    double from = RS_MAXDOUBLE;
+    double to = RS_MINDOUBLE;
+    for (const RS_Vector& corner: corners) {
+        from = std::min(from, axis.dotP(corner));
+        to = std::max(to, axis.dotP(corner));
+    }
+    return {from, to};
+}
+
+// the endpoints of an edge used for crossings, circles are closed at angle 0
+std::pair<RS_Vector, RS_Vector> edgeEnds(const RS_Entity& edge)
+{
+    if (edge.rtti() == RS2::EntityCircle) {
+        const RS_Vector start = edge.getCenter() + RS_Vector{edge.getRadius(), 0.};
+        return {start, start};
+    }
+    return {edge.getStartpoint(), edge.getEndpoint()};
+}
+}
+
+LC_HatchScanline::LC_HatchScanline(const RS_EntityContainer& contour):
+    m_min{RS_MAXDOUBLE, RS_MAXDOUBLE}
+  , m_max{RS_MINDOUBLE, RS_MINDOUBLE}
+{
+    addEdges(contour);
+}
+
+void LC_HatchScanline::addEdges(const RS_EntityContainer& container)
+{
+    for (const RS_Entity* e: container) {
+        if (e == nullptr || e->isUndone())
+            continue;
+        if (e->isContainer()) {
+            addEdges(*static_cast<const RS_EntityContainer*>(e));
+            continue;
+        }
+        Edge edge;
+        edge.entity = e;
+        std::tie(edge.start, edge.end) = edgeEnds(*e);
+        if (!edge.start.valid || !edge.end.valid)
+            continue;
+        m_edges.push_back(edge);
+        m_min = RS_Vector::minimum(m_min, e->getMin());
+        m_max = RS_Vector::maximum(m_max, e->getMax());
+    }
+}
+
+void LC_HatchScanline::prepareSweep(const RS_Vector& direction)
+{
+    m_direction = direction;
+    m_normal = {-direction.y, direction.x};
+
+    std::tie(m_tMin, m_tMax) = projectBox(m_min, m_max, m_direction);
+
+    for (Edge& edge: m_edges) {
+        switch (edge.entity->rtti()) {
+        case RS2::EntityLine:
+            edge.nMin = std::min(m_normal.dotP(edge.start), m_normal.dotP(edge.end));
+            edge.nMax = std::max(m_normal.dotP(edge.start), m_normal.dotP(edge.end));
+            break;
+        case RS2::EntityArc:
+        case RS2::EntityCircle: {
+            const double n = m_normal.dotP(edge.entity->getCenter());
+            edge.nMin = n - edge.entity->getRadius();
+            edge.nMax = n + edge.entity->getRadius();
+            break;
+        }
+        default:
+            std::tie(edge.nMin, edge.nMax) = projectBox(edge.entity->getMin(), edge.entity->getMax(), m_normal);
+            break;
+        }
+        edge.nMin -= RS_TOLERANCE;
+        edge.nMax += RS_TOLERANCE;
+    }
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge& e0, const Edge& e1) {
+        return e0.nMin < e1.nMin;
+    });
+    m_next = 0;
+    m_active.clear();
+}
+
+bool LC_HatchScanline::clip(const Segment& line, const RS_Vector& tileSize, std::size_t maxSegments,
+                            std::vector<Segment>& visible)
+{
+    if (m_edges.empty())
+        return true;
+
+    RS_Vector direction = line.second - line.first;
+    double length = direction.magnitude();
+    // a dot is a zero length dash in any direction
+    const bool isDot = length < RS_TOLERANCE;
+    if (isDot) {
+        direction = {1., 0.};
+        length = 0.;
+    } else {
+        direction /= length;
+    }
+    prepareSweep(direction);
+
+    const auto [cMin, cMax] = projectBox(m_min, m_max, m_normal);
+    const double c0 = m_normal.dotP(line.first);
+    const double t0 = m_direction.dotP(line.first);
+
+    std::vector<double> ts;
+    // adds the part of a dash inside [u0, u1]
+    auto addDash = [&](double c, double u0, double u1, double dashStart) {
+        const double from = std::max(u0, dashStart);
+        const double to = std::min(u1, dashStart + length);
+        if (isDot ? (dashStart < u0 || dashStart > u1) : to - from <= RS_TOLERANCE)
+            return true;
+        visible.emplace_back(m_normal * c + m_direction * from, m_normal * c + m_direction * to);
+        return visible.size() <= maxSegments;
+    };
+
+    int p = 0;
+    int q = 0;
+    if (findPeriod(m_direction, tileSize, p, q)) {
+        // all copies of the line on one carrier repeat with the period (p, q) tiles, and the carriers are the
+        // lattice cosets: (u, v) completes (p, q) to a lattice basis, so carrier m holds the copy m*(u, v)
+        double period = m_direction.dotP({p * tileSize.x, q * tileSize.y});
+        if (period < 0.) {
+            p = -p;
+            q = -q;
+            period = -period;
+        }
+        int u = 0;
+        int v = 0;
+        extendedGcd(p, -q, v, u);
+        RS_Vector step{u * tileSize.x, v * tileSize.y};
+        double spacing = m_normal.dotP(step);
+        if (spacing < 0.) {
+            step = -step;
+            spacing = -spacing;
+        }
+        const double shift = m_direction.dotP(step);
+        const double mFrom = std::ceil((cMin - c0) / spacing);
+        const double mTo = std::floor((cMax - c0) / spacing);
+        if (mTo - mFrom > double(maxSegments))
+            return false;
+
+        const bool continuous = length + latticeTolerance * period >= period;
+        for (double m = mFrom; m <= mTo; m += 1.) {
+            const double c = c0 + m * spacing;
+            crossings(c, ts);
+            const double base = t0 + m * shift;
+            for (std::size_t i = 0; i + 1 < ts.size(); i += 2) {
+                const double u0 = ts[i];
+                const double u1 = ts[i + 1];
+                if (continuous) {
+                    if (u1 - u0 > RS_TOLERANCE) {
+                        visible.emplace_back(m_normal * c + m_direction * u0, m_normal * c + m_direction * u1);
+                        if (visible.size() > maxSegments)
+                            return false;
+                    }
+                    continue;
+                }
+                const double kFrom = std::ceil((u0 - base - length) / period);
+                const double kTo = std::floor((u1 - base) / period);
+                for (double k = kFrom; k <= kTo; k += 1.) {
+                    if (!addDash(c, u0, u1, base + k * period))
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // no period: every copy of the line is on a carrier of its own
+    const int i1 = static_cast<int>(std::floor(m_min.x / tileSize.x));
+    const int j1 = static_cast<int>(std::floor(m_min.y / tileSize.y));
+    const int i2 = static_cast<int>(std::ceil(m_max.x / tileSize.x));
+    const int j2 = static_cast<int>(std::ceil(m_max.y / tileSize.y));
+    if (double(i2 - i1) * double(j2 - j1) > double(maxSegments))
+        return false;
+
+    std::vector<Carrier> carriers;
+    carriers.reserve(std::size_t(i2 - i1) * std::size_t(j2 - j1));
+    for (int i = i1; i < i2; ++i) {
+        for (int j = j1; j < j2; ++j) {
+            const RS_Vector offset{i * tileSize.x, j * tileSize.y};
+            carriers.push_back({c0 + m_normal.dotP(offset), t0 + m_direction.dotP(offset)});
+        }
+    }
+    std::sort(carriers.begin(), carriers.end(), [](const Carrier& a, const Carrier& b) {
+        return a.c < b.c;
+    });
+    for (const Carrier& carrier: carriers) {
+        if (carrier.c < cMin || carrier.c > cMax)
+            continue;
+        crossings(carrier.c, ts);
+        for (std::size_t i = 0; i + 1 < ts.size(); i += 2) {
+            if (!addDash(carrier.c, ts[i], ts[i + 1], carrier.t))
+                return false;
+        }
+    }
+    return true;
+}
+
+void LC_HatchScanline::crossings(double c, std::vector<double>& ts)
+{
+    while (m_next < m_edges.size() && m_edges[m_next].nMin <= c)
+        m_active.push_back(m_next++);
+
+    ts.clear();
+    for (std::size_t i = 0; i < m_active.size();) {
+        const Edge& edge = m_edges[m_active[i]];
+        if (edge.nMax < c) {
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+        addCrossings(edge, c, ts);
+        ++i;
+    }
+    std::sort(ts.begin(), ts.end());
+    // even-odd rule, a dangling crossing can only come from numerical noise
+    if (ts.size() % 2 == 1)
+        ts.pop_back();
+}
+
+void LC_HatchScanline::addCrossings(const Edge& edge, double c, std::vector<double>& ts) const
+{
+    const double n0 = m_normal.dotP(edge.start);
+    const double n1 = m_normal.dotP(edge.end);
+    // a vertex on the carrier belongs to the edge above it, so a contour vertex is counted once
+    const bool crosses = (n0 > c) != (n1 > c);
+
+    std::vector<RS_Vector> roots;
+    switch (edge.entity->rtti()) {
+    case RS2::EntityLine:
+        if (crosses) {
+            const double s = (c - n0) / (n1 - n0);
+            ts.push_back(m_direction.dotP(edge.start + (edge.end - edge.start) * s));
+        }
+        return;
+    case RS2::EntityArc:
+    case RS2::EntityCircle: {
+        const RS_Vector center = edge.entity->getCenter();
+        const double radius = edge.entity->getRadius();
+        const double h = c - m_normal.dotP(center);
+        const double d2 = radius * radius - h * h;
+        if (d2 >= 0.) {
+            const double w = std::sqrt(d2);
+            const double tc = m_direction.dotP(center);
+            for (double t: {tc - w, tc + w}) {
+                const RS_Vector root = m_normal * c + m_direction * t;
+                if (edge.entity->rtti() == RS2::EntityArc) {
+                    auto arc = static_cast<const RS_Arc*>(edge.entity);
+                    if (!RS_Math::isAngleBetween(center.angleTo(root), arc->getAngle1(), arc->getAngle2(),
+                                                 arc->isReversed()))
+                        continue;
+                }
+                roots.push_back(root);
+            }
+        }
+        break;
+    }
+    default: {
+        const RS_Line carrier{m_normal * c + m_direction * (m_tMin - 1.),
+                              m_normal * c + m_direction * (m_tMax + 1.)};
+        for (const RS_Vector& root: RS_Information::getIntersection(&carrier, edge.entity, true)) {
+            if (root.valid)
+                roots.push_back(root);
+        }
+        break;
+    }
+    }
+    addCurveCrossings(roots, edge, crosses, c, ts);
+}
+
+/**
+ * Roots of a curved edge are numerically fuzzy close to its endpoints. A continuous curve crosses the carrier an
+ * odd number of times, only if its endpoints are on different sides, so the root count is corrected by the side
+ * of the endpoints, the same way line edges are counted.
+ */
+void LC_HatchScanline::addCurveCrossings(std::vector<RS_Vector>& roots, const Edge& edge, bool crosses, double c,
+                                         std::vector<double>& ts) const
+{
+    if ((roots.size() % 2 == 1) != crosses) {
+        if (roots.empty()) {
+            // the crossing is an endpoint missed by the root finding
+            const bool startCloser = std::abs(m_normal.dotP(edge.start) - c) < std::abs(m_normal.dotP(edge.end) - c);
+            roots.push_back(startCloser ? edge.start : edge.end);
+        } else {
+            // the endpoint on the carrier is counted by the side it is on, drop its root
+            auto endDistance = [&edge](const RS_Vector& root) {
+                return std::min(root.distanceTo(edge.start), root.distanceTo(edge.end));
+            };
+            roots.erase(std::min_element(roots.begin(), roots.end(),
+                                         [&endDistance](const RS_Vector& a, const RS_Vector& b) {
+                                             return endDistance(a) < endDistance(b);
+                                         }));
+        }
+    }
+    for (const RS_Vector& root: roots)
+        ts.push_back(m_direction.dotP(root));
+}
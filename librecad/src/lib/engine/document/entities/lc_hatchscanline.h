@@ -0,0 +1,95 @@
+/*
+**********************************************************************************
+**
+** This file was created for the LibreCAD project (librecad.org), a 2D CAD program.
+**
+** Copyright (C) 2024 librecad (www.librecad.org)
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**********************************************************************************
+*/
+#ifndef LC_HATCHSCANLINE_H
+#define LC_HATCHSCANLINE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "rs_vector.h"
+
+class RS_Entity;
+class RS_EntityContainer;
+
+/**
+ * @brief The LC_HatchScanline class generates the line part of a hatch pattern clipped to the hatch contour,
+ * without building the pattern carpet first.
+ *
+ * Every line of the pattern tile, repeated over the tile lattice, forms a family of parallel carrier lines.
+ * When the line direction is a lattice direction, all copies on one carrier are a periodic dash sequence and the
+ * carrier is generated once; otherwise each copy is its own carrier. The carriers are visited in the order of
+ * their offset, with the contour edges sorted by their extent across the family (active edge list), and each
+ * carrier is clipped by the even-odd rule against the crossings of the active edges only.
+ * The algorithm works in the contour frame, i.e. the contour is expected to be rotated by the negative hatch
+ * angle, so pattern tiles are axis aligned with a tile at the origin.
+ */
+class LC_HatchScanline {
+public:
+    using Segment = std::pair<RS_Vector, RS_Vector>;
+
+    explicit LC_HatchScanline(const RS_EntityContainer& contour);
+
+    /**
+     * @brief clip - generates the visible pieces of a pattern line family
+     * @param line - the pattern line in tile coordinates
+     * @param tileSize - size of the pattern tile
+     * @param maxSegments - maximum size of the visible segment list
+     * @param visible - visible segments are appended to this list
+     * @return false, if more than maxSegments visible segments would be generated
+     */
+    bool clip(const Segment& line, const RS_Vector& tileSize, std::size_t maxSegments,
+              std::vector<Segment>& visible);
+
+private:
+    struct Edge {
+        const RS_Entity* entity = nullptr;
+        RS_Vector start;
+        RS_Vector end;
+        // extent of the edge across the current line family
+        double nMin = 0.;
+        double nMax = 0.;
+    };
+
+    void addEdges(const RS_EntityContainer& container);
+    void prepareSweep(const RS_Vector& direction);
+    void crossings(double c, std::vector<double>& ts);
+    void addCrossings(const Edge& edge, double c, std::vector<double>& ts) const;
+    void addCurveCrossings(std::vector<RS_Vector>& roots, const Edge& edge, bool crosses, double c,
+                           std::vector<double>& ts) const;
+
+    std::vector<Edge> m_edges;
+    RS_Vector m_min;
+    RS_Vector m_max;
+
+    // sweep state of the current line family
+    RS_Vector m_direction;
+    RS_Vector m_normal;
+    double m_tMin = 0.;
+    double m_tMax = 0.;
+    std::size_t m_next = 0;
+    std::vector<std::size_t> m_active;
+};
+
+#endif // LC_HATCHSCANLINE_H
@@ -278,10 +278,7 @@ RS_VectorSolutions RS_Dimension::getIntersectionsLineContainer(
         }
     }
 
-    /**
-     * We cannot sort the solutions in place because getVector() returns a
-     * const vector, so first construct a copy:
-     */
+    // getVector() returns a copy of the solutions, which is sorted here
     std::vector<RS_Vector> solutions_sorted(solutions_filtered.getVector());
     std::sort(solutions_sorted.begin(), solutions_sorted.end(),
               [l](const RS_Vector& lhs, const RS_Vector& rhs)
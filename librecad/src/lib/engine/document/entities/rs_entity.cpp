@@ -26,6 +26,7 @@
 **********************************************************************/
 
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <utility>
@@ -142,7 +143,8 @@ void RS_Entity::init() {
  * Gives this entity a new unique id.
  */
 void RS_Entity::initId() {
-    static unsigned long long idCounter=0;
+    // entities may be created by worker threads, see LC_ParallelUpdate
+    static std::atomic<unsigned long long> idCounter{0};
     id = idCounter++;
 }
 
@@ -257,6 +259,9 @@ void RS_Entity::undoStateChanged([[maybe_unused]] bool undone)
 {
     setSelected(false);
     update();
+    if (parent != nullptr) {
+        parent->updateSpatialIndex(this);
+    }
 }
 
 /**
@@ -740,9 +745,9 @@ RS_Layer* RS_Entity::getLayer(bool resolve) const {
 void RS_Entity::setLayer(const QString& name) {
     RS_Graphic* graphic = getGraphic();
     if (graphic) {
-        layer = graphic->findLayer(name);
+        setLayer(graphic->findLayer(name));
     } else {
-        layer = nullptr;
+        setLayer(nullptr);
     }
 }
 
@@ -750,7 +755,11 @@ void RS_Entity::setLayer(const QString& name) {
  * Sets the layer of this entity to the layer given.
  */
 void RS_Entity::setLayer(RS_Layer* l) {
+    RS_Layer* previous = layer;
     layer = l;
+    if (parent != nullptr && previous != l) {
+        parent->entityLayerChanged(this, previous);
+    }
 }
 
 /**
@@ -762,9 +771,9 @@ void RS_Entity::setLayerToActive() {
     RS_Graphic* graphic = getGraphic();
 
     if (graphic) {
-        layer = graphic->getActiveLayer();
+        setLayer(graphic->getActiveLayer());
     } else {
-        layer = nullptr;
+        setLayer(nullptr);
     }
 }
 
@@ -773,63 +782,52 @@ RS_Pen RS_Entity::getPenResolved() const {
     // use parental attributes (e.g. vertex of a polyline, block
     // entities when they are drawn in block documents):
     if (parent != nullptr && parent->rtti() != RS2::EntityGraphic) {
-        //if pen is invalid gets all from parent
-        if (!p.isValid()) {
-            p = parent->getPen(false);
-        }
-        //pen is valid, verify byBlock parts
-        RS_EntityContainer *ep = parent;
-        //If parent is byblock check parent.parent (nested blocks)
-        while (p.isColorByBlock()) {
-            if (ep) {
-                p.setColorFromPen(parent->getPen(false)); // fixme - check whether resolved pen is actually needed there...
-                ep = ep->parent;
-            } else
-                break;
-        }
-        ep = parent;
-        while (p.isWidthByBlock()) {
-            if (ep) {
-                p.setWidthFromPen(parent->getPen(false)); // fixme - check whether resolved pen is actually needed there...
-                ep = ep->parent;
-            } else
-                break;
-        }
-        ep = parent;
-        while (p.isLineTypeByBlock()) {
-            if (ep) {
-                p.setLineTypeFromPen(parent->getPen(false)); // fixme - check whether resolved pen is actually needed there...
-                ep = ep->parent;
-            } else
-                break;
-        }
+        resolvePenByBlock(p, parent->getPen(false));
     }
 
     // use layer's color:
-    bool colorByLayer = p.isColorByLayer();
-    bool widthByLayer = p.isWidthByLayer();
-    bool lineByLayer = p.isLineTypeByLayer();
-    if (colorByLayer || widthByLayer || lineByLayer) {
-        RS_Layer *l = getLayerResolved();
-        // check byLayer attributes:
-        if (l != nullptr) {
-            const RS_Pen &layerPen = l->getPen();
-            if (colorByLayer) {
-                p.setColorFromPen(layerPen);
-            }
+    if (p.isColorByLayer() || p.isWidthByLayer() || p.isLineTypeByLayer()) {
+        resolvePenByLayer(p, getLayerResolved());
+    }
+    return p;
+}
 
-            // use layer's width:
-            if (widthByLayer) {
-                p.setWidthFromPen(layerPen);
-            }
+void RS_Entity::resolvePenByBlock(RS_Pen &pen, const RS_Pen &parentPen) {
+    //if pen is invalid gets all from parent
+    if (!pen.isValid()) {
+        pen = parentPen;
+    }
+    //pen is valid, verify byBlock parts
+    if (pen.isColorByBlock()) {
+        pen.setColorFromPen(parentPen); // fixme - check whether resolved pen is actually needed there...
+    }
+    if (pen.isWidthByBlock()) {
+        pen.setWidthFromPen(parentPen);
+    }
+    if (pen.isLineTypeByBlock()) {
+        pen.setLineTypeFromPen(parentPen);
+    }
+}
 
-            // use layer's linetype:
-            if (lineByLayer) {
-                p.setLineTypeFromPen(layerPen);
-            }
-        }
+void RS_Entity::resolvePenByLayer(RS_Pen &pen, const RS_Layer *layer) {
+    // check byLayer attributes:
+    if (layer == nullptr) {
+        return;
+    }
+    const RS_Pen &layerPen = layer->getPen();
+    if (pen.isColorByLayer()) {
+        pen.setColorFromPen(layerPen);
+    }
+
+    // use layer's width:
+    if (pen.isWidthByLayer()) {
+        pen.setWidthFromPen(layerPen);
+    }
+
+    // use layer's linetype:
+    if (pen.isLineTypeByLayer()) {
+        pen.setLineTypeFromPen(layerPen);
     }
-    return p;
 }
 
 /**
@@ -156,6 +156,13 @@ public:
     void setPenToActive();
     RS_Pen getPen(bool resolve = true) const;
     RS_Pen getPenResolved() const;
+    /**
+     * Resolves the attributes of a pen as getPenResolved() does: an invalid pen
+     * and the attributes by block from the unresolved pen of the parent, the
+     * attributes by layer from the resolved layer.
+     */
+    static void resolvePenByBlock(RS_Pen &pen, const RS_Pen &parentPen);
+    static void resolvePenByLayer(RS_Pen &pen, const RS_Layer *layer);
     /**
      * Must be overwritten to return true if an entity type
      * is a container for other entities (e.g. polyline, group, ...).
@@ -32,6 +32,7 @@
 #include <QBrush>
 #include <QString>
 
+#include "lc_hatchscanline.h"
 #include "lc_looputils.h"
 
 #include "rs_arc.h"
@@ -49,6 +50,9 @@
 
 
 namespace{
+// upper limit of generated hatch lines, to avoid huge memory consumption
+    constexpr std::size_t maxHatchSegments = 2000000;
+
 // angular distance corrected for direction and range [0, 2 pi]
     double angularDist(double a, double startAngle, bool reversed) {
         return reversed?
@@ -170,18 +174,13 @@ bool RS_Hatch::isContainer() const {
 }
 
 /**
- * Recalculates the borders of this hatch.
+ * Recalculates the borders of this hatch. Called by regenerate(), so nothing is logged.
  */
 void RS_Hatch::calculateBorders() {
-    RS_DEBUG->print("RS_Hatch::calculateBorders");
-
     activateContour(true);
 
     RS_EntityContainer::calculateBorders();
 
-        RS_DEBUG->print("RS_Hatch::calculateBorders: size: %f,%f",
-                getSize().x, getSize().y);
-
     activateContour(false);
 }
 
@@ -189,7 +188,7 @@ void RS_Hatch::calculateBorders() {
  * Updates the Hatch. Called when the
  * hatch or it's data, position, alignment, .. changes.
  *
- * Refill hatch with pattern. Move, scale, rotate, trim, etc.
+ * Requests the pattern and refills the hatch with it, see regenerate().
  */
 void RS_Hatch::update() {
 
@@ -206,13 +205,45 @@ void RS_Hatch::update() {
         return;
     }
 
+    // search for pattern
+    std::unique_ptr<RS_Pattern> pat;
+    if (!data.solid && !isUndone()) {
+        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: requesting pattern");
+        pat = RS_PATTERNLIST->requestPattern(data.pattern);
+    }
+
+    regenerate(pat.get());
+
+    switch (updateError) {
+        case HATCH_INVALID_CONTOUR:
+            RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: invalid contour in hatch found");
+            break;
+        case HATCH_PATTERN_NOT_FOUND:
+            RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: requesting pattern: %s not found", data.pattern.toUtf8().constData());
+            break;
+        case HATCH_TOO_SMALL:
+            RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size or pattern size too small");
+            break;
+        case HATCH_AREA_TOO_BIG:
+            RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size too large or pattern size too small");
+            break;
+        default:
+            RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: OK");
+            break;
+    }
+}
+
+void RS_Hatch::regenerate(const RS_Pattern* pattern) {
+    updateError = HATCH_OK;
+    if (updateRunning || !updateEnabled) {
+        return;
+    }
+
     if (data.solid==true) {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: processing solid hatch");
         calculateBorders();
         return;
     }
 
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: contour has %d loops", count());
     updateRunning = true;
 
     // save attributes for the current hatch
@@ -226,47 +257,33 @@ void RS_Hatch::update() {
     }
 
     if (isUndone()) {
-        RS_DEBUG->print(RS_Debug::D_NOTICE, "RS_Hatch::update: skip undone hatch");
         updateRunning = false;
         return;
     }
 
     if (!validate()) {
-        RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: invalid contour in hatch found");
         updateRunning = false;
         updateError = HATCH_INVALID_CONTOUR;
         return;
     }
 
-    // search for pattern
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: requesting pattern");
-    std::unique_ptr<RS_Pattern> pat = RS_PATTERNLIST->requestPattern(data.pattern);
-    if (pat == nullptr) {
+    if (pattern == nullptr) {
         updateRunning = false;
-        RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: requesting pattern: %s not found", data.pattern.toUtf8().constData());
         updateError = HATCH_PATTERN_NOT_FOUND;
         return;
-    } else {
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: requesting pattern: OK");
-        // make a working copy of hatch pattern
-        RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: cloning pattern");
-        pat.reset((RS_Pattern*)pat->clone());
-        if (pat != nullptr) {
-            RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: cloning pattern: OK");
-        } else {
-            RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: error while cloning hatch pattern");
-            return;
-        }
     }
+    // make a working copy of hatch pattern
+    std::unique_ptr<RS_Pattern> pat{static_cast<RS_Pattern*>(pattern->clone())};
 
     // scale pattern
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: scaling pattern");
     pat->scale(RS_Vector(0.0,0.0), RS_Vector(data.scale, data.scale));
     pat->calculateBorders();
     forcedCalculateBorders();
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: scaling pattern: OK");
 
-    std::unique_ptr<RS_Hatch> copy {(RS_Hatch*)this->clone()};
+    // a copy of the contour only: clone() would update the copy
+    std::unique_ptr<RS_Hatch> copy{new RS_Hatch(*this)};
+    copy->setOwner(isOwner());
+    copy->detach();
     copy->rotate(RS_Vector(0.0,0.0), -data.angle);
     copy->forcedCalculateBorders();
 
@@ -276,62 +293,35 @@ void RS_Hatch::update() {
 //    RS_Vector cPos = getMin();
     RS_Vector cSize = getSize();
 
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: pattern size: %f/%f", pSize.x, pSize.y);
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: contour size: %f/%f", cSize.x, cSize.y);
-
     // check pattern sizes for sanity
     if (cSize.x<1.0e-6 || cSize.y<1.0e-6 ||
         pSize.x<1.0e-6 || pSize.y<1.0e-6 ||
         cSize.x>RS_MAXDOUBLE-1 || cSize.y>RS_MAXDOUBLE-1 ||
         pSize.x>RS_MAXDOUBLE-1 || pSize.y>RS_MAXDOUBLE-1) {
         updateRunning = false;
-        RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size or pattern size too small");
         updateError = HATCH_TOO_SMALL;
         return;
     }
-        // avoid huge memory consumption:
-    else if ( cSize.x* cSize.y/(pSize.x*pSize.y)>1e4) {
-        RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size too large or pattern size too small");
-        updateError = HATCH_AREA_TOO_BIG;
-        return;
-    }
 
-    // calculate pattern pieces quantity
-    // find out how many pattern-instances we need in x/y:
-    int px1 = (int)floor(copy->getMin().x/pSize.x);
-    int py1 = (int)floor(copy->getMin().y/pSize.y);
-    int px2 = (int)ceil(copy->getMax().x/pSize.x);
-    int py2 = (int)ceil(copy->getMax().y/pSize.y);
-    RS_Vector dvx=RS_Vector(data.angle)*pSize.x;
-    RS_Vector dvy=RS_Vector(data.angle+M_PI*0.5)*pSize.y;
-    pat->rotate(rot_center, data.angle);
-    pat->move(-rot_center);
-
-    RS_EntityContainer tmp;   // container for untrimmed lines
-
-    // adding array of patterns to tmp:
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: creating pattern carpet");
-    for (int px=px1; px<px2; px++) {
-        for (int py=py1; py<py2; py++) {
-            for(auto e: *pat){
-                RS_Entity* te=e->clone();
-                te->move(dvx*px + dvy*py);
-                tmp.addEntity(te);
-            }
+    // line pattern entities are generated per line family by the scanline generator and clipped to the contour,
+    // only the remaining curved entities need the pattern carpet
+    std::vector<LC_HatchScanline::Segment> patternLines;
+    RS_EntityContainer patternCurves;
+    for(auto e: *pat){
+        if (e->rtti() == RS2::EntityLine) {
+            auto* line = static_cast<RS_Line*>(e);
+            patternLines.emplace_back(line->getStartpoint() - rot_center, line->getEndpoint() - rot_center);
+        } else {
+            patternCurves.addEntity(e->clone());
         }
     }
 
-    // clean memory
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: creating pattern carpet: OK");
-
-    // cut pattern to contour shape
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: cutting pattern carpet");
-    // start for very very long for(auto e: tmp) loop
-    RS_EntityContainer tmp2 = trimPattern(tmp);   // container for small cut lines
-    // end for very very long for(auto e: tmp) loop
-
-    // updating hatch / adding entities that are inside
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: cutting pattern carpet: OK");
+    // avoid huge memory consumption:
+    if (!patternCurves.isEmpty() && cSize.x* cSize.y/(pSize.x*pSize.y)>1e4) {
+        updateRunning = false;
+        updateError = HATCH_AREA_TOO_BIG;
+        return;
+    }
 
     // add the hatch pattern entities
     hatch = new RS_EntityContainer(this);
@@ -339,40 +329,89 @@ void RS_Hatch::update() {
     hatch->setLayer(hatch_layer);
     hatch->setFlag(RS2::FlagTemp);
 
-    //calculateBorders();
-    for(auto e: tmp2){
+    auto addHatchEntity = [&](RS_Entity* te) {
+        te->setPen(hatch_pen);
+        te->setLayer(hatch_layer);
+        te->reparent(hatch);
+        te->setFlag(RS2::FlagHatchChild);
+        hatch->addEntity(te);
+    };
+
+    // the copy is rotated by -angle, so pattern tiles are axis aligned in its frame
+    LC_HatchScanline scanline(*copy);
+    std::vector<LC_HatchScanline::Segment> segments;
+    for (const LC_HatchScanline::Segment& line: patternLines) {
+        if (!scanline.clip(line, pSize, maxHatchSegments, segments)) {
+            delete hatch;
+            hatch = nullptr;
+            updateRunning = false;
+            updateError = HATCH_AREA_TOO_BIG;
+            return;
+        }
+    }
+    for (LC_HatchScanline::Segment& segment: segments) {
+        segment.first.rotate(data.angle);
+        segment.second.rotate(data.angle);
+        addHatchEntity(new RS_Line(hatch, segment.first, segment.second));
+    }
 
-        RS_Vector middlePoint;
-        RS_Vector middlePoint2;
-        if (e->rtti()==RS2::EntityLine) {
-            auto* line = static_cast<RS_Line*>(e);
-            middlePoint = line->getMiddlePoint();
-            middlePoint2 = line->getNearestDist(line->getLength()/2.1,
-                                                line->getStartpoint());
-        } else if (e->rtti()==RS2::EntityArc) {
-            auto* arc = static_cast<RS_Arc*>(e);
-            middlePoint = arc->getMiddlePoint();
-            middlePoint2 = arc->getNearestDist(arc->getLength()/2.1,
-                                               arc->getStartpoint());
-        } else {
-            middlePoint = RS_Vector{false};
-            middlePoint2 = RS_Vector{false};
+    if (!patternCurves.isEmpty()) {
+        // calculate pattern pieces quantity
+        // find out how many pattern-instances we need in x/y:
+        int px1 = (int)floor(copy->getMin().x/pSize.x);
+        int py1 = (int)floor(copy->getMin().y/pSize.y);
+        int px2 = (int)ceil(copy->getMax().x/pSize.x);
+        int py2 = (int)ceil(copy->getMax().y/pSize.y);
+        RS_Vector dvx=RS_Vector(data.angle)*pSize.x;
+        RS_Vector dvy=RS_Vector(data.angle+M_PI*0.5)*pSize.y;
+        patternCurves.rotate(rot_center, data.angle);
+        patternCurves.move(-rot_center);
+
+        RS_EntityContainer tmp;   // container for untrimmed curves
+
+        // adding array of patterns to tmp:
+        for (int px=px1; px<px2; px++) {
+            for (int py=py1; py<py2; py++) {
+                for(auto e: patternCurves){
+                    RS_Entity* te=e->clone();
+                    te->move(dvx*px + dvy*py);
+                    tmp.addEntity(te);
+                }
+            }
         }
 
-        if (middlePoint.valid) {
-            bool onContour=false;
+        // cut pattern to contour shape
+        RS_EntityContainer tmp2 = trimPattern(tmp);   // container for small cut curves
+
+        // updating hatch / adding entities that are inside
+        for(auto e: tmp2){
+
+            RS_Vector middlePoint;
+            RS_Vector middlePoint2;
+            if (e->rtti()==RS2::EntityLine) {
+                auto* line = static_cast<RS_Line*>(e);
+                middlePoint = line->getMiddlePoint();
+                middlePoint2 = line->getNearestDist(line->getLength()/2.1,
+                                                    line->getStartpoint());
+            } else if (e->rtti()==RS2::EntityArc) {
+                auto* arc = static_cast<RS_Arc*>(e);
+                middlePoint = arc->getMiddlePoint();
+                middlePoint2 = arc->getNearestDist(arc->getLength()/2.1,
+                                                   arc->getStartpoint());
+            } else {
+                middlePoint = RS_Vector{false};
+                middlePoint2 = RS_Vector{false};
+            }
 
-            if (RS_Information::isPointInsideContour(
-                middlePoint,
-                this, &onContour) ||
-                RS_Information::isPointInsideContour(middlePoint2, this)) {
+            if (middlePoint.valid) {
+                bool onContour=false;
 
-                RS_Entity* te = e->clone();
-                te->setPen(hatch_pen);
-                te->setLayer(hatch_layer);
-                te->reparent(hatch);
-                te->setFlag(RS2::FlagHatchChild);
-                hatch->addEntity(te);
+                if (RS_Information::isPointInsideContour(
+                    middlePoint,
+                    this, &onContour) ||
+                    RS_Information::isPointInsideContour(middlePoint2, this)) {
+                    addHatchEntity(e->clone());
+                }
             }
         }
     }
@@ -388,17 +427,14 @@ void RS_Hatch::update() {
     updateRunning = false;
     m_updated = true;
 
-    RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: OK");
 }
 
 RS_EntityContainer RS_Hatch::trimPattern(const RS_EntityContainer& patternEntities) const
 {
-    LC_LOG<<"RS_Hatch::"<<__func__<<": begin";
     RS_EntityContainer trimmed;
     for(auto* e: patternEntities) {
 
         if (!e) {
-            RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Hatch::update: nullptr entity found");
             continue;
         }
 
@@ -457,7 +493,6 @@ RS_EntityContainer RS_Hatch::trimPattern(const RS_EntityContainer& patternEntiti
                     for (const RS_Vector& vp: sol) {
                         if (vp.valid) {
                             is.append(vp);
-                            RS_DEBUG->print(RS_Debug::D_DEBUGGING, "  pattern line intersection: %f/%f", vp.x, vp.y);
                         }
                     }
                 }
@@ -542,7 +577,6 @@ RS_EntityContainer RS_Hatch::trimPattern(const RS_EntityContainer& patternEntiti
             }
         }
     }
-    LC_LOG<<"RS_Hatch::"<<__func__<<": done";
     return trimmed;
 }
 
@@ -550,22 +584,11 @@ RS_EntityContainer RS_Hatch::trimPattern(const RS_EntityContainer& patternEntiti
  * Activates of deactivates the hatch boundary.
  */
 void RS_Hatch::activateContour(bool on) {
-    RS_DEBUG->print("RS_Hatch::activateContour: %d", (int)on);
-        foreach(auto* e, entities){
-            if (!e->isUndone()) {
-                if (!e->getFlag(RS2::FlagTemp)) {
-                    RS_DEBUG->print("RS_Hatch::activateContour: set visible");
-                    e->setVisible(on);
-                }
-                else {
-                    RS_DEBUG->print("RS_Hatch::activateContour: entity temp");
-                }
-            }
-            else {
-                RS_DEBUG->print("RS_Hatch::activateContour: entity undone");
-            }
+    foreach(auto* e, entities){
+        if (!e->isUndone() && !e->getFlag(RS2::FlagTemp)) {
+            e->setVisible(on);
         }
-    RS_DEBUG->print("RS_Hatch::activateContour: OK");
+    }
 }
 
 /**
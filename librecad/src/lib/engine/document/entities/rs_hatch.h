@@ -60,6 +60,7 @@ struct RS_HatchData {
 std::ostream& operator << (std::ostream& os, const RS_HatchData& td);
 
 class QPainterPath;
+class RS_Pattern;
 
 /**
  * Class for a hatch entity.
@@ -134,6 +135,13 @@ public:
 
     void calculateBorders() override;
     void update() override;
+    /**
+     * Refills the hatch with a pattern, which is copied. Unlike update(), the pattern
+     * isn't requested from the pattern list and nothing is logged, so hatches may be
+     * regenerated by worker threads, see LC_ParallelUpdate. Errors are kept by
+     * getUpdateError(); a missing pattern is HATCH_PATTERN_NOT_FOUND.
+     */
+    void regenerate(const RS_Pattern* pattern);
     int getUpdateError() {
             return updateError;
     }
@@ -23,11 +23,14 @@
 ** This copyright notice MUST APPEAR in all copies of the script!
 **
 **********************************************************************/
-#include<iostream>
+#include <algorithm>
+#include <iostream>
+
 #include <QDir>
 #include <QFileInfo>
 #include <QImage>
 
+#include "lc_imagecache.h"
 #include "rs_debug.h"
 #include "rs_document.h"
 #include "rs_graphicview.h"
@@ -119,9 +122,9 @@ void RS_Image::update() {
     // the whole image:
     QString filePathName = imageRelativePathName(data.file);
 
-    //QImage image = QImage(data.file);
-    img = std::make_shared<QImage>(filePathName);
-    if (!img->isNull()) {
+    // decoded once for all images showing the same file
+    img = LC_IMAGECACHE->find(filePathName);
+    if (img != nullptr) {
         data.size = RS_Vector(img->width(), img->height());
         calculateBorders(); // image update need this.
     } else {
@@ -360,10 +363,23 @@ void RS_Image::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2)
 }
 
 void RS_Image::draw(RS_Painter* painter) {
-    if (!img.get() || img->isNull()) {
+    if (img == nullptr) {
         return;
     }
-    painter->drawImgWCS(*img, data.insertionPoint, data.uVector, data.vVector);
+    QImage image;
+    RS_Vector uVector = data.uVector;
+    RS_Vector vVector = data.vVector;
+    if (painter->isPrinting() || painter->isPrintPreview()) {
+        image = img->image();
+    } else {
+        // draw the level of the image pyramid matching the zoom
+        double scale = std::min(painter->toGuiDX(data.uVector.magnitude()),
+                                painter->toGuiDX(data.vVector.magnitude()));
+        image = img->level(scale);
+        uVector *= double(img->width()) / image.width();
+        vVector *= double(img->height()) / image.height();
+    }
+    painter->drawImgWCS(image, data.insertionPoint, uVector, vVector);
 
     if (isSelected() && !(painter->isPrinting() || painter->isPrintPreview())) {
         RS_VectorSolutions sol = getCorners();
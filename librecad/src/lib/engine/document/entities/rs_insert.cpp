@@ -26,6 +26,7 @@
 
 #include "rs_insert.h"
 
+#include<algorithm>
 #include<cmath>
 #include<iostream>
 
@@ -37,6 +38,7 @@
 #include "rs_graphic.h"
 #include "rs_layer.h"
 #include "rs_math.h"
+#include "rs_painter.h"
 
 namespace {
 
@@ -130,6 +132,7 @@ void RS_Insert::update() {
         }
 
     clear();
+    deferredEntities = false;
 
     RS_Block* blk = getBlockForInsert();
     if (blk == nullptr) {
@@ -147,11 +150,38 @@ void RS_Insert::update() {
         return;
     }
 
-    RS_DEBUG->print("RS_Insert::update: cols: %d, rows: %d",
+    if (isDeferrable()) {
+        // the borders are found from the block, sub-inserts of the block must be
+        // up to date for that
+        for (RS_Entity* e: *blk) {
+            if (e->rtti() == RS2::EntityInsert) {
+                e->update();
+            }
+        }
+        RS_DEBUG->print("RS_Insert::update: deferred %d entities", blk->count());
+        deferredEntities = true;
+        calculateBorders();
+        return;
+    }
+
+    createEntities(blk);
+    calculateBorders();
+
+    RS_DEBUG->print("RS_Insert::update: OK");
+}
+
+/**
+ * Creates the entities of this insert as transformed copies of the
+ * entities of the block.
+ */
+void RS_Insert::createEntities(RS_Block* blk) {
+    RS_DEBUG->print("RS_Insert::createEntities: cols: %d, rows: %d",
                     data.cols, data.rows);
-    RS_DEBUG->print("RS_Insert::update: block has %d entities",
+    RS_DEBUG->print("RS_Insert::createEntities: block has %d entities",
                     blk->count());
+    const CopyAttributes attributes = getAttributes();
         for(auto* e: *blk){
+            const CopyAttributes copyAttributes = getCopyAttributes(e, attributes);
             for (int c=0; c<data.cols; ++c) {
 //            RS_DEBUG->print("RS_Insert::update: col %d", c);
                 for (int r=0; r<data.rows; ++r) {
@@ -191,10 +221,9 @@ void RS_Insert::update() {
                     }
                     ne->initId();
                     ne->setUpdateEnabled(false);
-                // if entity layer are 0 set to insert layer to allow "1 layer control" bug ID #3602152
-                    RS_Layer *l= ne->getLayer();//special fontchar block don't have
-                    if (l != nullptr  && ne->getLayer()->getName() == "0")
-                    ne->setLayer(getLayer());
+                    if (copyAttributes.layer != ne->getLayer(false)) {
+                        ne->setLayer(copyAttributes.layer);
+                    }
                     ne->setParent(this);
                     ne->setVisible(getFlag(RS2::FlagVisible));
 
@@ -224,13 +253,10 @@ void RS_Insert::update() {
                    // RS_DEBUG->print(RS_Debug::D_ERROR, "ne: angle: %lg\n", data.angle);
                 // Select:
                     ne->setSelected(isSelected());
+                    ne->setHighlighted(isHighlighted());
 
                 // individual entities can be on indiv. layers
-                    RS_Pen tmpPen = updatePen(ne->getPen(false), getPen());
-                // now that we've evaluated all flags, let's strip them:
-                // TODO: strip all flags (width, line type)
-                //tmpPen.setColor(tmpPen.getColor().stripFlags());
-                    ne->setPen(tmpPen);
+                    ne->setPen(copyAttributes.pen);
 
                     ne->setUpdateEnabled(true);
 
@@ -247,12 +273,136 @@ void RS_Insert::update() {
                 }
             }
         }
-        calculateBorders();
+}
 
-        RS_DEBUG->print("RS_Insert::update: OK");
+
+
+/**
+ * Creates the deferred entities of this insert on their first access.
+ */
+void RS_Insert::materializeEntities() const {
+    RS_Block* blk = getBlockForInsert();
+    if (blk == nullptr) {
+        return;
+    }
+    RS_DEBUG->print("RS_Insert::materializeEntities: name: %s", data.name.toLatin1().data());
+    auto* self = const_cast<RS_Insert*>(this);
+    self->createEntities(blk);
+    self->calculateBorders();
 }
 
+/**
+ * Recalculates the borders. Without entities, the borders are the
+ * transformed borders of the block. Those contain the entities, but may be
+ * larger for rotated inserts.
+ */
+void RS_Insert::calculateBorders() {
+    if (!hasDeferredEntities()) {
+        RS_EntityContainer::calculateBorders();
+        return;
+    }
 
+    resetBorders();
+    RS_Block* blk = getBlockForInsert();
+    if (blk == nullptr || data.cols < 1 || data.rows < 1) {
+        return;
+    }
+
+    RS_Vector blockMin{RS_MAXDOUBLE, RS_MAXDOUBLE};
+    RS_Vector blockMax{RS_MINDOUBLE, RS_MINDOUBLE};
+    for (RS_Entity* e: *blk) {
+        blockMin = RS_Vector::minimum(blockMin, e->getMin());
+        blockMax = RS_Vector::maximum(blockMax, e->getMax());
+    }
+    if (blockMin.x > blockMax.x || blockMin.y > blockMax.y) {
+        return;
+    }
+
+    // the transformation is affine: the corners of the first and the last
+    // copy in the array bound all copies
+    const RS_Vector basePoint = blk->getBasePoint();
+    const RS_Vector corners[] = {blockMin, {blockMin.x, blockMax.y}, blockMax, {blockMax.x, blockMin.y}};
+    for (int c: {0, data.cols - 1}) {
+        for (int r: {0, data.rows - 1}) {
+            for (const RS_Vector& corner: corners) {
+                RS_Vector v = toInsertCoordinates(corner, basePoint, c, r);
+                minV = RS_Vector::minimum(minV, v);
+                maxV = RS_Vector::maximum(maxV, v);
+            }
+        }
+    }
+}
+
+bool RS_Insert::isDeferrable() const {
+    return data.updateMode != RS2::PreviewUpdate && data.blockSource == nullptr
+           && getParent() != nullptr && getParent()->isDocument();
+}
+
+bool RS_Insert::isSnappedInBlock() const {
+    return hasDeferredEntities()
+           && RS_Math::equal(std::abs(data.scaleFactor.x), std::abs(data.scaleFactor.y));
+}
+
+/**
+ * @return the position of a block point in the copy at col/row, transformed
+ *  as the entities by createEntities()
+ */
+RS_Vector RS_Insert::toInsertCoordinates(const RS_Vector& blockPoint, const RS_Vector& basePoint,
+                                         int col, int row) const {
+    RS_Vector v = blockPoint + data.insertionPoint
+                  + RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+                              data.spacing.y/data.scaleFactor.y*row)
+                  - basePoint;
+    v.scale(data.insertionPoint, data.scaleFactor);
+    v.rotate(data.insertionPoint, data.angle);
+    return v;
+}
+
+/**
+ * @return the position in the block of a point of the copy at col/row,
+ *  the inverse of toInsertCoordinates()
+ */
+RS_Vector RS_Insert::toBlockCoordinates(const RS_Vector& insertPoint, const RS_Vector& basePoint,
+                                        int col, int row) const {
+    RS_Vector v = insertPoint;
+    v.rotate(data.insertionPoint, -data.angle);
+    v.scale(data.insertionPoint, RS_Vector(1./data.scaleFactor.x, 1./data.scaleFactor.y));
+    return v - data.insertionPoint
+           - RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+                       data.spacing.y/data.scaleFactor.y*row)
+           + basePoint;
+}
+
+/**
+ * Finds the point nearest to 'coord' in all copies of the block, by a query
+ * of the block in block coordinates.
+ *
+ * @param dist the distance of the point found, scaled to the insert
+ */
+RS_Vector RS_Insert::getNearestInBlock(const RS_Vector& coord, double* dist,
+                                       const std::function<RS_Vector(const RS_Block*, const RS_Vector&, double*)>& query) const {
+    RS_Vector closestPoint(false);
+    double minDist = RS_MAXDOUBLE;
+    RS_Block* blk = getBlockForInsert();
+    if (blk != nullptr) {
+        const RS_Vector basePoint = blk->getBasePoint();
+        const double scale = std::abs(data.scaleFactor.x);
+        for (int c = 0; c < data.cols; ++c) {
+            for (int r = 0; r < data.rows; ++r) {
+                double curDist = RS_MAXDOUBLE;
+                RS_Vector point = query(blk, toBlockCoordinates(coord, basePoint, c, r), &curDist);
+                if (point.valid && curDist * scale < minDist) {
+                    minDist = curDist * scale;
+                    closestPoint = toInsertCoordinates(point, basePoint, c, r);
+                }
+            }
+        }
+    }
+    if (dist != nullptr) {
+        *dist = minDist;
+    }
+    return closestPoint;
+}
 
 /**
  * @return Pointer to the block associated with this Insert or
@@ -311,6 +461,93 @@ bool RS_Insert::isVisible() const
 }
 
 
+RS_Insert::CopyAttributes RS_Insert::getAttributes() const {
+    return {getPen(false), getLayer(false), getPenResolved(), getLayerResolved(), getFlag(RS2::FlagVisible)};
+}
+
+RS_Insert::CopyAttributes RS_Insert::getCopyAttributes(const RS_Entity* blockEntity,
+                                                       const CopyAttributes& insertAttributes) const {
+    CopyAttributes copy;
+    copy.visible = insertAttributes.visible;
+    RS_Pen parentPen;
+    const RS_EntityContainer* parent = blockEntity->getParent();
+    if (parent == nullptr || parent == getBlockForInsert()) {
+        // if entity layer are 0 set to insert layer to allow "1 layer control" bug ID #3602152
+        RS_Layer* l = blockEntity->getLayer(); //special fontchar block don't have
+        copy.layer = (l != nullptr && l->getName() == "0") ? insertAttributes.layerResolved
+                                                           : blockEntity->getLayer(false);
+        copy.layerResolved = copy.layer != nullptr ? copy.layer : insertAttributes.layerResolved;
+        copy.pen = updatePen(blockEntity->getPen(false), insertAttributes.penResolved);
+        parentPen = insertAttributes.pen;
+    } else {
+        // sub-entities of block entities are cloned with their container
+        const CopyAttributes parentCopy = getCopyAttributes(parent, insertAttributes);
+        copy.layer = blockEntity->getLayer(false);
+        copy.layerResolved = copy.layer != nullptr ? copy.layer : parentCopy.layerResolved;
+        copy.pen = blockEntity->getPen(false);
+        parentPen = parentCopy.pen;
+    }
+    // the parent of the copy is the insert or a copy, as in RS_Entity::getPenResolved()
+    copy.penResolved = copy.pen;
+    RS_Entity::resolvePenByBlock(copy.penResolved, parentPen);
+    RS_Entity::resolvePenByLayer(copy.penResolved, copy.layerResolved);
+    return copy;
+}
+
+bool RS_Insert::CopyAttributes::isVisible(const RS_Entity* blockEntity) const {
+    if (!visible || blockEntity->isUndone()) {
+        return false;
+    }
+    if (blockEntity->rtti() == RS2::EntityInsert) {
+        RS_Block* blk = static_cast<const RS_Insert*>(blockEntity)->getBlockForInsert();
+        if (blk != nullptr && blk->isFrozen()) {
+            return false;
+        }
+    }
+    return layerResolved == nullptr || !layerResolved->isFrozen();
+}
+
+bool RS_Insert::CopyAttributes::isPrint() const {
+    return layer == nullptr || layer->isPrint();
+}
+
+bool RS_Insert::CopyAttributes::isConstruction(const RS_Entity* blockEntity) const {
+    // Issue #1773, hatch filling curves are not shown as infinite on construction layers
+    return !blockEntity->getFlag(RS2::FlagHatchChild) && layer != nullptr && layer->isConstruction();
+}
+
+unsigned RS_Insert::count() const {
+    if (!hasDeferredEntities()) {
+        return RS_EntityContainer::count();
+    }
+    RS_Block* blk = getBlockForInsert();
+    return blk != nullptr ? blk->count() * data.cols * data.rows : 0;
+}
+
+unsigned RS_Insert::countDeep() const {
+    if (!hasDeferredEntities()) {
+        return RS_EntityContainer::countDeep();
+    }
+    RS_Block* blk = getBlockForInsert();
+    return blk != nullptr ? blk->countDeep() * data.cols * data.rows : 0;
+}
+
+double RS_Insert::getLength() const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getLength();
+    }
+    RS_Block* blk = getBlockForInsert();
+    if (blk == nullptr) {
+        return 0.;
+    }
+    double length = blk->getLength();
+    if (length < 0.) {
+        return length;
+    }
+    return length * std::abs(data.scaleFactor.x) * data.cols * data.rows;
+}
+
+
 RS_VectorSolutions RS_Insert::getRefPoints() const
 {
 	return RS_VectorSolutions{data.insertionPoint};
@@ -324,6 +561,121 @@ RS_Vector RS_Insert::getNearestRef(const RS_Vector& coord,
         return getRefPoints().getClosest(coord, dist);
 }
 
+/**
+ * The reference points of a selected insert are the ones of the insert, not the
+ * ones of its entities, as drawn.
+ */
+RS_Vector RS_Insert::getNearestSelectedRef(const RS_Vector& coord,
+                                           double* dist) const{
+    return RS_Entity::getNearestSelectedRef(coord, dist);
+}
+
+RS_Vector RS_Insert::getNearestEndpoint(const RS_Vector& coord,
+                                        double* dist) const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getNearestEndpoint(coord, dist);
+    }
+    return getNearestInBlock(coord, dist, [](const RS_Block* blk, const RS_Vector& blockCoord, double* blockDist) {
+        return blk->getNearestEndpoint(blockCoord, blockDist);
+    });
+}
+
+/**
+ * @param entity the insert itself, if the block is snapped, as there are no sub-entities
+ */
+RS_Vector RS_Insert::getNearestPointOnEntity(const RS_Vector& coord,
+                                             bool onEntity, double* dist, RS_Entity** entity) const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getNearestPointOnEntity(coord, onEntity, dist, entity);
+    }
+    if (entity != nullptr) {
+        *entity = const_cast<RS_Insert*>(this);
+    }
+    return getNearestInBlock(coord, dist, [onEntity](const RS_Block* blk, const RS_Vector& blockCoord, double* blockDist) {
+        return blk->getNearestPointOnEntity(blockCoord, onEntity, blockDist);
+    });
+}
+
+RS_Vector RS_Insert::getNearestCenter(const RS_Vector& coord,
+                                      double* dist) const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getNearestCenter(coord, dist);
+    }
+    return getNearestInBlock(coord, dist, [](const RS_Block* blk, const RS_Vector& blockCoord, double* blockDist) {
+        return blk->getNearestCenter(blockCoord, blockDist);
+    });
+}
+
+RS_Vector RS_Insert::getNearestMiddle(const RS_Vector& coord,
+                                      double* dist, int middlePoints) const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getNearestMiddle(coord, dist, middlePoints);
+    }
+    return getNearestInBlock(coord, dist, [middlePoints](const RS_Block* blk, const RS_Vector& blockCoord, double* blockDist) {
+        return blk->getNearestMiddle(blockCoord, blockDist, middlePoints);
+    });
+}
+
+RS_Vector RS_Insert::getNearestDist(double distance,
+                                    const RS_Vector& coord, double* dist) const {
+    if (!isSnappedInBlock()) {
+        return RS_EntityContainer::getNearestDist(distance, coord, dist);
+    }
+    const double blockDistance = distance / std::abs(data.scaleFactor.x);
+    return getNearestInBlock(coord, dist, [blockDistance](const RS_Block* blk, const RS_Vector& blockCoord, double* blockDist) {
+        return blk->getNearestDist(blockDistance, blockCoord, blockDist);
+    });
+}
+
+/**
+ * Unresolved, the distance is found in the block, and the entity is the
+ * insert itself. Resolved, the sub-entities are created for the entity found.
+ */
+double RS_Insert::getDistanceToPoint(const RS_Vector& coord, RS_Entity** entity,
+                                     RS2::ResolveLevel level, double solidDist) const {
+    if (level != RS2::ResolveNone || !isSnappedInBlock()) {
+        return RS_EntityContainer::getDistanceToPoint(coord, entity, level, solidDist);
+    }
+    if (entity != nullptr) {
+        *entity = const_cast<RS_Insert*>(this);
+    }
+    double minDist = RS_MAXDOUBLE;
+    RS_Block* blk = getBlockForInsert();
+    if (blk == nullptr) {
+        return minDist;
+    }
+    const RS_Vector basePoint = blk->getBasePoint();
+    const double scale = std::abs(data.scaleFactor.x);
+    for (int c = 0; c < data.cols; ++c) {
+        for (int r = 0; r < data.rows; ++r) {
+            double blockDist = blk->getDistanceToPoint(toBlockCoordinates(coord, basePoint, c, r), nullptr,
+                                                       RS2::ResolveNone, solidDist / scale);
+            minDist = std::min(minDist, blockDist * scale);
+        }
+    }
+    return minDist;
+}
+
+/**
+ * Inserts without entities draw the entities of the block through the
+ * transformation of each copy.
+ */
+void RS_Insert::draw(RS_Painter* painter) {
+    if (hasDeferredEntities()) {
+        painter->drawInsertBlock(this);
+    } else {
+        RS_EntityContainer::draw(painter);
+    }
+}
+
+void RS_Insert::drawAsChild(RS_Painter* painter) {
+    if (hasDeferredEntities()) {
+        painter->drawInsertBlock(this);
+    } else {
+        RS_EntityContainer::drawAsChild(painter);
+    }
+}
+
 
 
 void RS_Insert::move(const RS_Vector& offset) {
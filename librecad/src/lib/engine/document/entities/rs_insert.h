@@ -28,7 +28,10 @@
 #ifndef RS_INSERT_H
 #define RS_INSERT_H
 
+#include <functional>
+
 #include "rs_entitycontainer.h"
+#include "rs_pen.h"
 
 class RS_BlockList;
 
@@ -85,6 +88,9 @@ std::ostream& operator << (std::ostream& os, const RS_InsertData& d);
  * Inserts don't really contain other entities internally. They just
  * refer to a block. However, to the outside world they act exactly
  * like EntityContainer.
+ * Inserts of documents create their entities on the first access only,
+ * until then the borders are found from the block, and the entities of the
+ * block are drawn and snapped through the transformation of the insert.
  *
  * @author Andrew Mustun
  */
@@ -116,6 +122,7 @@ public:
 	RS_Block* getBlockForInsert() const;
 
     void update() override;
+    void calculateBorders() override;
 
     QString getName() const {
         return data.name;
@@ -174,12 +181,75 @@ public:
 
     bool isVisible() const override;
 
+    /**
+     * The attributes of the copy of an entity of the block, as createEntities()
+     * sets them. Entities of blocks drawn without copies take them from here.
+     */
+    struct CopyAttributes {
+        //! the pen and the layer of the copy, not resolved
+        RS_Pen pen;
+        RS_Layer* layer = nullptr;
+        RS_Pen penResolved;
+        RS_Layer* layerResolved = nullptr;
+        //! the visibility flag of the copy, which is the one of the insert
+        bool visible = true;
+
+        //! as RS_Entity::isVisible() of the copy of the given block entity
+        bool isVisible(const RS_Entity* blockEntity) const;
+        //! as RS_Entity::isPrint() of the copy
+        bool isPrint() const;
+        //! as RS_Entity::isConstruction() of the copy of the given block entity
+        bool isConstruction(const RS_Entity* blockEntity) const;
+    };
+    /**
+     * @return the attributes of this insert
+     */
+    CopyAttributes getAttributes() const;
+    /**
+     * @param blockEntity an entity of the block, or a sub-entity of one
+     * @param insertAttributes the attributes of this insert, or of its copy if
+     * it is an entity of another block
+     * @return the attributes of the copy of the block entity
+     */
+    CopyAttributes getCopyAttributes(const RS_Entity* blockEntity, const CopyAttributes& insertAttributes) const;
+
+    unsigned count() const override;
+    unsigned countDeep() const override;
+    double getLength() const override;
+
     RS_VectorSolutions getRefPoints() const override;
     RS_Vector getMiddlePoint(void) const  override{
         return {};
     }
     RS_Vector getNearestRef(const RS_Vector& coord,
                             double* dist = nullptr) const override;
+    RS_Vector getNearestSelectedRef(const RS_Vector& coord,
+                                    double* dist = nullptr) const override;
+
+    RS_Vector getNearestEndpoint(const RS_Vector& coord,
+                                 double* dist = nullptr) const override;
+    RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
+                                      bool onEntity = true,
+                                      double* dist = nullptr,
+                                      RS_Entity** entity = nullptr) const override;
+    RS_Vector getNearestCenter(const RS_Vector& coord,
+                               double* dist = nullptr) const override;
+    RS_Vector getNearestMiddle(const RS_Vector& coord,
+                               double* dist = nullptr,
+                               int middlePoints = 1) const override;
+    RS_Vector getNearestDist(double distance,
+                             const RS_Vector& coord,
+                             double* dist = nullptr) const override;
+    double getDistanceToPoint(const RS_Vector& coord,
+                              RS_Entity** entity,
+                              RS2::ResolveLevel level = RS2::ResolveNone,
+                              double solidDist = RS_MAXDOUBLE) const override;
+
+    void draw(RS_Painter* painter) override;
+    void drawAsChild(RS_Painter* painter) override;
+
+    RS_Vector toInsertCoordinates(const RS_Vector& blockPoint, const RS_Vector& basePoint, int col, int row) const;
+    RS_Vector toBlockCoordinates(const RS_Vector& insertPoint, const RS_Vector& basePoint, int col, int row) const;
 
     void move(const RS_Vector& offset) override;
     void rotate(const RS_Vector& center, double angle) override;
@@ -190,8 +260,26 @@ public:
     friend std::ostream& operator << (std::ostream& os, const RS_Insert& i);
 
 protected:
+    void materializeEntities() const override;
+
     RS_InsertData data{};
     mutable RS_Block* block = nullptr;
+
+private:
+    /**
+     * @return true, if the sub-entities may be created on demand. Only
+     * inserts of documents defer, previews and font letters don't.
+     */
+    bool isDeferrable() const;
+    /**
+     * @return true, if the block is snapped instead of the entities. The
+     * distances in the block are proportional to the distances of the
+     * entities, if the scale is the same in x and y.
+     */
+    bool isSnappedInBlock() const;
+    RS_Vector getNearestInBlock(const RS_Vector& coord, double* dist,
+                                const std::function<RS_Vector(const RS_Block*, const RS_Vector&, double*)>& query) const;
+    void createEntities(RS_Block* blk);
 };
 
 
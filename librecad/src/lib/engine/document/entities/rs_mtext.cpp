@@ -32,7 +32,6 @@
 #include "rs_debug.h"
 #include "rs_font.h"
 #include "rs_fontlist.h"
-#include "rs_insert.h"
 #include "rs_math.h"
 #include "rs_line.h"
 #include "rs_painter.h"
@@ -49,6 +48,8 @@ RS_MText::LC_TextLine *RS_MText::LC_TextLine::clone() const {
     }
     ec->detach();
     ec->initId();
+    ec->glyphRun = glyphRun;
+    ec->deferredEntities = deferredEntities;
     ec->setTextSize(textSize);
     ec->setLeftBottomCorner(leftBottomCorner);
     ec->setBaselineStart(baselineStart);
@@ -56,6 +57,101 @@ RS_MText::LC_TextLine *RS_MText::LC_TextLine::clone() const {
     return ec;
 }
 
+void RS_MText::LC_TextLine::addGlyph(RS_Font *font, const LC_FontGlyph &glyph, const RS_Vector &position) {
+    glyphRun.add(font, glyph, position);
+    deferredEntities = !glyphRun.isEmpty();
+}
+
+/**
+ * Creates the letters as inserts on the first access to the sub-entities.
+ * The borders are then found from the letters and the super and sub texts.
+ */
+void RS_MText::LC_TextLine::materializeEntities() const {
+    auto *self = const_cast<LC_TextLine *>(this);
+    glyphRun.createLetters(self);
+    self->forcedCalculateBorders();
+}
+
+void RS_MText::LC_TextLine::calculateBorders() {
+    if (!hasDeferredEntities()) {
+        RS_EntityContainer::calculateBorders();
+        return;
+    }
+
+    const RS_Vector previousMin = minV;
+    const RS_Vector previousMax = maxV;
+    resetBorders();
+    // the super and sub texts
+    for (RS_Entity *e: std::as_const(entities)) {
+        e->calculateBorders();
+        adjustBorders(e);
+    }
+    glyphRun.extendBorders(minV, maxV);
+    // letters without extent, as an empty container
+    if (minV.x > maxV.x || minV.y > maxV.y) {
+        minV = RS_Vector(0.0, 0.0);
+        maxV = RS_Vector(0.0, 0.0);
+    }
+    updateInParent(previousMin, previousMax);
+}
+
+unsigned RS_MText::LC_TextLine::count() const {
+    if (!hasDeferredEntities()) {
+        return RS_EntityContainer::count();
+    }
+    return static_cast<unsigned>(entities.size() + glyphRun.size());
+}
+
+/**
+ * Without letters, the distance to the line itself is found from the glyph
+ * outlines and the super and sub texts.
+ */
+double RS_MText::LC_TextLine::getDistanceToPoint(const RS_Vector &coord, RS_Entity **entity,
+                                                 RS2::ResolveLevel level, double solidDist) const {
+    if (level != RS2::ResolveNone || !hasDeferredEntities()) {
+        return RS_EntityContainer::getDistanceToPoint(coord, entity, level, solidDist);
+    }
+    double minDist = glyphRun.getDistanceToPoint(coord);
+    for (RS_Entity *e: std::as_const(entities)) {
+        minDist = std::min(minDist, e->getDistanceToPoint(coord, nullptr, level, solidDist));
+    }
+    if (entity != nullptr) {
+        *entity = const_cast<LC_TextLine *>(this);
+    }
+    return minDist;
+}
+
+void RS_MText::LC_TextLine::move(const RS_Vector &offset) {
+    glyphRun.move(offset);
+    RS_EntityContainer::move(offset);
+}
+
+void RS_MText::LC_TextLine::rotate(const RS_Vector &center, double angle) {
+    glyphRun.rotate(center, RS_Vector(angle));
+    RS_EntityContainer::rotate(center, angle);
+}
+
+void RS_MText::LC_TextLine::rotate(const RS_Vector &center, const RS_Vector &angleVector) {
+    glyphRun.rotate(center, angleVector);
+    RS_EntityContainer::rotate(center, angleVector);
+}
+
+void RS_MText::LC_TextLine::scale(const RS_Vector &center, const RS_Vector &factor) {
+    glyphRun.scale(center, factor);
+    RS_EntityContainer::scale(center, factor);
+}
+
+void RS_MText::LC_TextLine::drawAsChild(RS_Painter *painter) {
+    if (!hasDeferredEntities()) {
+        RS_EntityContainer::drawAsChild(painter);
+        return;
+    }
+    painter->drawGlyphRun(glyphRun);
+    for (RS_Entity *e: std::as_const(entities)) {
+        painter->drawAsChild(e);
+    }
+}
+
 const RS_Vector &RS_MText::LC_TextLine::getTextSize() {
     return textSize;
 }
@@ -524,30 +620,24 @@ void RS_MText::addLetter(LC_TextLine &oneLine, QChar letter,
                          RS_Font &font, const RS_Vector &letterSpace,
                          RS_Vector &letterPosition) {
     QString letterText{QString(letter)};
-    if (nullptr == font.findLetter(letterText)) {
+    LC_FontGlyph glyph = font.findGlyph(letterText);
+    if (nullptr == glyph.letter) {
         RS_DEBUG->print("RS_MText::update: missing font for letter( %s ), replaced "
                         "it with QChar(0xfffd)",
                         qPrintable(letterText));
         letterText = QChar(0xfffd);
+        glyph = font.findGlyph(letterText);
     }
 
-    LC_LOG << "RS_MText::update: insert a letter at pos:(" << letterPosition.x
+    LC_LOG << "RS_MText::update: add a letter at pos:(" << letterPosition.x
            << ", " << letterPosition.y << ")";
 
     // adjust for right-to-left text: letter position start from the right
     bool righToLeft = std::signbit(letterSpace.x);
-
-    RS_InsertData d(letterText, letterPosition, RS_Vector(1.0, 1.0), 0.0, 1, 1,
-                    RS_Vector(0.0, 0.0), font.getLetterList(), RS2::NoUpdate);
-
-    RS_Insert *letterEntity{new RS_Insert(this, d)};
-    letterEntity->setPen(RS_Pen(RS2::FlagInvalid));
-    letterEntity->setLayer(nullptr);
-    letterEntity->update();
-    letterEntity->forcedCalculateBorders();
+    RS_Vector glyphPosition = letterPosition;
 
     // Add spacing, if the font is actually wider than word spacing
-    double actualWidth = letterEntity->getMax().x - letterEntity->getMin().x;
+    double actualWidth = glyph.maxV.valid ? glyph.maxV.x - glyph.minV.x : 0.;
     if (actualWidth >= font.getWordSpacing() + RS_TOLERANCE) {
         actualWidth = font.getWordSpacing() + std::ceil((actualWidth - font.getWordSpacing())/std::abs(letterSpace.x)) * std::abs(letterSpace.x);
     }
@@ -560,10 +650,10 @@ void RS_MText::addLetter(LC_TextLine &oneLine, QChar letter,
 
     // For right-to-left text, need to align the current position with the right edge
     if (righToLeft) {
-        letterEntity->move(letterWidth);
+        glyphPosition.move(letterWidth);
     }
 
-    oneLine.addEntity(letterEntity);
+    oneLine.addGlyph(&font, glyph, glyphPosition);
 
     // next letter position:
     letterPosition += letterSpace;
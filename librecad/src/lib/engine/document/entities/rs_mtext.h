@@ -27,6 +27,7 @@
 #ifndef RS_MTEXT_H
 #define RS_MTEXT_H
 
+#include "lc_glyphrun.h"
 #include "rs_entitycontainer.h"
 #include <iosfwd>
 
@@ -226,6 +227,22 @@ protected:
         ~LC_TextLine() override = default;
 
         LC_TextLine* clone() const override;
+        /**
+         * Adds a letter to the glyph run of this line, its insert is only created on the
+         * first access to the sub-entities
+         */
+        void addGlyph(RS_Font* font, const LC_FontGlyph& glyph, const RS_Vector& position);
+        void calculateBorders() override;
+        unsigned count() const override;
+        double getDistanceToPoint(const RS_Vector& coord,
+                                  RS_Entity** entity,
+                                  RS2::ResolveLevel level = RS2::ResolveNone,
+                                  double solidDist = RS_MAXDOUBLE) const override;
+        void move(const RS_Vector& offset) override;
+        void rotate(const RS_Vector& center, double angle) override;
+        void rotate(const RS_Vector& center, const RS_Vector& angleVector) override;
+        void scale(const RS_Vector& center, const RS_Vector& factor) override;
+        void drawAsChild(RS_Painter* painter) override;
         const RS_Vector &getTextSize();
         void setTextSize(const RS_Vector &textSize);
         const RS_Vector &getLeftBottomCorner() const;
@@ -236,6 +253,10 @@ protected:
         void setBaselineEnd(const RS_Vector &baselineEnd);
         void moveBaseline(const RS_Vector &offset);
     protected:
+        void materializeEntities() const override;
+
+        /** the letters at their positions, the super and sub texts are entities */
+        LC_GlyphRun glyphRun;
         RS_Vector textSize;
         RS_Vector leftBottomCorner;
         RS_Vector baselineStart;
@@ -327,7 +327,7 @@ void RS_Polyline::setLayer(const QString& name) {
 }
 
 void RS_Polyline::setLayer(RS_Layer* l) {
-    layer = l;
+    RS_Entity::setLayer(l);
     // set layer for sub-entities
     for (auto *e : entities) {
         e->setLayer(layer);
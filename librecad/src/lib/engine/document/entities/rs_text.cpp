@@ -55,7 +55,6 @@
 #include "rs_text.h"
 
 #include "rs_fontlist.h"
-#include "rs_insert.h"
 #include "rs_math.h"
 #include "rs_debug.h"
 #include "rs_line.h"
@@ -256,7 +255,7 @@ int RS_Text::getNumberOfLines() {
 }
 
 /**
- * Updates the Inserts (letters) of this text. Called when the
+ * Updates the glyph run (letters) of this text. Called when the
  * text or it's data, position, alignment, .. changes.
  * This method also updates the usedTextWidth / usedTextHeight property.
  */
@@ -265,6 +264,8 @@ void RS_Text::update() {
     RS_DEBUG->print("RS_Text::update");
 
     clear();
+    glyphRun.clear();
+    deferredEntities = false;
 
     if (isUndone()) {
         return;
@@ -297,32 +298,22 @@ void RS_Text::update() {
         } else {
             // One Letter:
             QString letterText = QString(data.text.at(i));
-            if (font->findLetter(letterText) == nullptr) {
+            LC_FontGlyph glyph = font->findGlyph(letterText);
+            if (glyph.letter == nullptr) {
                 RS_DEBUG->print("RS_Text::update: missing font for letter( %s ), replaced it with QChar(0xfffd)",qPrintable(letterText));
                 letterText = QChar(0xfffd);
+                glyph = font->findGlyph(letterText);
             }
-            RS_DEBUG->print("RS_Text::update: insert a "
+            RS_DEBUG->print("RS_Text::update: add a "
                             "letter at pos: %f/%f", letterPos.x, letterPos.y);
 
-            RS_InsertData d(letterText,
-                            letterPos,
-                            RS_Vector(1.0, 1.0),
-                            0.0,
-                            1,1, RS_Vector(0.0,0.0),
-                            font->getLetterList(), RS2::NoUpdate);
-
-            auto* letter = new RS_Insert(this, d);
-            RS_Vector letterWidth;
-            letter->setPen(RS_Pen(RS2::FlagInvalid));
-            letter->setLayer(nullptr);
-            letter->update();
-            letter->forcedCalculateBorders();
-
-            letterWidth = RS_Vector(letter->getMax().x-letterPos.x, 0.0);
+            glyphRun.add(font, glyph, letterPos);
+
+            // the extent of an empty letter is reset to the origin
+            RS_Vector letterWidth = RS_Vector(glyph.maxV.valid ? glyph.maxV.x : -letterPos.x, 0.0);
             if (letterWidth.x < 0) {
                 letterWidth.x = -letterSpace.x;
             }
-            addEntity(letter);
 
             // next letter position:
             letterPos += letterWidth;
@@ -330,10 +321,9 @@ void RS_Text::update() {
         }
     }
 
-    if( ! RS_EntityContainer::autoUpdateBorders) {
-        //only update borders when needed
-        forcedCalculateBorders();
-    }
+    // the letter inserts are created from the glyph run on their first access
+    deferredEntities = !glyphRun.isEmpty();
+    forcedCalculateBorders();
     RS_Vector textSize = getSize();
 
     RS_DEBUG->print("RS_Text::updateAddLine: width 2: %f", textSize.x);
@@ -386,22 +376,22 @@ void RS_Text::update() {
     if (data.halign!=RS_TextData::HAAligned && data.halign!=RS_TextData::HAFit){
         data.secondPoint = RS_Vector(offset.x, offset.y - vSize);
     }
-    RS_EntityContainer::move(offset);
+    glyphRun.move(offset);
 
 
     // Scale:
     if (data.halign==RS_TextData::HAAligned){
         double dist = data.insertionPoint.distanceTo(data.secondPoint)/textSize.x;
         data.height = vSize*dist;
-        RS_EntityContainer::scale(RS_Vector(0.0,0.0),
-                                  RS_Vector(dist, dist));
+        glyphRun.scale(RS_Vector(0.0,0.0),
+                       RS_Vector(dist, dist));
     } else if (data.halign==RS_TextData::HAFit){
         double dist = data.insertionPoint.distanceTo(data.secondPoint)/textSize.x;
-        RS_EntityContainer::scale(RS_Vector(0.0,0.0),
-                                  RS_Vector(dist, data.height/9.0));
+        glyphRun.scale(RS_Vector(0.0,0.0),
+                       RS_Vector(dist, data.height/9.0));
     } else {
-        RS_EntityContainer::scale(RS_Vector(0.0,0.0),
-                                  RS_Vector(data.height*data.widthRel/9.0, data.height/9.0));
+        glyphRun.scale(RS_Vector(0.0,0.0),
+                       RS_Vector(data.height*data.widthRel/9.0, data.height/9.0));
         data.secondPoint.scale(RS_Vector(0.0,0.0),
                                RS_Vector(data.height*data.widthRel/9.0, data.height/9.0));
     }
@@ -420,10 +410,10 @@ void RS_Text::update() {
         data.secondPoint.rotate(RS_Vector(0.0,0.0), data.angle);
         data.secondPoint.move(data.insertionPoint);
     }
-    RS_EntityContainer::rotate(RS_Vector(0.0,0.0), data.angle);
+    glyphRun.rotate(RS_Vector(0.0,0.0), RS_Vector(data.angle));
 
     // Move to insertion point:
-    RS_EntityContainer::move(data.insertionPoint);
+    glyphRun.move(data.insertionPoint);
 
     updateBaselinePoints();
 
@@ -450,6 +440,57 @@ RS_VectorSolutions RS_Text::getRefPoints() const{
     return ret;
 }
 
+/**
+ * Creates the letters as inserts on the first access to the sub-entities.
+ * The borders are then found from the letters, as for a text created with them.
+ */
+void RS_Text::materializeEntities() const {
+    RS_DEBUG->print("RS_Text::materializeEntities: %d letters", (int) glyphRun.size());
+    auto* self = const_cast<RS_Text*>(this);
+    glyphRun.createLetters(self);
+    self->forcedCalculateBorders();
+}
+
+/**
+ * Recalculates the borders. Without letters, the borders are found
+ * from the glyph outlines.
+ */
+void RS_Text::calculateBorders() {
+    if (!hasDeferredEntities()) {
+        RS_EntityContainer::calculateBorders();
+        return;
+    }
+
+    const RS_Vector previousMin = minV;
+    const RS_Vector previousMax = maxV;
+    resetBorders();
+    glyphRun.extendBorders(minV, maxV);
+    // letters without extent, as an empty container
+    if (minV.x > maxV.x || minV.y > maxV.y) {
+        minV = RS_Vector(0.0, 0.0);
+        maxV = RS_Vector(0.0, 0.0);
+    }
+    updateInParent(previousMin, previousMax);
+}
+
+unsigned RS_Text::count() const {
+    return hasDeferredEntities() ? static_cast<unsigned>(glyphRun.size()) : RS_EntityContainer::count();
+}
+
+/**
+ * Without letters, the distance to the text itself is found from the glyph outlines.
+ */
+double RS_Text::getDistanceToPoint(const RS_Vector& coord, RS_Entity** entity,
+                                   RS2::ResolveLevel level, double solidDist) const {
+    if (level != RS2::ResolveNone || !hasDeferredEntities()) {
+        return RS_EntityContainer::getDistanceToPoint(coord, entity, level, solidDist);
+    }
+    if (entity != nullptr) {
+        *entity = const_cast<RS_Text*>(this);
+    }
+    return glyphRun.getDistanceToPoint(coord);
+}
+
 RS_Vector RS_Text::getNearestRef(const RS_Vector &coord, double *dist) const {
     return RS_Entity::getNearestRef(coord, dist);
 }
@@ -468,6 +509,7 @@ void RS_Text::moveSelectedRef([[maybe_unused]]const RS_Vector &ref, const RS_Vec
 }
 
 void RS_Text::move(const RS_Vector& offset) {
+    glyphRun.move(offset);
     RS_EntityContainer::move(offset);
     data.insertionPoint.move(offset);
     data.secondPoint.move(offset);
@@ -478,6 +520,7 @@ void RS_Text::move(const RS_Vector& offset) {
 
 void RS_Text::rotate(const RS_Vector& center, double angle) {
     RS_Vector angleVector(angle);
+    glyphRun.rotate(center, angleVector);
     RS_EntityContainer::rotate(center, angleVector);
     data.insertionPoint.rotate(center, angleVector);
     data.secondPoint.rotate(center, angleVector);
@@ -486,6 +529,7 @@ void RS_Text::rotate(const RS_Vector& center, double angle) {
 //    update();
 }
 void RS_Text::rotate(const RS_Vector& center, const RS_Vector& angleVector) {
+    glyphRun.rotate(center, angleVector);
     RS_EntityContainer::rotate(center, angleVector);
     data.insertionPoint.rotate(center, angleVector);
     data.secondPoint.rotate(center, angleVector);
@@ -573,7 +617,19 @@ void RS_Text::draw(RS_Painter* painter){
         return;
     }
 
+    if (hasDeferredEntities()) {
+        painter->drawGlyphRun(glyphRun);
+        return;
+    }
     foreach (auto e, entities){
        painter->drawAsChild(e);
     }
 }
+
+void RS_Text::drawAsChild(RS_Painter* painter) {
+    if (hasDeferredEntities()) {
+        painter->drawGlyphRun(glyphRun);
+    } else {
+        RS_EntityContainer::drawAsChild(painter);
+    }
+}
@@ -28,6 +28,7 @@
 #ifndef RS_TEXT_H
 #define RS_TEXT_H
 
+#include "lc_glyphrun.h"
 #include "rs_entitycontainer.h"
 
 /**
@@ -132,6 +133,8 @@ std::ostream& operator << (std::ostream& os, const RS_TextData& td);
  * Please note that text strings can contain special
  * characters such as %%c for a diameter sign as well as unicode
  * characters. Line feeds are stored as real line feeds in the string.
+ * The letters are drawn from a glyph run, the letter inserts are only
+ * created on the first access to the sub-entities, e.g. to explode the text.
  *
  * @author Andrew Mustun
  */
@@ -228,6 +231,13 @@ public:
                                          double* dist = NULL)const override;
      RS_VectorSolutions getRefPoints() const override;
 
+    void calculateBorders() override;
+    unsigned count() const override;
+    double getDistanceToPoint(const RS_Vector& coord,
+                              RS_Entity** entity,
+                              RS2::ResolveLevel level = RS2::ResolveNone,
+                              double solidDist = RS_MAXDOUBLE) const override;
+
      void move(const RS_Vector& offset) override;
      void rotate(const RS_Vector& center, double angle) override;
      void rotate(const RS_Vector& center, const RS_Vector& angleVector) override;
@@ -240,6 +250,7 @@ public:
 
     friend std::ostream& operator << (std::ostream& os, const RS_Text& p);
     void draw(RS_Painter* painter) override;
+    void drawAsChild(RS_Painter* painter) override;
     void drawDraft(RS_Painter *painter) override;
     RS_Entity *cloneProxy() const override;
     RS_Vector getNearestSelectedRef(const RS_Vector &coord, double *dist) const override;
@@ -247,7 +258,11 @@ public:
     RS_Vector getNearestRef(const RS_Vector &coord, double *dist) const override;
     void moveRef(const RS_Vector &ref, const RS_Vector &offset) override;
 protected:
+    void materializeEntities() const override;
+
     RS_TextData data;
+    /** the letters at their positions, mapped to the text */
+    LC_GlyphRun glyphRun;
 
     /**
      * Text width used by the current contents of this text entity.
@@ -0,0 +1,176 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_glyphrun.h"
+#include "rs_block.h"
+#include "rs_entitycontainer.h"
+#include "rs_insert.h"
+#include "rs_math.h"
+
+namespace {
+// the distance of a point to the line segment from start to end
+double getDistanceToSegment(const RS_Vector& coord, const RS_Vector& start, const RS_Vector& end)
+{
+    const RS_Vector direction = end - start;
+    const double length2 = direction.squared();
+    double t = length2 > RS_TOLERANCE2 ? RS_Vector::dotP(coord - start, direction) / length2 : 0.;
+    t = std::clamp(t, 0., 1.);
+    return coord.distanceTo(start + direction * t);
+}
+}
+
+void LC_GlyphRun::clear()
+{
+    m_glyphs.clear();
+    m_origin = {0., 0.};
+    m_xAxis = {1., 0.};
+    m_yAxis = {0., 1.};
+}
+
+void LC_GlyphRun::add(RS_Font* font, const LC_FontGlyph& glyph, const RS_Vector& position)
+{
+    if (font != nullptr && glyph.letter != nullptr) {
+        m_glyphs.push_back({font, glyph, position});
+    }
+}
+
+void LC_GlyphRun::move(const RS_Vector& offset)
+{
+    m_origin.move(offset);
+    m_xAxis.move(offset);
+    m_yAxis.move(offset);
+}
+
+void LC_GlyphRun::rotate(const RS_Vector& center, const RS_Vector& angleVector)
+{
+    m_origin.rotate(center, angleVector);
+    m_xAxis.rotate(center, angleVector);
+    m_yAxis.rotate(center, angleVector);
+}
+
+void LC_GlyphRun::scale(const RS_Vector& center, const RS_Vector& factor)
+{
+    m_origin.scale(center, factor);
+    m_xAxis.scale(center, factor);
+    m_yAxis.scale(center, factor);
+}
+
+RS_Vector LC_GlyphRun::toDrawing(const RS_Vector& layoutPoint) const
+{
+    return m_origin + (m_xAxis - m_origin) * layoutPoint.x + (m_yAxis - m_origin) * layoutPoint.y;
+}
+
+void LC_GlyphRun::extendBorders(RS_Vector& minV, RS_Vector& maxV) const
+{
+    const RS_Vector xAxis = m_xAxis - m_origin;
+    const RS_Vector yAxis = m_yAxis - m_origin;
+    // the extent of a glyph is exact for layouts parallel to the axes of the drawing,
+    // otherwise the points of the outline bound the glyph
+    const bool parallel = (RS_Math::equal(xAxis.y, 0.) && RS_Math::equal(yAxis.x, 0.))
+                          || (RS_Math::equal(xAxis.x, 0.) && RS_Math::equal(yAxis.y, 0.));
+    for (const Glyph& g: m_glyphs) {
+        if (!g.glyph.minV.valid) {
+            continue;
+        }
+        if (parallel) {
+            for (const RS_Vector& corner: {g.glyph.minV, g.glyph.maxV}) {
+                const RS_Vector v = toDrawing(g.position + corner);
+                minV = RS_Vector::minimum(minV, v);
+                maxV = RS_Vector::maximum(maxV, v);
+            }
+            continue;
+        }
+        const QPainterPath& outline = g.glyph.outline;
+        for (int i = 0; i < outline.elementCount(); ++i) {
+            const QPainterPath::Element& e = outline.elementAt(i);
+            const RS_Vector v = toDrawing(g.position + RS_Vector{e.x, e.y});
+            minV = RS_Vector::minimum(minV, v);
+            maxV = RS_Vector::maximum(maxV, v);
+        }
+    }
+}
+
+double LC_GlyphRun::getDistanceToPoint(const RS_Vector& coord) const
+{
+    double minDist = RS_MAXDOUBLE;
+    for (const Glyph& g: m_glyphs) {
+        const QPainterPath& outline = g.glyph.outline;
+        RS_Vector previous;
+        for (int i = 0; i < outline.elementCount(); ++i) {
+            const QPainterPath::Element& e = outline.elementAt(i);
+            const RS_Vector v = toDrawing(g.position + RS_Vector{e.x, e.y});
+            if (e.isLineTo()) {
+                minDist = std::min(minDist, getDistanceToSegment(coord, previous, v));
+            }
+            previous = v;
+        }
+    }
+    return minDist;
+}
+
+QPainterPath LC_GlyphRun::getOutline() const
+{
+    QPainterPath path;
+    for (const Glyph& g: m_glyphs) {
+        const QPainterPath& outline = g.glyph.outline;
+        for (int i = 0; i < outline.elementCount(); ++i) {
+            const QPainterPath::Element& e = outline.elementAt(i);
+            if (e.isMoveTo()) {
+                path.moveTo(e.x + g.position.x, e.y + g.position.y);
+            } else {
+                path.lineTo(e.x + g.position.x, e.y + g.position.y);
+            }
+        }
+    }
+    return path;
+}
+
+void LC_GlyphRun::createLetters(RS_EntityContainer* container) const
+{
+    const RS_Vector xAxis = m_xAxis - m_origin;
+    const RS_Vector yAxis = m_yAxis - m_origin;
+    // the layout is mirrored by a negative scale in y
+    const bool mirrored = xAxis.x * yAxis.y - xAxis.y * yAxis.x < 0.;
+    const RS_Vector scaleFactor{xAxis.magnitude(), mirrored ? -yAxis.magnitude() : yAxis.magnitude()};
+    for (const Glyph& g: m_glyphs) {
+        RS_InsertData d(g.glyph.letter->getName(),
+                        toDrawing(g.position),
+                        scaleFactor,
+                        xAxis.angle(),
+                        1, 1, RS_Vector(0.0, 0.0),
+                        g.font->getLetterList(), RS2::NoUpdate);
+
+        auto* letter = new RS_Insert(container, d);
+        letter->setPen(RS_Pen(RS2::FlagInvalid));
+        letter->setLayer(nullptr);
+        letter->setVisible(container->getFlag(RS2::FlagVisible));
+        letter->setSelected(container->isSelected());
+        letter->setHighlighted(container->isHighlighted());
+        letter->update();
+        container->appendEntity(letter);
+    }
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+#ifndef LC_GLYPHRUN_H
+#define LC_GLYPHRUN_H
+
+#include <cstddef>
+#include <vector>
+
+#include <QPainterPath>
+
+#include "rs_font.h"
+#include "rs_vector.h"
+
+class RS_EntityContainer;
+
+/**
+ * The letters of a text as glyphs of fonts at their positions in the layout
+ * of the text. The layout is mapped to the drawing by an affine transformation,
+ * which follows the transformations of the text.
+ *
+ * Texts keep a glyph run instead of an insert with copies of the entities of
+ * each letter. The run is drawn from the outlines cached by the fonts, through
+ * a single transformation of the painter. The letter inserts are only created
+ * when the sub-entities of the text are accessed, e.g. to explode it.
+ */
+class LC_GlyphRun {
+public:
+    /**
+     * Removes all glyphs and resets the layout to the drawing coordinates
+     */
+    void clear();
+    void add(RS_Font* font, const LC_FontGlyph& glyph, const RS_Vector& position);
+
+    bool isEmpty() const {
+        return m_glyphs.empty();
+    }
+    std::size_t size() const {
+        return m_glyphs.size();
+    }
+
+    /**
+     * Transformations of the layout in the drawing, as those of entities
+     */
+    void move(const RS_Vector& offset);
+    void rotate(const RS_Vector& center, const RS_Vector& angleVector);
+    void scale(const RS_Vector& center, const RS_Vector& factor);
+
+    /**
+     * @return the position in the drawing of a point of the layout
+     */
+    RS_Vector toDrawing(const RS_Vector& layoutPoint) const;
+    /**
+     * @return the positions in the drawing of the layout points (0,0), (1,0) and (0,1)
+     */
+    const RS_Vector& getOrigin() const {
+        return m_origin;
+    }
+    const RS_Vector& getXAxis() const {
+        return m_xAxis;
+    }
+    const RS_Vector& getYAxis() const {
+        return m_yAxis;
+    }
+
+    /**
+     * Extends the borders by the outlines of the glyphs in the drawing
+     */
+    void extendBorders(RS_Vector& minV, RS_Vector& maxV) const;
+    /**
+     * @return the distance in the drawing to the nearest glyph outline
+     */
+    double getDistanceToPoint(const RS_Vector& coord) const;
+    /**
+     * @return the outlines of all glyphs in the layout
+     */
+    QPainterPath getOutline() const;
+    /**
+     * Adds the letters as inserts of the letter blocks of the fonts to a container,
+     * as the letters of texts were created before glyph runs
+     */
+    void createLetters(RS_EntityContainer* container) const;
+
+private:
+    struct Glyph {
+        RS_Font* font = nullptr;
+        LC_FontGlyph glyph;
+        RS_Vector position;
+    };
+    std::vector<Glyph> m_glyphs;
+    // the positions in the drawing of the layout points (0,0), (1,0) and (0,1)
+    RS_Vector m_origin{0., 0.};
+    RS_Vector m_xAxis{1., 0.};
+    RS_Vector m_yAxis{0., 1.};
+};
+
+#endif
@@ -24,12 +24,14 @@
 **
 **********************************************************************/
 
+#include <cmath>
 #include <iostream>
 
 #include <QRegularExpression>
 #include <QStringConverter>
 #include <QTextStream>
 
+#include "lc_entityiterator.h"
 #include "rs_arc.h"
 #include "rs_debug.h"
 #include "rs_font.h"
@@ -72,6 +74,58 @@ std::pair<QString, bool> extractFontChar(const QString& line)
     char32_t ucsCode{code};
     return {QString::fromUcs4(&ucsCode, 1), true};
 }
+
+// Angle between the points of the tessellated arcs of letters. The points are at
+// multiples of this angle, which include the extreme points of the arcs
+constexpr double outlineArcStep = M_PI / 32.;
+
+// Adds a line to the outline of a letter, continuing the current subpath at its end point
+void addOutlineLine(QPainterPath& outline, const RS_Vector& start, const RS_Vector& end)
+{
+    const QPointF startPoint{start.x, start.y};
+    if (outline.elementCount() == 0 || (outline.currentPosition() - startPoint).manhattanLength() > RS_TOLERANCE) {
+        outline.moveTo(startPoint);
+    }
+    outline.lineTo(end.x, end.y);
+}
+
+// Adds an arc to the outline of a letter, the angle length is positive
+void addOutlineArc(QPainterPath& outline, const RS_Vector& center, double radius,
+                   double angle1, double angleLength, bool reversed)
+{
+    const double sign = reversed ? -1. : 1.;
+    const double start = sign * angle1;
+    RS_Vector previous = center + RS_Vector::polar(radius, angle1);
+    for (double k = std::floor(start / outlineArcStep) + 1.;
+         k * outlineArcStep < start + angleLength - RS_TOLERANCE_ANGLE; k += 1.) {
+        const RS_Vector point = center + RS_Vector::polar(radius, sign * k * outlineArcStep);
+        addOutlineLine(outline, previous, point);
+        previous = point;
+    }
+    addOutlineLine(outline, previous, center + RS_Vector::polar(radius, angle1 + sign * angleLength));
+}
+
+// Adds an atomic entity of a letter to its outline, relative to the base point
+void addToOutline(QPainterPath& outline, const RS_Entity* entity, const RS_Vector& basePoint)
+{
+    switch (entity->rtti()) {
+        case RS2::EntityArc: {
+            const auto* arc = static_cast<const RS_Arc*>(entity);
+            addOutlineArc(outline, arc->getCenter() - basePoint, arc->getRadius(),
+                          arc->getAngle1(), arc->getAngleLength(), arc->isReversed());
+            break;
+        }
+        case RS2::EntityCircle:
+            addOutlineArc(outline, entity->getCenter() - basePoint, entity->getRadius(), 0., 2. * M_PI, false);
+            break;
+        default:
+            // letters consist of lines and arcs, anything else is outlined by its end points
+            if (entity->getStartpoint().valid && entity->getEndpoint().valid) {
+                addOutlineLine(outline, entity->getStartpoint() - basePoint, entity->getEndpoint() - basePoint);
+            }
+            break;
+    }
+}
 }
 
 /**
@@ -487,6 +541,33 @@ RS_Block* RS_Font::findLetter(const QString& name) {
 
 }
 
+/**
+ * @return the letter with its extent and outline. The letter is nullptr if
+ * the font doesn't contain it.
+ * The glyphs are cached without locking, fonts are used by the GUI thread only.
+ */
+LC_FontGlyph RS_Font::findGlyph(const QString& name) {
+    auto it = glyphs.constFind(name);
+    if (it != glyphs.cend()) {
+        return it.value();
+    }
+
+    LC_FontGlyph glyph;
+    glyph.letter = findLetter(name);
+    if (glyph.letter != nullptr) {
+        RS_Vector basePoint = glyph.letter->getBasePoint();
+        for (RS_Entity* e: *glyph.letter) {
+            glyph.minV = RS_Vector::minimum(glyph.minV, e->getMin() - basePoint);
+            glyph.maxV = RS_Vector::maximum(glyph.maxV, e->getMax() - basePoint);
+        }
+        for (RS_Entity* e: LC_EntityRange{*glyph.letter, RS2::ResolveAll}) {
+            addToOutline(glyph.outline, e, basePoint);
+        }
+    }
+    glyphs.insert(name, glyph);
+    return glyph;
+}
+
 /**
  * Dumps the fonts data to stdout.
  */
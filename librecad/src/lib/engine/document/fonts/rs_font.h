@@ -29,8 +29,24 @@
 #define RS_FONT_H
 
 #include <QStringList>
+#include <QHash>
 #include <QMap>
+#include <QPainterPath>
 #include "rs_blocklist.h"
+#include "rs_vector.h"
+
+/**
+ * A letter of a font with its extent and outline, cached for the layout
+ * and the drawing of texts.
+ */
+struct LC_FontGlyph {
+    RS_Block* letter = nullptr;
+    //! extent relative to the letter position, invalid for empty letters
+    RS_Vector minV{false};
+    RS_Vector maxV{false};
+    //! outline relative to the letter position, tessellated into lines
+    QPainterPath outline;
+};
 
 /**
  * Class for representing a font. This is implemented as a RS_Graphic
@@ -98,6 +114,7 @@ public:
         return &letterList;
     }
     RS_Block* findLetter(const QString& name);
+    LC_FontGlyph findGlyph(const QString& name);
     //    RS_Block* findLetter(const QString& name) {
     //		return letterList.find(name);
     //	}
@@ -124,6 +141,9 @@ private:
     //! block list (letters)
     RS_BlockList letterList;
 
+    //! letters with their extent by name, including missing letters, not locked: GUI thread only
+    QHash<QString, LC_FontGlyph> glyphs;
+
     //! Font file name
     QString m_fileName;
 
@@ -51,6 +51,7 @@ void RS_FontList::init() {
     QStringList list = RS_SYSTEM->getNewFontList();
     list.append(RS_SYSTEM->getFontList());
     QHash<QString, int> added; //used to remember added fonts (avoid duplication)
+    requestedFonts.clear();
 
     for (int i = 0; i < list.size(); ++i) {
         RS_DEBUG->print(RS_Debug::D_ERROR, "font: %s:", list.at(i).toLatin1().data());
@@ -84,12 +85,15 @@ std::vector<std::unique_ptr<RS_Font> >::const_iterator RS_FontList::end() const
  */
 void RS_FontList::clearFonts() {
 	fonts.clear();
+	requestedFonts.clear();
 }
 
 /**
  * @return Pointer to the font with the given name or
  * \p NULL if no such font was found. The font will be loaded into
  * memory if it's not already.
+ * Like the loading of fonts, the cache of requested names is not locked:
+ * texts are only updated by the GUI thread.
  */
 RS_Font* RS_FontList::requestFont(const QString& name) {
     RS_DEBUG->print("RS_FontList::requestFont %s",  name.toLatin1().data());
@@ -99,6 +103,11 @@ RS_Font* RS_FontList::requestFont(const QString& name) {
     if (name.isEmpty())
         return foundFont;
 
+    // fonts stay loaded, only the first request of a name searches the list
+    auto cached = requestedFonts.constFind(name);
+    if (cached != requestedFonts.cend())
+        return cached.value();
+
     // QCAD 1 compatibility:
     if (name2.contains('#') && name2.contains('_')) {
         name2 = name2.left(name2.indexOf('_'));
@@ -123,6 +132,7 @@ RS_Font* RS_FontList::requestFont(const QString& name) {
         foundFont = requestFont("standard");
     }
 
+    requestedFonts.insert(name, foundFont);
     return foundFont;
 }
 
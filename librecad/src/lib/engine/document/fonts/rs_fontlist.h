@@ -28,7 +28,9 @@
 #include <memory>
 #include <vector>
 
-class QString;
+#include <QHash>
+#include <QString>
+
 class RS_Font;
 
 #define RS_FONTLIST RS_FontList::instance()
@@ -66,6 +68,8 @@ private:
     static RS_FontList* uniqueInstance;
     //! fonts in the graphic
     std::vector<std::unique_ptr<RS_Font>> fonts;
+    //! fonts found by requestFont(), by the requested name, not locked: GUI thread only
+    QHash<QString, RS_Font*> requestedFonts;
 };
 
 #endif
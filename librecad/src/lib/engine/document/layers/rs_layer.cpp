@@ -24,6 +24,7 @@
 #include <QString>
 #include "rs_debug.h"
 #include "rs_layer.h"
+#include "rs_layerlist.h"
 
 RS_LayerData::RS_LayerData(const QString& name,
 						   const RS_Pen& pen,
@@ -45,13 +46,39 @@ RS_Layer::RS_Layer(const QString& name):
 //    LC_ERR<<name;
 }
 
+/**
+ * Copies the layer data. The copy is in no layer list.
+ */
+RS_Layer::RS_Layer(const RS_Layer& other):
+    data(other.data)
+{
+}
+
+RS_Layer& RS_Layer::operator=(const RS_Layer& other) {
+    data = other.data;
+    return *this;
+}
+
 RS_Layer* RS_Layer::clone() const{
 	return new RS_Layer(*this);
 }
 
 /** sets a new name for this layer. */
 void RS_Layer::setName(const QString& name) {
-	data.name = name;
+    if (data.name != name) {
+        data.name = name;
+        if (layerList != nullptr) {
+            layerList->layerRenamed();
+        }
+    }
+}
+
+void RS_Layer::setLayerList(RS_LayerList* list) {
+    layerList = list;
+}
+
+RS_LayerList* RS_Layer::getLayerList() const {
+    return layerList;
 }
 
 /** @return the name of this layer. */
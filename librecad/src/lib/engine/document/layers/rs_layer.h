@@ -38,6 +38,7 @@
 #include "rs_pen.h"
 
 class QString;
+class RS_LayerList;
 
 /**
  * Holds the data that defines a layer.
@@ -73,6 +74,8 @@ class RS_Layer {
 public:
     explicit RS_Layer(const QString& name);
     //RS_Layer(const char* name);
+    RS_Layer(const RS_Layer& other);
+    RS_Layer& operator=(const RS_Layer& other);
 
 	RS_Layer* clone() const;
 
@@ -82,6 +85,13 @@ public:
     /** @return the name of this layer. */
 	QString getName() const;
 
+    /**
+     * Sets the layer list told of renames of this layer, to keep its
+     * name index up to date. Set by the list, see RS_LayerList::add().
+     */
+    void setLayerList(RS_LayerList* list);
+    RS_LayerList* getLayerList() const;
+
     /** sets the default pen for this layer. */
 	void setPen(const RS_Pen& pen);
 
@@ -200,6 +210,8 @@ public:
 private:
     //! Layer data
     RS_LayerData data;
+    //! list of this layer, not copied
+    RS_LayerList* layerList = nullptr;
 
 };
 
@@ -25,7 +25,8 @@
 **
 **********************************************************************/
 
-#include<iostream>
+#include <algorithm>
+#include <iostream>
 
 #include "rs_debug.h"
 #include "rs_layerlist.h"
@@ -40,13 +41,31 @@ RS_LayerList::RS_LayerList() {
     setModified(false);
 }
 
+RS_LayerList::~RS_LayerList() {
+    detachLayers();
+}
+
+/**
+ * Layers may outlive the list, they don't tell it of renames anymore.
+ */
+void RS_LayerList::detachLayers() {
+    for (RS_Layer* l: std::as_const(layers)) {
+        if (l->getLayerList() == this) {
+            l->setLayerList(nullptr);
+        }
+    }
+}
+
 
 
 /**
  * Removes all layers in the layerlist.
  */
 void RS_LayerList::clear() {
+    detachLayers();
     layers.clear();
+    layerIndex.clear();
+    indexRenames = sortRenames = renames;
     setModified(true);
 }
 
@@ -134,6 +153,7 @@ void RS_LayerList::sort()
     std::stable_sort(layers.begin(), layers.end(), [](const RS_Layer* l0, const RS_Layer* l1 )->bool{
                          return l0->getName() < l1->getName();
                      });
+    sortRenames = renames;
 }
 
 /**
@@ -154,8 +174,18 @@ void RS_LayerList::add(RS_Layer* layer) {
     // check if layer already exists:
     RS_Layer* l = find(layer->getName());
     if (l==nullptr) {
-        layers.append(layer);
-        this->sort();
+        if (sortRenames == renames) {
+            // still sorted, insert at the right place
+            auto it = std::upper_bound(layers.begin(), layers.end(), layer, [](const RS_Layer* l0, const RS_Layer* l1 )->bool{
+                                           return l0->getName() < l1->getName();
+                                       });
+            layers.insert(it, layer);
+        } else {
+            layers.append(layer);
+            this->sort();
+        }
+        layerIndex.insert(layer->getName(), layer);
+        layer->setLayerList(this);
         // notify listeners
         for (int i=0; i<layerListListeners.size(); ++i) {
             RS_LayerListListener* l = layerListListeners.at(i);
@@ -201,6 +231,10 @@ void RS_LayerList::remove(RS_Layer* layer) {
 
     // here the layer is removed from the list but not deleted
     layers.removeOne(layer);
+    if (layerIndex.value(layer->getName()) == layer) {
+        // another layer may have the same name after renames
+        rebuildIndex();
+    }
 
     for (int i=0; i<layerListListeners.size(); ++i) {
         RS_LayerListListener* l = layerListListeners.at(i);
@@ -230,6 +264,8 @@ void RS_LayerList::edit(RS_Layer* layer, const RS_Layer& source) {
         return;
     }
 
+    // counts a changed name as rename for the name index
+    layer->setName(source.getName());
     *layer = source;
 
     fireEdit(layer);
@@ -252,21 +288,30 @@ void RS_LayerList::fireEdit(RS_Layer* layer) {
  * \p nullptr if no such layer was found.
  */
 RS_Layer* RS_LayerList::find(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
+    updateIndex();
+    return layerIndex.value(name, nullptr);
+}
 
-    RS_Layer* ret = nullptr;
+/**
+ * Rebuilds the name index, if any layer was renamed since it was built.
+ * Layers are renamed directly, not through the list, and tell it by layerRenamed().
+ */
+void RS_LayerList::updateIndex() {
+    if (indexRenames != renames) {
+        rebuildIndex();
+    }
+}
 
-    for (int i=0; i<layers.size(); ++i) {
-        RS_Layer* l = layers.at(i);
-        if (l->getName()==name) {
-            ret = l;
-            break;
+void RS_LayerList::rebuildIndex() {
+    layerIndex.clear();
+    layerIndex.reserve(layers.size());
+    // the first of layers with the same name is found, as by a linear search
+    for (RS_Layer* l: std::as_const(layers)) {
+        if (!layerIndex.contains(l->getName())) {
+            layerIndex.insert(l->getName(), l);
         }
     }
-
-    //RS_DEBUG->print("RS_LayerList::find end");
-
-    return ret;
+    indexRenames = renames;
 }
 
 
@@ -276,22 +321,8 @@ RS_Layer* RS_LayerList::find(const QString& name) {
  * was not found.
  */
 int RS_LayerList::getIndex(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
-
-    int ret = -1;
-
-    for (int i=0; i<layers.size(); i++) {
-        RS_Layer* l = layers.at(i);
-
-        if (l->getName()==name) {
-            ret = i;
-            break;
-        }
-    }
-
-    //RS_DEBUG->print("RS_LayerList::find end");
-
-    return ret;
+    RS_Layer* l = find(name);
+    return l == nullptr ? -1 : layers.indexOf(l);
 }
 
 
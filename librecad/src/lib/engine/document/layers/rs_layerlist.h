@@ -29,7 +29,9 @@
 #ifndef RS_LAYERLIST_H
 #define RS_LAYERLIST_H
 
+#include <QHash>
 #include <QList>
+#include <QString>
 
 class RS_Layer;
 class RS_LayerListListener;
@@ -43,7 +45,7 @@ class QG_LayerWidget;
 class RS_LayerList {
 public:
     RS_LayerList();
-    virtual ~RS_LayerList() = default;
+    virtual ~RS_LayerList();
 
     void clear();
 
@@ -135,6 +137,13 @@ public:
      * @brief sort by layer names
      */
     void sort();
+    /**
+     * Called by the layers of the list on renames. The name index and
+     * the order are updated on the next use.
+     */
+    void layerRenamed() {
+        renames++;
+    }
 
     void slotUpdateLayerList();
 
@@ -143,8 +152,19 @@ public:
 private:
 
     void fireLayerToggled();
+    void updateIndex();
+    void rebuildIndex();
+    void detachLayers();
 	//! layers in the graphic
     QList<RS_Layer*> layers;
+    //! layers by name, for find()
+    QHash<QString, RS_Layer*> layerIndex;
+    //! number of renames of layers in the list
+    unsigned renames = 0;
+    //! renames when layerIndex was built
+    unsigned indexRenames = 0;
+    //! renames when layers were sorted
+    unsigned sortRenames = 0;
     //! List of registered LayerListListeners
     QList<RS_LayerListListener*> layerListListeners;
     QG_LayerWidget *layerWidget = nullptr;
@@ -42,6 +42,8 @@ RS_Document::RS_Document(RS_EntityContainer* parent)
     , autosaveFilename{ "Unnamed"}
 {
     RS_DEBUG->print("RS_Document::RS_Document() ");
+    // snapping and picking query documents on every mouse move
+    setSpatialIndexEnabled(true);
 }
 
 /**
@@ -56,3 +58,28 @@ void RS_Document::endUndoCycle()
     RS_Undo::endUndoCycle();
 }
 
+/**
+ * Removes all undone entities among the undoables from the entity list
+ * in one pass. Implementation from RS_Undo.
+ */
+void RS_Document::removeUndoables(const std::set<RS_Undoable*>& undoables)
+{
+    std::set<RS_Entity*> undone;
+    for (RS_Undoable* u: undoables) {
+        if (u && u->undoRtti()==RS2::UndoableEntity && u->isUndone()) {
+            undone.insert(static_cast<RS_Entity*>(u));
+        }
+    }
+    removeEntities(undone);
+}
+
+std::vector<RS_Entity*> RS_Document::getLayerEntities(RS_Layer* layer) const
+{
+    std::vector<RS_Entity*> result;
+    for (RS_Entity* e: entities) {
+        if (e->getLayer(false) == layer) {
+            result.push_back(e);
+        }
+    }
+    return result;
+}
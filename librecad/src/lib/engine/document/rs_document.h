@@ -78,6 +78,13 @@ public:
             removeEntity(static_cast<RS_Entity*>(u));
         }
     }
+    void removeUndoables(const std::set<RS_Undoable*>& undoables) override;
+
+    /**
+     * @return top level entities on the given layer by the order of the entity list,
+     * including undone entities
+     */
+    virtual std::vector<RS_Entity*> getLayerEntities(RS_Layer* layer) const;
 
     /**
      * @return Currently active drawing pen.
@@ -100,6 +107,11 @@ public:
      */
     QString getAutoSaveFilename() const {return autosaveFilename;}
 
+    /**
+     * @return File format of the document currently loaded.
+     */
+    RS2::FormatType getFormatType() const {return formatType;}
+
     /**
      * Sets file name for the document currently loaded.
      */
@@ -24,6 +24,7 @@
 **
 **********************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -140,16 +141,166 @@ unsigned RS_Graphic::countLayerEntities(RS_Layer *layer) const
 {
     unsigned c = 0;
     if (layer) {
-        for (RS_Entity *t: entities) {
-            if (t->getLayer() &&
-                t->getLayer()->getName() == layer->getName()) {
-                c += t->countDeep();
-            }
+        for (RS_Entity *t: getLayerEntities(layer)) {
+            c += t->countDeep();
         }
     }
     return c;
 }
 
+std::vector<RS_Entity*> RS_Graphic::getLayerEntities(RS_Layer* layer) const
+{
+    ensureLayerEntities();
+    auto it = layerEntities.find(layer);
+    if (it == layerEntities.end()) {
+        return {};
+    }
+    LayerBucket& bucket = it->second;
+    if (bucket.dirty) {
+        compactLayerBucket(layer, bucket);
+    }
+    std::vector<RS_Entity*> ret;
+    ret.reserve(bucket.entries.size());
+    for (const auto& entry: bucket.entries) {
+        ret.push_back(entry.second);
+    }
+    return ret;
+}
+
+std::vector<RS_Entity*> RS_Graphic::getLayerEntitiesByName(const QString& layerName) const
+{
+    ensureLayerEntities();
+    std::vector<std::pair<long long, RS_Entity*>> entries;
+    for (auto& [layer, bucket]: layerEntities) {
+        // buckets emptied by moving entities away may outlive their layer
+        if (layer == nullptr || bucket.live == 0 || layer->getName() != layerName) {
+            continue;
+        }
+        if (bucket.dirty) {
+            compactLayerBucket(layer, bucket);
+        }
+        entries.insert(entries.end(), bucket.entries.begin(), bucket.entries.end());
+    }
+    // more than one layer object of that name, e.g. a layer of a pasted entity
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    std::vector<RS_Entity*> ret;
+    ret.reserve(entries.size());
+    for (const auto& entry: entries) {
+        ret.push_back(entry.second);
+    }
+    return ret;
+}
+
+void RS_Graphic::ensureLayerEntities() const
+{
+    if (layerEntitiesValid) {
+        return;
+    }
+    layerEntities.clear();
+    layerMembers.clear();
+    layerMembers.reserve(entities.size());
+    long long order = 0;
+    for (RS_Entity* e: entities) {
+        const RS_Layer* layer = e->getLayer(false);
+        LayerBucket& bucket = layerEntities[layer];
+        bucket.entries.emplace_back(order, e);
+        bucket.live++;
+        layerMembers[e] = {layer, order};
+        order++;
+    }
+    layerFrontOrder = 0;
+    layerBackOrder = order - 1;
+    layerEntitiesValid = true;
+}
+
+/**
+ * Drops the stale entries of the bucket and restores the order of the entity list.
+ */
+void RS_Graphic::compactLayerBucket(const RS_Layer* layer, LayerBucket& bucket) const
+{
+    auto& entries = bucket.entries;
+    // an entry is stale if its entity is removed, on another layer, or a new entity at the same address
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [this, layer](const auto& entry) {
+        auto it = layerMembers.find(entry.second);
+        return it == layerMembers.end() || it->second.layer != layer || it->second.order != entry.first;
+    }), entries.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    // an entity moved away and back has two entries of the same order
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first == b.first;
+    }), entries.end());
+    bucket.dirty = false;
+}
+
+void RS_Graphic::addLayerEntry(RS_Entity* entity, const LayerMember& member)
+{
+    LayerBucket& bucket = layerEntities[member.layer];
+    // entities moved back and forth between layers leave stale entries
+    if (bucket.entries.size() > 2 * bucket.live + 32) {
+        compactLayerBucket(member.layer, bucket);
+    }
+    if (!bucket.entries.empty() && bucket.entries.back().first >= member.order) {
+        bucket.dirty = true;
+    }
+    bucket.entries.emplace_back(member.order, entity);
+    bucket.live++;
+}
+
+/**
+ * The buckets are kept by the changes of single entities, in constant time. Other changes of
+ * the list rebuild them once by the next query.
+ */
+void RS_Graphic::entityAdded(RS_Entity* entity, bool front)
+{
+    if (!layerEntitiesValid) {
+        return;
+    }
+    LayerMember member{entity->getLayer(false), front ? --layerFrontOrder : ++layerBackOrder};
+    layerMembers[entity] = member;
+    addLayerEntry(entity, member);
+}
+
+void RS_Graphic::entityRemoved(RS_Entity* entity)
+{
+    if (!layerEntitiesValid) {
+        return;
+    }
+    auto it = layerMembers.find(entity);
+    if (it == layerMembers.end()) {
+        return;
+    }
+    LayerBucket& bucket = layerEntities[it->second.layer];
+    bucket.live--;
+    bucket.dirty = true;
+    layerMembers.erase(it);
+}
+
+void RS_Graphic::entityListChanged()
+{
+    layerEntitiesValid = false;
+}
+
+void RS_Graphic::entityLayerChanged(RS_Entity* entity, [[maybe_unused]] RS_Layer* previous)
+{
+    if (!layerEntitiesValid) {
+        return;
+    }
+    // entities not in the list yet, e.g. new entities set to the active layer before they are added
+    auto it = layerMembers.find(entity);
+    if (it == layerMembers.end()) {
+        return;
+    }
+    LayerBucket& previousBucket = layerEntities[it->second.layer];
+    previousBucket.live--;
+    previousBucket.dirty = true;
+    it->second.layer = entity->getLayer(false);
+    addLayerEntry(entity, it->second);
+}
+
 /**
  * Removes the given layer and undoes all entities on it.
  */
@@ -157,14 +308,9 @@ void RS_Graphic::removeLayer(RS_Layer* layer) {
     if (layer != nullptr) {
         const QString &layerName = layer->getName();
         if (layerName != "0") {
-            std::vector<RS_Entity *> toRemove;
-//find entities on layer
-            for (RS_Entity *e: entities) {
-                if (e->getLayer() &&
-                    e->getLayer()->getName() == layerName) {
-                    toRemove.push_back(e);
-                }
-            }
+//find entities on layer. As in blocks, an entity is on the layer if its layer has the same
+// name, and top level entities resolve to their own layer, so it's enough to join the buckets
+            std::vector<RS_Entity *> toRemove = getLayerEntitiesByName(layerName);
 // remove all entities on that layer:
             if (!toRemove.empty()) {
                 startUndoCycle();
@@ -193,6 +339,7 @@ void RS_Graphic::removeLayer(RS_Layer* layer) {
                 e->setLayer("0");
             }
 
+            layerEntities.erase(layer);
             layerList.remove(layer);
         }
     }
@@ -368,7 +515,7 @@ bool RS_Graphic::save(bool isAutoSave) {
             RS_DEBUG->print("RS_Graphic::save: Format: %d", (int) actualType);
             RS_DEBUG->print("RS_Graphic::save: Export...");
 
-            ret = RS_FileIO::instance()->fileExport(*this, actualName, actualType);
+            ret = RS_FileIO::instance()->fileExportAtomic(*this, actualName, actualType);
             QFileInfo finfo(actualName);
             modifiedTime = finfo.lastModified();
             currentFileName = actualName;
@@ -960,6 +1107,21 @@ void RS_Graphic::setPaperScale(double s) {
     }
 }
 
+bool RS_Graphic::getActiveView(ActiveView& view) {
+    RS_GraphicView *gv = getGraphicView(); // fixme - eliminate this dependency!
+    if (gv == nullptr) {
+        view = activeView;
+        return activeView.center.valid;
+    }
+    LC_GraphicViewport *viewport = gv->getViewPort();
+    RS_Vector fac = viewport->getFactor();
+    view.height = gv->getHeight() / fac.y;
+    view.ratio = (double) gv->getWidth() / (double) gv->getHeight();
+    view.center = RS_Vector{(gv->getWidth() - viewport->getOffsetX()) / (fac.x * 2.0),
+                            (gv->getHeight() - viewport->getOffsetY()) / (fac.y * 2.0)};
+    return true;
+}
+
 /**
  * Centers drawing on page. Affects DXF variable $PINSBASE.
  */
@@ -24,6 +24,9 @@
 #ifndef RS_GRAPHIC_H
 #define RS_GRAPHIC_H
 
+#include <unordered_map>
+#include <vector>
+
 #include <QDateTime>
 
 #include "lc_ucslist.h"
@@ -55,6 +58,13 @@ public:
     }
 
     virtual unsigned countLayerEntities(RS_Layer* layer) const;
+    /**
+     * @return top level entities on the given layer by the order of the entity list,
+     * including undone entities. Served from per-layer lists, built on the first call
+     * and maintained by changes of the entity list and entity layers.
+     */
+    std::vector<RS_Entity*> getLayerEntities(RS_Layer* layer) const override;
+    void entityLayerChanged(RS_Entity* entity, RS_Layer* previous) override;
 
     RS_LayerList* getLayerList() override {return &layerList;}
     RS_BlockList* getBlockList() override {return &blockList;}
@@ -177,6 +187,23 @@ public:
     LC_UCS* getCurrentUCS() const;
     RS2::IsoGridViewType getIsoView() const;
     void setIsoView(RS2::IsoGridViewType viewType);
+    /**
+     * Active view written to the file: height and center in drawing
+     * units and the width/height ratio of the graphic view.
+     */
+    struct ActiveView {
+        double height = 0.;
+        double ratio = 0.;
+        RS_Vector center{false};
+    };
+    /**
+     * @return false if there is neither a graphic view nor a view set by setActiveView()
+     */
+    bool getActiveView(ActiveView& view);
+    /**
+     * Sets the active view of a document without graphic view, like a copy to save.
+     */
+    void setActiveView(const ActiveView& view) {activeView = view;}
     void centerToPage();
     bool fitToPage();
     bool isBiggerThanPaper();
@@ -285,8 +312,35 @@ public:
     void setAnglesCounterClockwise(bool on);
     QString formatAngle(double angle) const;
     QString formatLinear(double linear) const;
+protected:
+    void entityAdded(RS_Entity* entity, bool front) override;
+    void entityRemoved(RS_Entity* entity) override;
+    void entityListChanged() override;
+
 private:
+    /**
+     * Top level entities of a layer, by their order key. Entries of entities removed or moved to
+     * another layer stay until the bucket is compacted, so changes don't search the bucket.
+     */
+    struct LayerBucket {
+        std::vector<std::pair<long long, RS_Entity*>> entries;
+        // number of entities on the layer, the rest of the entries are stale
+        size_t live = 0;
+        // entries are stale or not in order
+        bool dirty = false;
+    };
+    // layer and position in the entity list of a top level entity
+    struct LayerMember {
+        const RS_Layer* layer = nullptr;
+        long long order = 0;
+    };
+
     bool BackupDrawingFile(const QString &filename);
+    void ensureLayerEntities() const;
+    // top level entities on layers of the given name, in the order of the list
+    std::vector<RS_Entity*> getLayerEntitiesByName(const QString& layerName) const;
+    void addLayerEntry(RS_Entity* entity, const LayerMember& member);
+    void compactLayerBucket(const RS_Layer* layer, LayerBucket& bucket) const;
     QDateTime modifiedTime;
     QString currentFileName; //keep a copy of filename for the modifiedTime
 
@@ -307,5 +361,16 @@ private:
     // Number of pages drawing occupies
     int pagesNumH = 1;
     int pagesNumV = 1;
+
+    // view of a document without graphic view, see setActiveView()
+    ActiveView activeView;
+
+    // top level entities by layer, valid if layerEntitiesValid is set
+    mutable std::unordered_map<const RS_Layer*, LayerBucket> layerEntities;
+    mutable std::unordered_map<const RS_Entity*, LayerMember> layerMembers;
+    // order keys of the first and the last entity of the list, prepended entities get smaller keys
+    mutable long long layerFrontOrder = 0;
+    mutable long long layerBackOrder = 0;
+    mutable bool layerEntitiesValid = false;
 };
 #endif
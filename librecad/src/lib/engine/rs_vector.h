@@ -31,6 +31,8 @@
 #include <vector>
 #include <iosfwd>
 
+#include <boost/container/small_vector.hpp>
+
 class QPointF;
 
 /**
@@ -173,7 +175,11 @@ public:
  */
 class RS_VectorSolutions {
 public:
+    /** most intersections have up to 4 points, which are kept without a heap allocation */
+    typedef boost::container::small_vector<RS_Vector, 4> container_type;
     typedef RS_Vector value_type;
+    typedef container_type::iterator iterator;
+    typedef container_type::const_iterator const_iterator;
     RS_VectorSolutions() = default;
     RS_VectorSolutions(std::vector<RS_Vector> vectors);
     RS_VectorSolutions(std::initializer_list<RS_Vector> list);
@@ -210,13 +216,13 @@ public:
                          double* dist=nullptr, size_t* index=nullptr) const;
     double getClosestDistance(const RS_Vector& coord,
                               int counts = -1); //default to search all
-    const std::vector<RS_Vector>& getVector() const;
-    std::vector<RS_Vector>::const_iterator cbegin() const;
-    std::vector<RS_Vector>::const_iterator cend() const;
-    std::vector<RS_Vector>::const_iterator begin() const;
-    std::vector<RS_Vector>::const_iterator end() const;
-    std::vector<RS_Vector>::iterator begin();
-    std::vector<RS_Vector>::iterator end();
+    std::vector<RS_Vector> getVector() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    iterator begin();
+    iterator end();
     void rotate(double ang);
     void rotate(const RS_Vector& angleVector);
     void rotate(const RS_Vector& center, double ang);
@@ -232,7 +238,7 @@ public:
                                       const RS_VectorSolutions& s);
 
 private:
-    std::vector<RS_Vector> vector;
+    container_type vector;
     bool tangent = false;
 };
 
@@ -25,11 +25,15 @@
 **
 **********************************************************************/
 
-#include<iostream>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
 #include "qc_applicationwindow.h"
 #include "rs_undocycle.h"
 #include "rs_undo.h"
 #include "rs_debug.h"
+#include "rs_settings.h"
 
 /**
  * @return Number of Cycles that can be undone.
@@ -78,10 +82,97 @@ void RS_Undo::addUndoCycle(std::shared_ptr<RS_UndoCycle> const& i) {
 
 //    undoList.insert(++undoPointer, i);
 	undoList.insert(undoList.begin() + (++undoPointer), i);
+    i->memory = i->estimateMemory();
+    undoMemory += i->memory;
 
     RS_DEBUG->print("RS_Undo::addUndoCycle: ok");
 }
 
+/**
+ * Removes the cycles from first up to, but not including, last from
+ * the undo list. Undoables, which are not part of any remaining cycle,
+ * are deleted.
+ */
+void RS_Undo::removeUndoCycles(size_t first, size_t last)
+{
+    if (first >= last) {
+        return;
+    }
+
+    // collect undoables of the removed cycles
+    std::set<RS_Undoable*> obsolete;
+    for (size_t i = first; i < last; ++i) {
+        const std::set<RS_Undoable*>& undoables = undoList[i]->getUndoables();
+        obsolete.insert(undoables.cbegin(), undoables.cend());
+        undoMemory -= undoList[i]->memory;
+    }
+
+    // keep undoables which are still used by the remaining cycles
+    for (size_t i = 0; i < undoList.size() && !obsolete.empty(); ++i) {
+        if (i >= first && i < last) {
+            continue;
+        }
+        const std::set<RS_Undoable*>& undoables = undoList[i]->getUndoables();
+        if (undoables.size() < obsolete.size()) {
+            for (RS_Undoable* u: undoables) {
+                obsolete.erase(u);
+            }
+        } else {
+            for (auto it = obsolete.begin(); it != obsolete.end();) {
+                it = undoables.count(*it) ? obsolete.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    undoList.erase(undoList.begin() + first, undoList.begin() + last);
+    if (undoPointer >= int(last)) {
+        undoPointer -= int(last - first);
+    } else if (undoPointer >= int(first)) {
+        undoPointer = int(first) - 1;
+    }
+
+    removeUndoables(obsolete);
+}
+
+/**
+ * Limits the undo list to the configured number of cycles and memory.
+ * The oldest cycles are dropped first; undoables deleted by them can't
+ * be restored anymore and are removed from the document.
+ */
+void RS_Undo::trimUndoList()
+{
+    // 0 is unlimited
+    const int maxCycles = LC_GET_ONE_INT("Defaults", "MaxUndoCycles", 1000);
+    const size_t maxMemory = size_t(std::max(LC_GET_ONE_INT("Defaults", "MaxUndoMemory", 512), 0)) << 20;
+
+    size_t count = 0;
+    size_t memory = undoMemory;
+    // only cycles, which are done, are dropped. The last one is always kept
+    while (int(count) < undoPointer) {
+        bool tooMany = maxCycles > 0 && undoList.size() - count > size_t(maxCycles);
+        bool tooLarge = maxMemory > 0 && memory > maxMemory;
+        if (!tooMany && !tooLarge) {
+            break;
+        }
+        memory -= undoList[count++]->memory;
+    }
+
+    if (count > 0) {
+        RS_DEBUG->print("RS_Undo::trimUndoList: dropping %zu undo cycles", count);
+        removeUndoCycles(0, count);
+    }
+}
+
+/**
+ * Deletes the given undoables one by one.
+ */
+void RS_Undo::removeUndoables(const std::set<RS_Undoable*>& undoables)
+{
+    for (RS_Undoable* u: undoables) {
+        removeUndoable(u);
+    }
+}
+
 
 
 /**
@@ -95,42 +186,9 @@ void RS_Undo::startUndoCycle()
         return;
     }
 
-    size_t  removePointer {static_cast<size_t>(undoPointer + 1)};
     // if there are undo cycles behind undoPointer
     // remove obsolete entities and undoCycles
-    if (undoList.size() > removePointer) {
-        // collect remaining undoables
-        std::list<RS_Undoable*> keep;
-        for (auto it = undoList.begin(); it != undoList.begin() + removePointer; ++it) {
-            for (auto u: (*it)->getUndoables()){
-                keep.push_back( u);
-            }
-        }
-        keep.unique();
-
-        // collect obsolete undoables
-        std::list<RS_Undoable*> obsolete;
-        for (auto it = undoList.begin() + removePointer; it != undoList.end(); ++it) {
-            for (auto u: (*it)->getUndoables()){
-                obsolete.push_back( u);
-            }
-        }
-        // unique() only works correct on sorted list!
-        obsolete.sort();
-        obsolete.unique();
-
-        // delete obsolete undoables which are not in keep list
-        for (auto it = obsolete.begin(); it != obsolete.end(); ++it) {
-            if (keep.end() == std::find( keep.begin(), keep.end(), *it)) {
-                removeUndoable( *it);
-            }
-        }
-
-        // clean up obsolete undoCycles
-        while (undoList.size() > removePointer) {
-            undoList.pop_back();
-        }
-    }
+    removeUndoCycles(static_cast<size_t>(undoPointer + 1), undoList.size());
 
     // alloc new undoCycle
     currentCycle = std::make_shared<RS_UndoCycle>();
@@ -174,6 +232,7 @@ void RS_Undo::endUndoCycle()
     if (hasUndoable()) {
         // only keep the undoCycle, when it contains undoables
         addUndoCycle(currentCycle);
+        trimUndoList();
     }
 
     setGUIButtons();
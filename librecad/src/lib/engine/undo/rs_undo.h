@@ -29,7 +29,9 @@
 #ifndef RS_UNDO_H
 #define RS_UNDO_H
 
+#include <cstddef>
 #include <memory>
+#include <set>
 #include <vector>
 
 class RS_UndoCycle;
@@ -67,6 +69,12 @@ public:
      */
     virtual void removeUndoable(RS_Undoable* u) = 0;
 
+    /**
+     * Deletes all given Undoables, which are no longer in the undo
+     * buffer. The default calls removeUndoable() for each of them.
+     */
+    virtual void removeUndoables(const std::set<RS_Undoable*>& undoables);
+
     /**
 	  *\brief enable/disable redo/undo buttons in main application window
 	  *\author: Dongxu Li
@@ -80,6 +88,8 @@ public:
 private:
 
 	void addUndoCycle(std::shared_ptr<RS_UndoCycle> const& i);
+    void removeUndoCycles(size_t first, size_t last);
+    void trimUndoList();
     //! List of undo list items. every item is something that can be undone.
 	std::vector<std::shared_ptr<RS_UndoCycle>> undoList;
 
@@ -97,6 +107,9 @@ private:
     std::shared_ptr<RS_UndoCycle> currentCycle {nullptr};
 
     int refCount {0}; ///< reference counter for nested start/end calls
+
+    //! estimated memory held by all cycles of the undo list
+    size_t undoMemory {0};
 };
 
 
@@ -27,8 +27,28 @@
 
 
 #include <ostream>
+#include"rs_entitycontainer.h"
 #include"rs_undocycle.h"
 
+namespace {
+// rough size of an entity with its attributes, as allocated on the heap
+constexpr size_t entityMemory = 256;
+
+size_t estimateEntityMemory(const RS_Entity* e) {
+    size_t memory = entityMemory;
+    if (e->isContainer()) {
+        auto* ec = static_cast<const RS_EntityContainer*>(e);
+        // entities created on demand aren't there yet
+        if (!ec->hasDeferredEntities()) {
+            for (const RS_Entity* child: *ec) {
+                memory += estimateEntityMemory(child);
+            }
+        }
+    }
+    return memory;
+}
+}
+
 /**
  * Adds an Undoable to this Undo Cycle. Every Cycle can contain one or
  * more Undoables.
@@ -58,6 +78,19 @@ size_t RS_UndoCycle::size()
     return undoables.size();
 }
 
+size_t RS_UndoCycle::estimateMemory() const
+{
+    size_t memory = 0;
+    for (RS_Undoable* u: undoables) {
+        if (u->undoRtti() == RS2::UndoableEntity) {
+            memory += estimateEntityMemory(static_cast<RS_Entity*>(u));
+        } else {
+            memory += entityMemory;
+        }
+    }
+    return memory;
+}
+
 void RS_UndoCycle::changeUndoState()
 {
 	for (RS_Undoable* u: undoables)
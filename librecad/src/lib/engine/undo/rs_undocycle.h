@@ -71,6 +71,11 @@ public:
      */
     size_t size(void);
 
+    /**
+     * Rough estimate of the memory held by the undoables of this cycle.
+     */
+    size_t estimateMemory() const;
+
 
     //! change undo state of all undoable in the current cycle
     void changeUndoState();
@@ -86,6 +91,8 @@ private:
     //RS2::UndoType type;
     //! List of entity id's that were affected by this action
     std::set<RS_Undoable*> undoables;
+    //! estimated memory, as counted by RS_Undo when the cycle was added
+    size_t memory = 0;
 };
 
 #endif
@@ -0,0 +1,154 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+#include "lc_endpointgraph.h"
+#include "rs_entity.h"
+#include "rs_vector.h"
+
+namespace {
+// cell indexes are clamped, so far away points share the border cells instead of overflowing
+constexpr double g_maxCellIndex = 4.5e15;
+}
+
+LC_EndpointGraph::LC_EndpointGraph(const LC_EndpointGraph& /*other*/)
+{}
+
+LC_EndpointGraph& LC_EndpointGraph::operator = (const LC_EndpointGraph& other)
+{
+    if (this != &other) {
+        invalidate();
+    }
+    return *this;
+}
+
+size_t LC_EndpointGraph::CellHash::operator()(const Cell& cell) const {
+    const size_t hx = std::hash<std::int64_t>{}(cell[0]);
+    const size_t hy = std::hash<std::int64_t>{}(cell[1]);
+    return hx ^ (hy + 0x9e3779b97f4a7c15ULL + (hx << 6) + (hx >> 2));
+}
+
+void LC_EndpointGraph::reset(double tolerance) {
+    assert(tolerance > 0.);
+    m_cells.clear();
+    m_entries.clear();
+    m_tolerance = tolerance;
+    m_nextOrder = 0;
+    m_valid = true;
+}
+
+void LC_EndpointGraph::invalidate() {
+    m_cells.clear();
+    m_entries.clear();
+    m_valid = false;
+}
+
+LC_EndpointGraph::Cell LC_EndpointGraph::getCell(double x, double y) const {
+    auto index = [size = m_tolerance](double value) {
+        return static_cast<std::int64_t>(std::clamp(std::floor(value / size), -g_maxCellIndex, g_maxCellIndex));
+    };
+    return {{index(x), index(y)}};
+}
+
+void LC_EndpointGraph::insert(RS_Entity* entity) {
+    if (entity == nullptr || !m_valid || m_entries.count(entity) != 0) {
+        return;
+    }
+    const RS_Vector start = entity->getStartpoint();
+    const RS_Vector end = entity->getEndpoint();
+    if (!start.valid || !end.valid) {
+        return;
+    }
+    const size_t order = m_nextOrder++;
+    Entry entry{getCell(start.x, start.y), getCell(end.x, end.y)};
+    m_cells[entry.start].push_back({entity, start.x, start.y, order});
+    m_cells[entry.end].push_back({entity, end.x, end.y, order});
+    m_entries.emplace(entity, entry);
+}
+
+void LC_EndpointGraph::removeNode(const Cell& cell, RS_Entity* entity) {
+    auto it = m_cells.find(cell);
+    if (it == m_cells.end()) {
+        return;
+    }
+    std::vector<Node>& nodes = it->second;
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [entity](const Node& node) {
+        return node.entity == entity;
+    }), nodes.end());
+    if (nodes.empty()) {
+        m_cells.erase(it);
+    }
+}
+
+bool LC_EndpointGraph::remove(RS_Entity* entity) {
+    auto it = m_entries.find(entity);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    removeNode(it->second.start, entity);
+    removeNode(it->second.end, entity);
+    m_entries.erase(it);
+    return true;
+}
+
+std::vector<RS_Entity*> LC_EndpointGraph::getConnected(const RS_Vector& point) const {
+    std::vector<const Node*> found;
+    if (!m_valid || !point.valid) {
+        return {};
+    }
+    const Cell center = getCell(point.x, point.y);
+    const double tolerance2 = m_tolerance * m_tolerance;
+    for (std::int64_t i = -1; i <= 1; i++) {
+        for (std::int64_t j = -1; j <= 1; j++) {
+            auto it = m_cells.find({{center[0] + i, center[1] + j}});
+            if (it == m_cells.end()) {
+                continue;
+            }
+            for (const Node& node: it->second) {
+                const double dx = node.x - point.x;
+                const double dy = node.y - point.y;
+                if (dx * dx + dy * dy <= tolerance2) {
+                    found.push_back(&node);
+                }
+            }
+        }
+    }
+
+    // an entity is found once, even if both of its end points are close to the point
+    std::sort(found.begin(), found.end(), [](const Node* node0, const Node* node1) {
+        return node0->order < node1->order;
+    });
+    std::vector<RS_Entity*> connected;
+    connected.reserve(found.size());
+    for (const Node* node: found) {
+        if (connected.empty() || connected.back() != node->entity) {
+            connected.push_back(node->entity);
+        }
+    }
+    return connected;
+}
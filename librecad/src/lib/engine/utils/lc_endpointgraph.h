@@ -0,0 +1,105 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+#ifndef LC_ENDPOINTGRAPH_H
+#define LC_ENDPOINTGRAPH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class RS_Entity;
+class RS_Vector;
+
+/**
+ * Connectivity of entities by their start and end points.
+ *
+ * The end points are hashed into the cells of a grid, with the tolerance as the
+ * cell size, so the entities connected at a point are found by the 3x3 cells
+ * around the point, instead of checking all entities. Entities without a valid
+ * start or end point are not in the graph.
+ *
+ * The graph is a cache owned by a container, like the spatial index: it's invalid
+ * until reset(), and copies of a graph are invalid.
+ */
+class LC_EndpointGraph {
+public:
+    LC_EndpointGraph() = default;
+    LC_EndpointGraph(const LC_EndpointGraph& other);
+    LC_EndpointGraph& operator = (const LC_EndpointGraph& other);
+
+    bool isValid() const {
+        return m_valid;
+    }
+    double getTolerance() const {
+        return m_tolerance;
+    }
+    /**
+     * Clears the graph to a valid empty one, connecting points within the
+     * tolerance, which must be positive
+     */
+    void reset(double tolerance);
+    void invalidate();
+
+    /**
+     * Adds an entity after all entities in the graph
+     */
+    void insert(RS_Entity* entity);
+    bool remove(RS_Entity* entity);
+
+    /**
+     * @return entities with a start or end point within the tolerance to the point,
+     * in the order they were inserted
+     */
+    std::vector<RS_Entity*> getConnected(const RS_Vector& point) const;
+
+private:
+    using Cell = std::array<std::int64_t, 2>;
+    struct CellHash {
+        size_t operator()(const Cell& cell) const;
+    };
+    struct Node {
+        RS_Entity* entity = nullptr;
+        double x = 0.;
+        double y = 0.;
+        size_t order = 0;
+    };
+    /** the cells of the start and the end point of an entity */
+    struct Entry {
+        Cell start{};
+        Cell end{};
+    };
+
+    Cell getCell(double x, double y) const;
+    void removeNode(const Cell& cell, RS_Entity* entity);
+
+    std::unordered_map<Cell, std::vector<Node>, CellHash> m_cells;
+    std::unordered_map<RS_Entity*, Entry> m_entries;
+    double m_tolerance = 0.;
+    size_t m_nextOrder = 0;
+    bool m_valid = false;
+};
+
+#endif // LC_ENDPOINTGRAPH_H
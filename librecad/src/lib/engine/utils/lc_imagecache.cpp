@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "lc_imagecache.h"
+#include "rs_debug.h"
+
+LC_CachedImage::LC_CachedImage(const QImage& image):
+    m_width{image.width()}
+    , m_height{image.height()}
+    , m_levels{image}
+{
+}
+
+QImage LC_CachedImage::image() const {
+    QMutexLocker lock{&m_mutex};
+    return m_levels.front();
+}
+
+QImage LC_CachedImage::level(double scale) const {
+    int index = 0;
+    if (scale > 0. && scale < 0.5) {
+        index = int(std::floor(-std::log2(scale)));
+    }
+
+    QMutexLocker lock{&m_mutex};
+    while (int(m_levels.size()) <= index) {
+        const QImage& last = m_levels.back();
+        if (last.width() <= 1 && last.height() <= 1) {
+            break;
+        }
+        m_levels.push_back(last.scaled(std::max(last.width() / 2, 1), std::max(last.height() / 2, 1),
+                                       Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+    return m_levels[std::min(index, int(m_levels.size()) - 1)];
+}
+
+LC_ImageCache* LC_ImageCache::instance() {
+    static LC_ImageCache instance;
+    return &instance;
+}
+
+std::shared_ptr<const LC_CachedImage> LC_ImageCache::find(const QString& fileName) {
+    QFileInfo info{fileName};
+    if (!info.isFile()) {
+        return nullptr;
+    }
+    const QString key = info.canonicalFilePath() + '|' + QString::number(info.lastModified().toMSecsSinceEpoch());
+
+    QMutexLocker lock{&m_mutex};
+    auto it = m_images.find(key);
+    if (it != m_images.end()) {
+        if (auto image = it->lock()) {
+            return image;
+        }
+    }
+
+    QImage decoded{fileName};
+    if (decoded.isNull()) {
+        return nullptr;
+    }
+    RS_DEBUG->print("LC_ImageCache::find: decoded %s", fileName.toLatin1().data());
+
+    // forget images no longer used by any entity
+    for (auto entry = m_images.begin(); entry != m_images.end();) {
+        entry = entry->expired() ? m_images.erase(entry) : std::next(entry);
+    }
+    auto image = std::make_shared<const LC_CachedImage>(decoded);
+    m_images.insert(key, image);
+    return image;
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#ifndef LC_IMAGECACHE_H
+#define LC_IMAGECACHE_H
+
+#include <memory>
+#include <vector>
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+#define LC_IMAGECACHE LC_ImageCache::instance()
+
+/**
+ * A decoded raster image, shared by all image entities showing the same
+ * file. Besides the full image, it keeps a pyramid of levels, each half the
+ * size of the previous one, to draw images at small zoom factors.
+ */
+class LC_CachedImage {
+public:
+    explicit LC_CachedImage(const QImage& image);
+
+    int width() const {
+        return m_width;
+    }
+    int height() const {
+        return m_height;
+    }
+    /** @return the image in full resolution */
+    QImage image() const;
+    /**
+     * @brief level the smallest level, which still has at least one pixel
+     * per device pixel. Levels are created on first use.
+     * @param scale device pixels per pixel of the full image
+     */
+    QImage level(double scale) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    mutable QMutex m_mutex;
+    mutable std::vector<QImage> m_levels;
+};
+
+/**
+ * Process wide cache of decoded images, keyed by the file and its time of
+ * modification. An image is decoded once and released when the last image
+ * entity using it is gone. Changed files are decoded again.
+ */
+class LC_ImageCache {
+public:
+    static LC_ImageCache* instance();
+
+    LC_ImageCache(const LC_ImageCache&) = delete;
+    LC_ImageCache& operator = (const LC_ImageCache&) = delete;
+
+    /**
+     * @return the decoded image of the file, nullptr if the file can't
+     * be read.
+     */
+    std::shared_ptr<const LC_CachedImage> find(const QString& fileName);
+
+private:
+    LC_ImageCache() = default;
+
+    QMutex m_mutex;
+    QHash<QString, std::weak_ptr<const LC_CachedImage>> m_images;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+
+#include <QThread>
+#include <QThreadPool>
+
+#include "lc_parallelupdate.h"
+#include "rs_debug.h"
+#include "rs_entity.h"
+#include "rs_entitycontainer.h"
+#include "rs_settings.h"
+
+int LC_ParallelUpdate::workerCount() {
+    int workers = LC_GET_ONE_INT("Render", "RegenerationThreads", 0);
+    return workers > 0 ? workers : QThread::idealThreadCount();
+}
+
+void LC_ParallelUpdate::update(const std::vector<RS_Entity*>& entities, int workers) {
+    update(entities, [](RS_Entity* e) {
+        e->update();
+    }, workers);
+}
+
+void LC_ParallelUpdate::update(const std::vector<RS_Entity*>& entities,
+                               const std::function<void(RS_Entity*)>& updateEntity, int workers) {
+    workers = std::min(workers, int(entities.size()));
+    if (workers <= 1) {
+        for (RS_Entity* e: entities) {
+            updateEntity(e);
+        }
+        return;
+    }
+
+    RS_DEBUG->print("LC_ParallelUpdate::update: %zu entities, %d workers", entities.size(), workers);
+    // the parents are shared by the workers, they are updated below
+    for (RS_Entity* e: entities) {
+        if (e->isContainer()) {
+            static_cast<RS_EntityContainer*>(e)->suspendParentUpdates(true);
+        }
+    }
+    QThreadPool pool;
+    pool.setMaxThreadCount(workers);
+    // each worker takes the next entity when done, to balance entities of different cost
+    std::atomic<size_t> next{0};
+    for (int i = 0; i < workers; ++i) {
+        pool.start([&entities, &updateEntity, &next]() {
+            for (size_t k = next++; k < entities.size(); k = next++) {
+                updateEntity(entities[k]);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    // the entities are regenerated in place
+    for (RS_Entity* e: entities) {
+        if (e->isContainer()) {
+            static_cast<RS_EntityContainer*>(e)->suspendParentUpdates(false);
+        }
+        if (e->getParent() != nullptr) {
+            e->getParent()->updateSpatialIndex(e);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#ifndef LC_PARALLELUPDATE_H
+#define LC_PARALLELUPDATE_H
+
+#include <functional>
+#include <vector>
+
+class RS_Entity;
+
+/**
+ * Regenerates independent entities by a pool of worker threads.
+ *
+ * The update of an entity may only modify the entity itself and its own
+ * sub-entities. Shared resources, like hatch patterns, are requested before
+ * and passed to the update, see RS_Hatch::regenerate(). Nothing is logged by
+ * the workers.
+ */
+namespace LC_ParallelUpdate {
+    /**
+     * @return the number of worker threads from the settings, the ideal
+     * thread count of the system for the default of 0
+     */
+    int workerCount();
+    /**
+     * @brief update calls update() of all entities, returns when all are done.
+     * With one worker, the entities are updated in order by the calling thread.
+     * Otherwise containers don't tell their parents of their changes while the workers
+     * run, see RS_EntityContainer::suspendParentUpdates(). The calling thread updates
+     * the parents after all workers are done.
+     */
+    void update(const std::vector<RS_Entity*>& entities, int workers = workerCount());
+    /**
+     * @brief update calls updateEntity for all entities, by the same rules
+     */
+    void update(const std::vector<RS_Entity*>& entities, const std::function<void(RS_Entity*)>& updateEntity,
+                int workers = workerCount());
+}
+
+#endif
@@ -28,6 +28,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <boost/geometry/geometries/register/point.hpp>
 #include <boost/geometry/index/rtree.hpp>
 
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "lc_rect.h"
 #include "lc_rtree.h"
 #include "rs.h"
@@ -165,6 +170,185 @@ RS_VectorSolutions RTree::PointsInBox(const Area& area) const
     return m_pRTree->Intersects(box);
 }
 
+/**
+ * The tree value of an entity: {extent, entity, order}
+ */
+using EntityValue = std::tuple<BBox, RS_Entity*, long>;
+
+struct EntityRTree::EntityRTreeImpl: public bgi::rtree< EntityValue, bgi::quadratic<16> >
+{
+    static BBox ToBox(const Area& area)
+    {
+        return {{area.minP().x, area.minP().y}, {area.maxP().x, area.maxP().y}};
+    }
+
+    long NextOrder(bool front)
+    {
+        return front ? --m_front : ++m_back;
+    }
+
+    void Add(RS_Entity* entity, const Area& extent, long order)
+    {
+        EntityValue value{ToBox(extent), entity, order};
+        insert(value);
+        m_values[entity] = value;
+    }
+
+    void AddUnbounded(RS_Entity* entity, long order)
+    {
+        m_unbounded[entity] = order;
+    }
+
+    // remove an entity, and return its order
+    bool Take(const RS_Entity* entity, long& order)
+    {
+        auto it = m_values.find(entity);
+        if (it != m_values.end()) {
+            order = std::get<2>(it->second);
+            remove(it->second);
+            m_values.erase(it);
+            return true;
+        }
+        auto itUnbounded = m_unbounded.find(entity);
+        if (itUnbounded != m_unbounded.end()) {
+            order = itUnbounded->second;
+            m_unbounded.erase(itUnbounded);
+            return true;
+        }
+        return false;
+    }
+
+    std::unordered_map<const RS_Entity*, EntityValue> m_values;
+    std::unordered_map<const RS_Entity*, long> m_unbounded;
+    long m_front = 0;
+    long m_back = 0;
+};
+
+EntityRTree::EntityRTree() = default;
+
+EntityRTree::EntityRTree(const EntityRTree& /*other*/)
+{}
+
+EntityRTree& EntityRTree::operator = (const EntityRTree& other)
+{
+    if (this != &other)
+        Invalidate();
+    return *this;
+}
+
+EntityRTree::~EntityRTree() = default;
+
+bool EntityRTree::IsValid() const
+{
+    return m_pImpl != nullptr;
+}
+
+void EntityRTree::Reset()
+{
+    m_pImpl = std::make_unique<EntityRTreeImpl>();
+}
+
+void EntityRTree::Invalidate()
+{
+    m_pImpl.reset();
+}
+
+void EntityRTree::Insert(RS_Entity* entity, const Area& extent, bool front)
+{
+    if (!IsValid() || entity == nullptr)
+        return;
+    long order = 0;
+    m_pImpl->Take(entity, order);
+    m_pImpl->Add(entity, extent, m_pImpl->NextOrder(front));
+}
+
+void EntityRTree::InsertUnbounded(RS_Entity* entity, bool front)
+{
+    if (!IsValid() || entity == nullptr)
+        return;
+    long order = 0;
+    m_pImpl->Take(entity, order);
+    m_pImpl->AddUnbounded(entity, m_pImpl->NextOrder(front));
+}
+
+bool EntityRTree::Update(RS_Entity* entity, const Area& extent)
+{
+    long order = 0;
+    if (!IsValid() || !m_pImpl->Take(entity, order))
+        return false;
+    m_pImpl->Add(entity, extent, order);
+    return true;
+}
+
+bool EntityRTree::UpdateUnbounded(RS_Entity* entity)
+{
+    long order = 0;
+    if (!IsValid() || !m_pImpl->Take(entity, order))
+        return false;
+    m_pImpl->AddUnbounded(entity, order);
+    return true;
+}
+
+bool EntityRTree::Remove(const RS_Entity* entity)
+{
+    long order = 0;
+    return IsValid() && m_pImpl->Take(entity, order);
+}
+
+bool EntityRTree::Contains(const RS_Entity* entity) const
+{
+    return IsValid() && (m_pImpl->m_values.count(entity) == 1 || m_pImpl->m_unbounded.count(entity) == 1);
+}
+
+size_t EntityRTree::Size() const
+{
+    return IsValid() ? m_pImpl->m_values.size() + m_pImpl->m_unbounded.size() : 0;
+}
+
+std::vector<RS_Entity*> EntityRTree::EntitiesInBox(const Area& area) const
+{
+    if (!IsValid())
+        return {};
+
+    std::vector<std::pair<long, RS_Entity*>> found;
+    for(const auto& [entity, order]: m_pImpl->m_unbounded)
+        found.emplace_back(order, const_cast<RS_Entity*>(entity));
+
+    std::vector<EntityValue> values;
+    m_pImpl->query(bgi::intersects(EntityRTreeImpl::ToBox(area)), std::back_inserter(values));
+    for(const auto& [box, entity, order]: values)
+        found.emplace_back(order, entity);
+
+    std::sort(found.begin(), found.end());
+    std::vector<RS_Entity*> ret;
+    ret.reserve(found.size());
+    for(const auto& item: found)
+        ret.push_back(item.second);
+    return ret;
+}
+
+void EntityRTree::VisitNearest(const RS_Vector& point, const Visitor& visitor) const
+{
+    if (!IsValid())
+        return;
+
+    for(const auto& [entity, order]: m_pImpl->m_unbounded) {
+        if (!visitor(const_cast<RS_Entity*>(entity), 0., order))
+            return;
+    }
+
+    if (m_pImpl->empty())
+        return;
+
+    // the incremental nearest query returns values by increasing distance
+    const BPoint bPoint{point.x, point.y};
+    for (auto it = m_pImpl->qbegin(bgi::nearest(bPoint, unsigned(m_pImpl->size()))); it != m_pImpl->qend(); ++it) {
+        const auto& [box, entity, order] = *it;
+        if (!visitor(entity, bg::distance(bPoint, box), order))
+            return;
+    }
+}
+
 } // namespace geo
 } // namespace lc
 //EOF
@@ -24,8 +24,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #ifndef LC_RTree_H
 #define LC_RTree_H
 
+#include <functional>
 #include <memory>
+#include <vector>
 
+class RS_Entity;
 class RS_Vector;
 class RS_VectorSolutions;
 
@@ -83,10 +86,84 @@ private:
     struct RTreeImpl;
     std::unique_ptr<RTreeImpl> m_pRTree;
 };
+
+/**
+ * @brief EntityRTree R-Tree of entity extents, the spatial index of entity containers
+ *        Each entity is stored with its extent and an order number. The order
+ *        follows the entity order of the owning container, so nearest queries can
+ *        break ties the same way as a linear scan of the container.
+ *        Entities without a finite extent, like construction lines, are kept aside
+ *        and are reported by every query.
+ *        The index is a cache owned by a container: it's invalid until Reset() is
+ *        called, and a copy of an index is always an invalid one.
+ */
+class EntityRTree {
+public:
+    /**
+     * @brief Visitor callback for VisitNearest()
+     * @param entity - the entity found
+     * @param distance - distance from the query point to the entity extent, a lower
+     *                   bound of the distance to any point of the entity
+     * @param order - the order of the entity in its container
+     * @return false to stop the query
+     */
+    using Visitor = std::function<bool(RS_Entity* entity, double distance, long order)>;
+
+    EntityRTree();
+    EntityRTree(const EntityRTree& other);
+    EntityRTree& operator = (const EntityRTree& other);
+    ~EntityRTree();
+
+    /**
+     * @brief IsValid whether the index is built and kept in sync
+     */
+    bool IsValid() const;
+    /**
+     * @brief Reset clear the index to a valid empty one
+     */
+    void Reset();
+    /**
+     * @brief Invalidate drop the index content, after this call the index is not valid
+     */
+    void Invalidate();
+
+    /**
+     * @brief Insert an entity with its extent
+     * @param front - true, if the entity is placed before all other entities in
+     *                the container; false, if placed after all others
+     */
+    void Insert(RS_Entity* entity, const Area& extent, bool front = false);
+    void InsertUnbounded(RS_Entity* entity, bool front = false);
+    /**
+     * @brief Update the extent of an indexed entity, keeping its order
+     * @return false, if the entity is not in the index
+     */
+    bool Update(RS_Entity* entity, const Area& extent);
+    bool UpdateUnbounded(RS_Entity* entity);
+    bool Remove(const RS_Entity* entity);
+    bool Contains(const RS_Entity* entity) const;
+    size_t Size() const;
+
+    /**
+     * @brief EntitiesInBox all entities whose extent intersects the given box
+     * @return entities by their order in the container
+     */
+    std::vector<RS_Entity*> EntitiesInBox(const Area& area) const;
+    /**
+     * @brief VisitNearest visit entities by increasing distance from the point to
+     *        their extents. Unbounded entities are visited first with zero distance.
+     */
+    void VisitNearest(const RS_Vector& point, const Visitor& visitor) const;
+
+private:
+    struct EntityRTreeImpl;
+    std::unique_ptr<EntityRTreeImpl> m_pImpl;
+};
 } // geo
 } // lc
 
 using LC_RTree = lc::geo::RTree;
+using LC_EntityRTree = lc::geo::EntityRTree;
 
 #endif
 //EOF
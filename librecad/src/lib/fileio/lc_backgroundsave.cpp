@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "lc_backgroundsave.h"
+#include "lc_ucs.h"
+#include "lc_view.h"
+#include "rs_block.h"
+#include "rs_debug.h"
+#include "rs_fileio.h"
+#include "rs_graphic.h"
+#include "rs_layer.h"
+
+LC_BackgroundSave::LC_BackgroundSave(RS_Graphic& document, QString fileName, RS2::FormatType type,
+                                     QObject* parent)
+    : QObject(parent)
+    , fileName{std::move(fileName)}
+    , type{type}
+{
+    copyDocument(document);
+}
+
+LC_BackgroundSave::~LC_BackgroundSave() {
+    if (thread != nullptr) {
+        thread->wait();
+    }
+}
+
+void LC_BackgroundSave::start() {
+    RS_DEBUG->print("LC_BackgroundSave::start: %s", fileName.toLatin1().data());
+    thread.reset(QThread::create([this]() {
+        success = RS_FileIO::instance()->fileExportAtomic(*snapshot, fileName, type,
+                                                          [this](int percent) {emit progress(percent);});
+    }));
+    // finished is emitted by the worker, the lambda runs in the thread of this object
+    connect(thread.get(), &QThread::finished, this, [this]() {
+        RS_DEBUG->print("LC_BackgroundSave: %s saved: %d", fileName.toLatin1().data(), success.load());
+        emit finished(success);
+    });
+    thread->start();
+}
+
+bool LC_BackgroundSave::isRunning() const {
+    return thread != nullptr && !thread->isFinished();
+}
+
+void LC_BackgroundSave::copyDocument(RS_Graphic& document) {
+    QElapsedTimer timer;
+    timer.start();
+    snapshot = std::make_unique<RS_Graphic>();
+    // the snapshot is only written, never queried by position
+    snapshot->setSpatialIndexEnabled(false);
+    snapshot->setVariableDictObject(document.getVariableDictObject());
+    snapshot->setMargins(document.getMarginLeft(), document.getMarginTop(),
+                         document.getMarginRight(), document.getMarginBottom());
+    snapshot->setPagesNum(document.getPagesNumHoriz(), document.getPagesNumVert());
+    RS_Graphic::ActiveView view;
+    if (document.getActiveView(view)) {
+        snapshot->setActiveView(view);
+    }
+
+    for (RS_Layer* layer: *document.getLayerList()) {
+        snapshot->addLayer(layer->clone());
+    }
+    if (document.getActiveLayer() != nullptr) {
+        snapshot->activateLayer(document.getActiveLayer()->getName());
+    }
+
+    for (RS_Block* block: *document.getBlockList()) {
+        if (block == nullptr || block->isUndone()) {
+            continue;
+        }
+        auto copy = new RS_Block(snapshot.get(),
+                                 RS_BlockData(block->getName(), block->getBasePoint(), block->isFrozen()));
+        copyEntities(*block, copy);
+        snapshot->addBlock(copy, false);
+    }
+    copyEntities(document, snapshot.get());
+
+    LC_UCSList* ucsList = document.getUCSList();
+    // the first is the WCS of every list
+    for (unsigned i = 1; i < ucsList->count(); i++) {
+        ucss.push_back(std::make_unique<LC_UCS>(*ucsList->at(i)));
+        snapshot->addUCS(ucss.back().get());
+    }
+    for (LC_View* v: *document.getViewList()) {
+        views.push_back(std::make_unique<LC_View>(*v));
+        if (v->isHasUCS()) {
+            ucss.push_back(std::make_unique<LC_UCS>(*v->getUCS()));
+            views.back()->setUCS(ucss.back().get());
+        }
+        snapshot->addNamedView(views.back().get());
+    }
+    RS_DEBUG->print("LC_BackgroundSave::copyDocument: %u entities cloned in %lld ms",
+                    snapshot->count(), (long long) timer.elapsed());
+}
+
+void LC_BackgroundSave::copyEntities(RS_EntityContainer& from, RS_EntityContainer* to) {
+    for (RS_Entity* e: from) {
+        if (e == nullptr || e->getFlag(RS2::FlagUndone)) {
+            continue;
+        }
+        RS_Entity* copy = e->clone();
+        copy->reparent(to);
+        copyLayers(copy);
+        to->addEntity(copy);
+    }
+}
+
+/**
+ * Sets the layers of the snapshot to a copied entity and its sub-entities,
+ * the layers of the document may be edited or removed during the save.
+ */
+void LC_BackgroundSave::copyLayers(RS_Entity* entity) {
+    RS_Layer* layer = entity->getLayer(false);
+    if (layer != nullptr) {
+        entity->setLayer(snapshot->findLayer(layer->getName()));
+    }
+    // the sub-entities of inserts are not saved
+    if (entity->isContainer() && entity->rtti() != RS2::EntityInsert) {
+        for (RS_Entity* e: *static_cast<RS_EntityContainer*>(entity)) {
+            copyLayers(e);
+        }
+    }
+}
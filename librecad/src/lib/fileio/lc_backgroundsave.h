@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+
+** Copyright (C) 2024 LibreCAD.org
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**********************************************************************/
+
+#ifndef LC_BACKGROUNDSAVE_H
+#define LC_BACKGROUNDSAVE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QString>
+
+#include "rs.h"
+
+class QThread;
+class LC_UCS;
+class LC_View;
+class RS_Entity;
+class RS_EntityContainer;
+class RS_Graphic;
+
+/**
+ * Saves a document by a worker thread while it is edited.
+ *
+ * The constructor copies the entities, layers, blocks, variables, views and
+ * UCSs of the document, start() writes the copy to the file. The file is
+ * replaced when it is complete, see RS_FileIO::fileExportAtomic().
+ * The copy is made by the thread of the document, so the worker never reads
+ * an entity, layer or block that can be edited during the save.
+ */
+class LC_BackgroundSave : public QObject {
+    Q_OBJECT
+public:
+    LC_BackgroundSave(RS_Graphic& document, QString fileName, RS2::FormatType type,
+                      QObject* parent = nullptr);
+    /**
+     * Waits for a running save.
+     */
+    ~LC_BackgroundSave() override;
+
+    void start();
+    bool isRunning() const;
+    const QString& getFileName() const {return fileName;}
+
+signals:
+    /**
+     * Percentage of the entities written.
+     */
+    void progress(int percent);
+    void finished(bool success);
+
+private:
+    void copyDocument(RS_Graphic& document);
+    void copyEntities(RS_EntityContainer& from, RS_EntityContainer* to);
+    void copyLayers(RS_Entity* entity);
+
+    // the lists of the copy don't own views and UCSs
+    std::vector<std::unique_ptr<LC_View>> views;
+    std::vector<std::unique_ptr<LC_UCS>> ucss;
+    std::unique_ptr<RS_Graphic> snapshot;
+    QString fileName;
+    RS2::FormatType type = RS2::FormatUnknown;
+    std::unique_ptr<QThread> thread;
+    std::atomic<bool> success{false};
+};
+
+#endif
@@ -26,6 +26,9 @@
 **********************************************************************/
 
 #include <cstddef>
+#include <filesystem>
+#include <system_error>
+#include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
 #ifdef DWGSUPPORT
@@ -213,7 +216,8 @@ RS2::FormatType RS_FileIO::detectFormat(QString const& file, bool forRead)
  * @param file Path and name of the file to import.
  */
 bool RS_FileIO::fileExport(RS_Graphic& graphic, const QString& file,
-                           RS2::FormatType type) {
+                           RS2::FormatType type,
+                           const std::function<void(int)>& progress) {
 
     RS_DEBUG->print("RS_FileIO::fileExport");
     //RS_DEBUG->print("Trying to export file '%s'...", file.latin1());
@@ -224,6 +228,7 @@ bool RS_FileIO::fileExport(RS_Graphic& graphic, const QString& file,
 
     std::unique_ptr<RS_FilterInterface>&& filter(getExportFilter(file, type));
     if (filter){
+        filter->setProgressFunction(progress);
         return filter->fileExport(graphic, file, type);
     }
     RS_DEBUG->print("RS_FileIO::fileExport: no filter found");
@@ -232,6 +237,53 @@ bool RS_FileIO::fileExport(RS_Graphic& graphic, const QString& file,
 }
 
 
+bool RS_FileIO::fileExportAtomic(RS_Graphic& graphic, const QString& file,
+                                 RS2::FormatType type,
+                                 const std::function<void(int)>& progress) {
+
+    RS_DEBUG->print("RS_FileIO::fileExportAtomic");
+
+    if (type==RS2::FormatUnknown) {
+        type=detectFormat(file, false);
+    }
+
+    // a symbolic link stays a link: the file it points to is replaced
+    QFileInfo finfo(file);
+    if (finfo.exists()) {
+        finfo.setFile(finfo.canonicalFilePath());
+    } else if (finfo.isSymLink()) {
+        finfo.setFile(finfo.symLinkTarget());
+    }
+    // same directory, so the rename does not move the data
+    QString tempFile = finfo.path() + "/.~" + finfo.fileName();
+    if (!fileExport(graphic, tempFile, type, progress)) {
+        QFile::remove(tempFile);
+        return false;
+    }
+    if (finfo.exists()) {
+        QFileInfo tempInfo(tempFile);
+        if (tempInfo.ownerId() != finfo.ownerId() || tempInfo.groupId() != finfo.groupId()) {
+            // the renamed file would belong to us, not to the owner of the replaced one:
+            // write the file in place instead
+            QFile::remove(tempFile);
+            return fileExport(graphic, finfo.filePath(), type, progress);
+        }
+        QFile::setPermissions(tempFile, finfo.permissions());
+    }
+
+    std::error_code error;
+    std::filesystem::rename(QFileInfo(tempFile).filesystemAbsoluteFilePath(),
+                            finfo.filesystemAbsoluteFilePath(), error);
+    if (error) {
+        RS_DEBUG->print(RS_Debug::D_WARNING, "RS_FileIO::fileExportAtomic: can't rename to %s: %s",
+                        finfo.filePath().toLatin1().data(), error.message().c_str());
+        QFile::remove(tempFile);
+        return false;
+    }
+    return true;
+}
+
+
 RS_FileIO* RS_FileIO::instance() {
     static RS_FileIO* uniqueInstance=nullptr;
     if (!uniqueInstance) {
@@ -69,7 +69,20 @@ public:
 		RS2::FormatType type = RS2::FormatUnknown);
 		
     bool fileExport(RS_Graphic& graphic, const QString& file,
-		RS2::FormatType type = RS2::FormatUnknown);
+		RS2::FormatType type = RS2::FormatUnknown,
+		const std::function<void(int)>& progress = {});
+	/**
+	 * \brief fileExportAtomic exports to a temporary file next to file and
+	 * renames it to file when complete, an existing file is replaced at once
+	 * and never left half written. A symbolic link is kept and the file it
+	 * points to is replaced. An existing file of another owner or group is
+	 * written in place, as the replacement would belong to the current user;
+	 * access control lists of a replaced file are not kept
+	 * \param progress called with the percentage of the written entities
+	 */
+	bool fileExportAtomic(RS_Graphic& graphic, const QString& file,
+		RS2::FormatType type = RS2::FormatUnknown,
+		const std::function<void(int)>& progress = {});
 	/** \brief detectFormat detect file format type
 	 * \param file type
 	 * \param forRead read the file to verify dxf/dxfrw type, default to true
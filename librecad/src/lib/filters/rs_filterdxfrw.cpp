@@ -24,6 +24,7 @@
 **********************************************************************/
 
 #include<cstdlib>
+#include <map>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QStringConverter>
@@ -59,6 +60,9 @@
 #include "rs_math.h"
 #include "dxf_format.h"
 #include "lc_defaults.h"
+#include "lc_parallelupdate.h"
+#include "rs_pattern.h"
+#include "rs_patternlist.h"
 
 #ifdef DWGSUPPORT
 #include "libdwgr.h"
@@ -158,6 +162,7 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, [[maybe_unus
     graphic = &g;
     currentContainer = graphic;
 	dummyContainer = new RS_EntityContainer(nullptr, true);
+    hatches.clear();
 
     this->file = file;
     // add some variables that need to be there for DXF drawings:
@@ -208,6 +213,10 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, [[maybe_unus
     }
 #endif
 
+    // hatches are listed with the orphan entities, update them before deleting those
+    RS_DEBUG->print("RS_FilterDXFRW::fileImport: updating hatches");
+    updateHatches();
+
     delete dummyContainer;
     /*set current layer */
     RS_Layer* cl = graphic->findLayer(graphic->getVariableString("$CLAYER", "0"));
@@ -223,6 +232,40 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, [[maybe_unus
     return true;
 }
 
+/**
+ * Updates the hatches read from the file. Hatches don't depend on each
+ * other, so the patterns are requested and the contours are validated
+ * first, and the hatches are regenerated by worker threads.
+ */
+void RS_FilterDXFRW::updateHatches() {
+    std::vector<RS_Entity*> parallel;
+    std::vector<RS_Entity*> serial;
+    // the workers don't touch the pattern list, they copy these patterns
+    std::map<QString, std::unique_ptr<RS_Pattern>> patterns;
+    for (RS_Hatch* hatch: hatches) {
+        if (hatch->getParent() == dummyContainer) {
+            continue;
+        }
+        if (!hatch->isSolid() && patterns.count(hatch->getPattern()) == 0) {
+            patterns.emplace(hatch->getPattern(), RS_PATTERNLIST->requestPattern(hatch->getPattern()));
+        }
+        // missing patterns and gaps in contours are reported by update(), by this thread only
+        if (hatch->isSolid() || (patterns.at(hatch->getPattern()) != nullptr && hatch->validate())) {
+            parallel.push_back(hatch);
+        } else {
+            serial.push_back(hatch);
+        }
+    }
+    hatches.clear();
+
+    LC_ParallelUpdate::update(parallel, [&patterns](RS_Entity* e) {
+        auto* hatch = static_cast<RS_Hatch*>(e);
+        const auto it = patterns.find(hatch->getPattern());
+        hatch->regenerate(it != patterns.cend() ? it->second.get() : nullptr);
+    });
+    LC_ParallelUpdate::update(serial, 1);
+}
+
 /**
  * Implementation of the method which handles layers.
  */
@@ -1336,9 +1379,9 @@ void RS_FilterDXFRW::addHatch(const DRW_Hatch *data) {
 
     }
 
-    RS_DEBUG->print("hatch->update()");
     if (hatch->validate()) {
-        hatch->update();
+        // updated with all hatches after reading
+        hatches.push_back(hatch);
     } else {
         graphic->removeEntity(hatch);
         RS_DEBUG->print(RS_Debug::D_ERROR,
@@ -2249,14 +2292,12 @@ void RS_FilterDXFRW::writeVports(){
         vp.gridBehavior = 7; //auto
         vp.gridSpacing.y = 10;
     }
-    RS_GraphicView *gv = graphic->getGraphicView();
-	if (gv ) {
-     LC_GraphicViewport *viewport = gv->getViewPort();
-     RS_Vector fac = viewport->getFactor();
-        vp.height = gv->getHeight()/fac.y;
-        vp.ratio = (double)gv->getWidth() / (double)gv->getHeight();
-        vp.center.x = ( gv->getWidth() - viewport->getOffsetX() )/ (fac.x * 2.0);
-        vp.center.y = ( gv->getHeight() - viewport->getOffsetY() )/ (fac.y * 2.0);
+    RS_Graphic::ActiveView view;
+    if (graphic->getActiveView(view)) {
+        vp.height = view.height;
+        vp.ratio = view.ratio;
+        vp.center.x = view.center.x;
+        vp.center.y = view.center.y;
     }
     dxfW->writeVport(&vp);
 }
@@ -2314,11 +2355,21 @@ void RS_FilterDXFRW::writeAppId(){
 }
 
 void RS_FilterDXFRW::writeEntities(){
+    const unsigned total = graphic->count();
+    unsigned written = 0;
+    int percent = 0;
     for (RS_Entity *e = graphic->firstEntity(RS2::ResolveNone);
 		 e ; e = graphic->nextEntity(RS2::ResolveNone)) {
         if ( !(e->getFlag(RS2::FlagUndone)) ) {
             writeEntity(e);
         }
+        if (progressFunction) {
+            int done = int(100ULL * ++written / total);
+            if (done != percent) {
+                percent = done;
+                progressFunction(percent);
+            }
+        }
     }
 }
 
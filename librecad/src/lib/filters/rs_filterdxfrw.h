@@ -27,6 +27,8 @@
 #ifndef RS_FILTERDXFRW_H
 #define RS_FILTERDXFRW_H
 
+#include <vector>
+
 #include "rs_filterinterface.h"
 
 #include "rs_color.h"
@@ -203,6 +205,7 @@ public:
 
 private:
     void prepareBlocks();
+    void updateHatches();
     void writeEntity(RS_Entity* e);
 #ifdef DWGSUPPORT
     void printDwgError(int le);
@@ -240,6 +243,8 @@ private:
     QHash<int, RS_EntityContainer*> blockHash;
     /** Pointer to entity container to store possible orphan entities like paper space */
     RS_EntityContainer* dummyContainer;
+    /** hatches read from the file, updated after reading */
+    std::vector<RS_Hatch*> hatches;
 };
 
 #endif
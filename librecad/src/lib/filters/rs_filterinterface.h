@@ -29,6 +29,8 @@
 #ifndef RS_FILTERINTERFACE_H
 #define RS_FILTERINTERFACE_H
 
+#include <functional>
+
 #include "rs_graphic.h"
 
 #include <QObject>
@@ -100,10 +102,20 @@ public:
         return errorCode;
     };
 
+    /**
+     * Sets the function fileExport() calls with the percentage of the
+     * entities written so far, from the thread running the export.
+     * Filters without progress reporting ignore it.
+     */
+    void setProgressFunction(std::function<void(int)> function) {
+        progressFunction = std::move(function);
+    }
+
     static RS_FilterInterface * createFilter(){return NULL;}
 
 protected:
     int errorCode {0};  //< error code for last import/export action
+    std::function<void(int)> progressFunction; //< progress of the export, may be empty
 };
 
 #endif
@@ -21,7 +21,11 @@
 ** 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 **
 **********************************************************************/
-#include<cmath>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <unordered_map>
+
 #include "lc_makercamsvg.h"
 
 #include "lc_xmlwriterinterface.h"
@@ -86,6 +90,11 @@ std::string LC_MakerCamSVG::resultAsString() {
     return xmlWriter->documentAsString();
 }
 
+bool LC_MakerCamSVG::finish() {
+
+    return xmlWriter->endDocument();
+}
+
 void LC_MakerCamSVG::write(RS_Graphic* graphic) {
 
     RS_DEBUG->print("RS_MakerCamSVG::write: Writing root node ...");
@@ -171,13 +180,28 @@ void LC_MakerCamSVG::writeLayers(RS_Document* document) {
 
     RS_LayerList* layerlist = document->getLayerList();
 
+    // graphics keep their entities by layer, other documents are grouped in a single pass
+    std::unordered_map<const RS_Layer*, std::vector<RS_Entity*>> layerEntities;
+    bool grouped = document->rtti() != RS2::EntityGraphic;
+    if (grouped) {
+        for (RS_Entity* e: *document) {
+            layerEntities[e->getLayer(false)].push_back(e);
+        }
+    }
+
     for (unsigned int i = 0; i < layerlist->count(); i++) {
 
-        writeLayer(document, layerlist->at(i));
+        RS_Layer* layer = layerlist->at(i);
+        if (grouped) {
+            writeLayer(layerEntities[layer], layer);
+        }
+        else {
+            writeLayer(document->getLayerEntities(layer), layer);
+        }
     }
 }
 
-void LC_MakerCamSVG::writeLayer(RS_Document* document, RS_Layer* layer) {
+void LC_MakerCamSVG::writeLayer(const std::vector<RS_Entity*>& entities, RS_Layer* layer) {
 
     if (writeInvisibleLayers || !layer->isFrozen()) {
 
@@ -201,7 +225,7 @@ void LC_MakerCamSVG::writeLayer(RS_Document* document, RS_Layer* layer) {
             xmlWriter->addAttribute("stroke", "black");
             xmlWriter->addAttribute("stroke-width", QString::number(defaultElementWidth).toStdString());
 
-            writeEntities(document, layer);
+            writeEntities(entities);
 
             xmlWriter->closeElement();
         }
@@ -218,18 +242,15 @@ void LC_MakerCamSVG::writeLayer(RS_Document* document, RS_Layer* layer) {
     }
 }
 
-void LC_MakerCamSVG::writeEntities(RS_Document* document, RS_Layer* layer) {
+void LC_MakerCamSVG::writeEntities(const std::vector<RS_Entity*>& entities) {
 
     RS_DEBUG->print("RS_MakerCamSVG::writeEntities: Writing entities from layer ...");
 
-	for (auto e: *document) {
-
-        if (e->getLayer() == layer) {
+    for (auto e: entities) {
 
-            if (!(e->getFlag(RS2::FlagUndone))) {
+        if (!(e->getFlag(RS2::FlagUndone))) {
 
-                writeEntity(e);
-            }
+            writeEntity(e);
         }
     }
 }
@@ -772,8 +793,28 @@ std::vector<RS_Vector> LC_MakerCamSVG::calcQuadraticBezierPoints(const std::vect
     return bezier_points;
 }
 
+/**
+ * Formats like RS_Utility::doubleToString(value, 8), i.e. with 8 decimals and without trailing zeros,
+ * but without the round trip through QString for each of the many numbers of a drawing.
+ */
 std::string LC_MakerCamSVG::numXml(double value) {
-
+#if defined(__cpp_lib_to_chars)
+    // room for the integer digits of any double
+    char str[400];
+    std::to_chars_result res = std::to_chars(str, str + sizeof(str), value, std::chars_format::fixed, 8);
+    if (res.ec == std::errc()) {
+        char* end = res.ptr;
+        if (std::find(str, end, '.') != end) {
+            while (end[-1] == '0') {
+                --end;
+            }
+            if (end[-1] == '.') {
+                --end;
+            }
+        }
+        return std::string(str, end);
+    }
+#endif
     return RS_Utility::doubleToString(value, 8).toStdString();
 }
 
@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rs.h"
 #include "rs_vector.h"
@@ -71,6 +72,11 @@ public:
 
     bool generate(RS_Graphic* graphic);
     std::string resultAsString();
+    /**
+     * @brief finish ends the document, for a writer streaming to a device instead of resultAsString()
+     * @return false, if writing to the device failed
+     */
+    bool finish();
     void setExportPoints(bool exportPoints) {
         m_exportPoints = exportPoints;
     }
@@ -82,9 +88,9 @@ private:
     void writeBlock(RS_Block* block);
 
     void writeLayers(RS_Document* document);
-    void writeLayer(RS_Document* document, RS_Layer* layer);
+    void writeLayer(const std::vector<RS_Entity*>& entities, RS_Layer* layer);
 
-    void writeEntities(RS_Document* document, RS_Layer* layer);
+    void writeEntities(const std::vector<RS_Entity*>& entities);
     void writeEntity(RS_Entity* entity);
 
     void writeInsert(RS_Insert* insert);
@@ -40,6 +40,12 @@ public:
 
     virtual std::string documentAsString() = 0;
 
+    /**
+     * Ends the document written directly to a device, instead of documentAsString().
+     * @return false, if writing to the device failed
+     */
+    virtual bool endDocument() = 0;
+
 	LC_XMLWriterInterface() = default;
 	virtual ~LC_XMLWriterInterface() = default;
 };
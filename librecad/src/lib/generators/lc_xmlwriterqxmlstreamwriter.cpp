@@ -32,6 +32,12 @@ LC_XMLWriterQXmlStreamWriter::LC_XMLWriterQXmlStreamWriter():
 	//xmlWriter->setEncoding("UTF-8");
 }
 
+LC_XMLWriterQXmlStreamWriter::LC_XMLWriterQXmlStreamWriter(QIODevice* device):
+	xmlWriter(new QXmlStreamWriter(device))
+{
+	xmlWriter->setAutoFormatting(true);
+}
+
 LC_XMLWriterQXmlStreamWriter::~LC_XMLWriterQXmlStreamWriter() = default;
 
 void LC_XMLWriterQXmlStreamWriter::createRootElement(const std::string &name, const std::string &namespace_uri) {
@@ -61,3 +67,9 @@ std::string LC_XMLWriterQXmlStreamWriter::documentAsString() {
 
     return xml.toStdString();
 }
+
+bool LC_XMLWriterQXmlStreamWriter::endDocument() {
+    xmlWriter->writeEndDocument();
+
+    return !xmlWriter->hasError();
+}
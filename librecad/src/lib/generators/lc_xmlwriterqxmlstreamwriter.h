@@ -28,11 +28,17 @@
 #include <memory>
 #include "lc_xmlwriterinterface.h"
 
+class QIODevice;
 class QXmlStreamWriter;
 
 class LC_XMLWriterQXmlStreamWriter : public LC_XMLWriterInterface {
 public:
 	LC_XMLWriterQXmlStreamWriter();
+    /**
+     * Writes the document to the device while it is generated, so no copy of the document is kept in memory.
+     * The device must be open for writing.
+     */
+    explicit LC_XMLWriterQXmlStreamWriter(QIODevice* device);
 
     ~LC_XMLWriterQXmlStreamWriter() override;
 
@@ -48,6 +54,8 @@ public:
 
     std::string documentAsString() override;
 
+    bool endDocument() override;
+
 private:
 
 	std::unique_ptr<QXmlStreamWriter> xmlWriter;
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *
+ This file is part of the LibreCAD project, a 2D CAD program
+
+ Copyright (C) 2025 LibreCAD.org
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ ******************************************************************************/
+
+#include "lc_intersectionjob.h"
+#include "lc_snapworker.h"
+#include "rs_entitycontainer.h"
+
+LC_SnapWorker::LC_SnapWorker(QObject* parent)
+    : QObject(parent) {
+    m_pool.setMaxThreadCount(1);
+}
+
+LC_SnapWorker::~LC_SnapWorker() {
+    // the result posted by a job in progress is discarded with this object
+    m_pool.waitForDone();
+}
+
+void LC_SnapWorker::setContainer(RS_EntityContainer* container) {
+    m_container = container;
+    // a new document may be allocated where a closed one was, the jobs are told apart by the number
+    ++m_containerNumber;
+    m_waiting.reset();
+}
+
+void LC_SnapWorker::solveIntersections(RS_Entity* entity) {
+    if (m_container == nullptr || entity == nullptr
+        || (m_running != nullptr && m_runningContainerNumber == m_containerNumber && m_running->getEntity() == entity)
+        || (m_waiting != nullptr && m_waiting->getEntity() == entity)) {
+        return;
+    }
+    std::shared_ptr<LC_IntersectionJob> job = m_container->prepareIntersectionJob(entity);
+    if (job == nullptr) {
+        return;
+    }
+    if (m_running != nullptr) {
+        m_waiting = std::move(job);
+    } else {
+        start(std::move(job));
+    }
+}
+
+void LC_SnapWorker::start(std::shared_ptr<LC_IntersectionJob> job) {
+    m_running = job;
+    m_runningContainerNumber = m_containerNumber;
+    m_pool.start([this, job = std::move(job), containerNumber = m_containerNumber]() mutable {
+        job->solve();
+        QMetaObject::invokeMethod(this, [this, job = std::move(job), containerNumber]() {
+            onJobDone(job, containerNumber);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LC_SnapWorker::onJobDone(const std::shared_ptr<LC_IntersectionJob>& job, unsigned long containerNumber) {
+    m_running.reset();
+    // the job of a previous document is dropped without looking at its entities
+    bool solved = containerNumber == m_containerNumber && m_container != nullptr
+                  && m_container->takeIntersectionJob(*job);
+    if (m_waiting != nullptr) {
+        start(std::move(m_waiting));
+    }
+    if (solved) {
+        emit intersectionsSolved();
+    }
+}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *
+ This file is part of the LibreCAD project, a 2D CAD program
+
+ Copyright (C) 2025 LibreCAD.org
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ ******************************************************************************/
+
+#ifndef LC_SNAPWORKER_H
+#define LC_SNAPWORKER_H
+
+#include <memory>
+
+#include <QObject>
+#include <QThreadPool>
+
+class LC_IntersectionJob;
+class RS_Entity;
+class RS_EntityContainer;
+
+/**
+ * Solves the intersections for snapping by a worker thread, so the GUI thread
+ * doesn't wait for them while the mouse moves.
+ *
+ * The jobs are prepared and their results are taken by the GUI thread, see
+ * RS_EntityContainer::prepareIntersectionJob(). One job is solved at a time:
+ * a job requested meanwhile waits, replacing any older waiting job, as the
+ * mouse has moved on. Results of a changed document are dropped.
+ *
+ * Only the intersection snap is solved here; the document itself is not read
+ * by the worker, which solves copies of the entities. The other snap modes,
+ * e.g. endpoints or the nearest point, and the entity highlighted by
+ * catchEntity() are found by the GUI thread as before. Until a job is done the
+ * snap falls back to these; the view then handles its last mouse move again,
+ * see QG_GraphicView::repeatMouseMove(), to move the crosshair onto the
+ * solved intersection.
+ */
+class LC_SnapWorker : public QObject {
+    Q_OBJECT
+public:
+    explicit LC_SnapWorker(QObject* parent = nullptr);
+    ~LC_SnapWorker() override;
+
+    /** Sets the document to snap in, dropping the jobs of the previous one */
+    void setContainer(RS_EntityContainer* container);
+    /** Solves the intersections of an entity of the document, unless they are solved already */
+    void solveIntersections(RS_Entity* entity);
+signals:
+    /** The intersections of an entity are cached by the document: snap again to find them */
+    void intersectionsSolved();
+private:
+    void start(std::shared_ptr<LC_IntersectionJob> job);
+    void onJobDone(const std::shared_ptr<LC_IntersectionJob>& job, unsigned long containerNumber);
+
+    RS_EntityContainer* m_container = nullptr;
+    /** counts the documents set, a job is taken only by the document it was prepared for */
+    unsigned long m_containerNumber = 0;
+    unsigned long m_runningContainerNumber = 0;
+    QThreadPool m_pool;
+    std::shared_ptr<LC_IntersectionJob> m_running;
+    std::shared_ptr<LC_IntersectionJob> m_waiting;
+};
+
+#endif // LC_SNAPWORKER_H
@@ -48,7 +48,7 @@ void LC_PrintViewportRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
     isVisibleTimer.start();
 #endif
     // entity is not visible:
-    bool visible = e->isVisible();
+    bool visible = isEntityVisible(e);
 #ifdef DEBUG_RENDERING
     isVisibleTime += isVisibleTimer.nsecsElapsed();
 #endif
@@ -59,12 +59,12 @@ void LC_PrintViewportRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
 #ifdef DEBUG_RENDERING
     isConstructionTimer.start();
 #endif
-    bool constructionEntity = e->isConstruction();
+    bool constructionEntity = isEntityConstruction(e);
 #ifdef DEBUG_RENDERING
     isConstructionTime += isConstructionTimer.nsecsElapsed();
 #endif
     // do not draw construction layer on print preview or print
-    if (!e->isPrint() || constructionEntity)
+    if (!isEntityPrinted(e) || constructionEntity)
         return;
 
     if (isOutsideOfBoundingClipRect(e, constructionEntity)) {
@@ -79,7 +79,7 @@ void LC_PrintViewportRenderer::setPenForPrintingEntity(RS_Painter *painter, RS_E
     setPenTimer.start();
 #endif
     // Getting pen from entity (or layer)
-    RS_Pen pen = e->getPenResolved();
+    RS_Pen pen = getEntityPen(e);
     RS_Pen originalPen = pen;
 
     double patternOffset = painter->currentDashOffset();
@@ -20,16 +20,28 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  ******************************************************************************/
 
+#include <QTransform>
+
 #include "lc_graphicviewportrenderer.h"
 #include "lc_graphicviewport.h"
+#include "rs_block.h"
 #include "rs_entity.h"
 #include "lc_rect.h"
+#include "rs_insert.h"
+#include "rs_line.h"
 #include "rs_painter.h"
 #include "rs_units.h"
 #include "rs_graphic.h"
 #include "lc_defaults.h"
 #include "lc_linemath.h"
 
+namespace {
+    // the affine transformation of the screen, which maps (0,0), (1,0) and (0,1) to the given points
+    QTransform toScreenBasis(const RS_Vector &origin, const RS_Vector &xAxis, const RS_Vector &yAxis) {
+        return {xAxis.x - origin.x, xAxis.y - origin.y, yAxis.x - origin.x, yAxis.y - origin.y, origin.x, origin.y};
+    }
+}
+
 LC_GraphicViewportRenderer::LC_GraphicViewportRenderer(LC_GraphicViewport* v, QPaintDevice* painterDevice):
     pd{painterDevice}
     , viewport{v}
@@ -47,13 +59,160 @@ void LC_GraphicViewportRenderer::renderEntityAsChild(RS_Painter *painter, RS_Ent
     drawEntityCount++;
     drawTimer.start();
 #endif
-    e->drawAsChild(painter);
+    if (!drawBlockLine(painter, e)) {
+        e->drawAsChild(painter);
+    }
 #ifdef DEBUG_RENDERING
     qint64 elapsed = drawTimer.nsecsElapsed();
     entityDrawTime+= elapsed;
 #endif
 }
 
+/**
+ * Draws the entities of the block of an insert through the transformation of each copy of the insert,
+ * without copies of the entities. The screen coordinates of the block are transformed by the painter,
+ * and the bounding clip rect is in block coordinates while the entities are drawn.
+ */
+void LC_GraphicViewportRenderer::renderInsertBlock(RS_Painter *painter, RS_Insert *insert) {
+    RS_Block *block = insert->getBlockForInsert();
+    if (block == nullptr) {
+        return;
+    }
+    for (const BlockContext &context: m_blockContexts) {
+        // a block which inserts itself ends there
+        if (context.block == block) {
+            return;
+        }
+    }
+    const QTransform previousTransform = painter->worldTransform();
+    const LC_Rect previousClipRect = renderBoundingClipRect;
+    m_blockContexts.push_back({insert, block,
+                               isDrawingBlock() ? getCopyAttributes(insert) : insert->getAttributes(),
+                               isEntitySelected(insert), isEntityHighlighted(insert),
+                               previousTransform, previousClipRect});
+    // nested inserts add contexts, which may move this one
+    const std::size_t contextIndex = m_blockContexts.size() - 1;
+
+    const LC_Rect blockRect{block->getMin(), block->getMax()};
+    const RS_Vector basePoint = block->getBasePoint();
+    const RS_Vector blockAxes[] = {basePoint, basePoint + RS_Vector{1., 0.}, basePoint + RS_Vector{0., 1.}};
+    const QTransform fromBlockScreen = toScreenBasis(painter->toGui(blockAxes[0]), painter->toGui(blockAxes[1]),
+                                                     painter->toGui(blockAxes[2])).inverted();
+
+    for (int col = 0; col < insert->getCols(); ++col) {
+        for (int row = 0; row < insert->getRows(); ++row) {
+            RS_Vector clipMin{RS_MAXDOUBLE, RS_MAXDOUBLE};
+            RS_Vector clipMax{RS_MINDOUBLE, RS_MINDOUBLE};
+            for (const RS_Vector &corner: previousClipRect.vertices()) {
+                const RS_Vector blockCorner = insert->toBlockCoordinates(corner, basePoint, col, row);
+                clipMin = RS_Vector::minimum(clipMin, blockCorner);
+                clipMax = RS_Vector::maximum(clipMax, blockCorner);
+            }
+            renderBoundingClipRect = LC_Rect{clipMin, clipMax};
+            if (!renderBoundingClipRect.intersects(blockRect)) {
+                continue;
+            }
+            m_blockContexts[contextIndex].col = col;
+            m_blockContexts[contextIndex].row = row;
+            const QTransform toInsertScreen = toScreenBasis(
+                painter->toGui(insert->toInsertCoordinates(blockAxes[0], basePoint, col, row)),
+                painter->toGui(insert->toInsertCoordinates(blockAxes[1], basePoint, col, row)),
+                painter->toGui(insert->toInsertCoordinates(blockAxes[2], basePoint, col, row)));
+            painter->setWorldBoundingRect(renderBoundingClipRect);
+            painter->setBlockTransform(fromBlockScreen * toInsertScreen * previousTransform, true);
+            // the pen of the painter is set again, as cosmetic pen
+            lastPaintEntityPen.setFlag(RS2::FlagInvalid);
+            for (RS_Entity *e: *block) {
+                painter->drawEntity(e);
+            }
+        }
+    }
+
+    m_blockContexts.pop_back();
+    renderBoundingClipRect = previousClipRect;
+    painter->setWorldBoundingRect(renderBoundingClipRect);
+    painter->setBlockTransform(previousTransform, isDrawingBlock());
+    lastPaintEntityPen.setFlag(RS2::FlagInvalid);
+}
+
+/**
+ * Draws a line of a block drawn, if its copy is drawn differently than the line itself. Copies of
+ * lines on construction layers are infinite lines of the drawing, see RS_Line::draw(), so they are
+ * drawn in drawing coordinates. A line on a construction layer "0" is a line of the insert layer.
+ * @return true, if the line is drawn
+ */
+bool LC_GraphicViewportRenderer::drawBlockLine(RS_Painter *painter, RS_Entity *e) {
+    if (!isDrawingBlock() || e->rtti() != RS2::EntityLine) {
+        return false;
+    }
+    auto *line = static_cast<RS_Line *>(e);
+    if (!isEntityConstruction(line)) {
+        if (!line->isConstruction()) {
+            return false;
+        }
+        painter->updateDashOffset(line);
+        painter->drawLineWCS(line->getStartpoint(), line->getEndpoint());
+        return true;
+    }
+
+    const BlockContext &outermost = m_blockContexts.front();
+    const QTransform blockTransform = painter->worldTransform();
+    const LC_Rect blockClipRect = renderBoundingClipRect;
+    renderBoundingClipRect = outermost.previousClipRect;
+    painter->setWorldBoundingRect(renderBoundingClipRect);
+    painter->setBlockTransform(outermost.previousTransform, false);
+    painter->drawInfiniteWCS(toDrawingCoordinates(line->getStartpoint()), toDrawingCoordinates(line->getEndpoint()));
+    renderBoundingClipRect = blockClipRect;
+    painter->setWorldBoundingRect(renderBoundingClipRect);
+    painter->setBlockTransform(blockTransform, true);
+    return true;
+}
+
+/**
+ * @return the position in the drawing of a point of the block drawn, for the copies drawn of all inserts
+ */
+RS_Vector LC_GraphicViewportRenderer::toDrawingCoordinates(RS_Vector blockPoint) const {
+    for (auto it = m_blockContexts.crbegin(); it != m_blockContexts.crend(); ++it) {
+        blockPoint = it->insert->toInsertCoordinates(blockPoint, it->block->getBasePoint(), it->col, it->row);
+    }
+    return blockPoint;
+}
+
+/**
+ * @return the attributes, which the copy of an entity of the block drawn would have, see RS_Insert::createEntities()
+ */
+RS_Insert::CopyAttributes LC_GraphicViewportRenderer::getCopyAttributes(const RS_Entity *e) const {
+    const BlockContext &context = m_blockContexts.back();
+    return context.insert->getCopyAttributes(e, context.attributes);
+}
+
+/**
+ * @return the resolved pen of an entity. Entities of a block drawn have the pen of their copies.
+ */
+RS_Pen LC_GraphicViewportRenderer::getEntityPen(const RS_Entity *e) const {
+    return isDrawingBlock() ? getCopyAttributes(e).penResolved : e->getPenResolved();
+}
+
+bool LC_GraphicViewportRenderer::isEntityVisible(const RS_Entity *e) const {
+    return isDrawingBlock() ? getCopyAttributes(e).isVisible(e) : e->isVisible();
+}
+
+bool LC_GraphicViewportRenderer::isEntityPrinted(const RS_Entity *e) const {
+    return isDrawingBlock() ? getCopyAttributes(e).isPrint() : e->isPrint();
+}
+
+bool LC_GraphicViewportRenderer::isEntityConstruction(const RS_Entity *e) const {
+    return isDrawingBlock() ? getCopyAttributes(e).isConstruction(e) : e->isConstruction();
+}
+
+bool LC_GraphicViewportRenderer::isEntitySelected(const RS_Entity *e) const {
+    return isDrawingBlock() ? m_blockContexts.back().selected : e->getFlag(RS2::FlagSelected);
+}
+
+bool LC_GraphicViewportRenderer::isEntityHighlighted(const RS_Entity *e) const {
+    return isDrawingBlock() ? m_blockContexts.back().highlighted : e->getFlag(RS2::FlagHighlighted);
+}
+
 void LC_GraphicViewportRenderer::loadSettings() {
     auto g = getGraphic();
     if (g != nullptr){
@@ -62,10 +221,15 @@ void LC_GraphicViewportRenderer::loadSettings() {
 }
 
 LC_Rect LC_GraphicViewportRenderer::prepareBoundingClipRect(){
-    int width = viewport->getWidth();
-    int height = viewport->getHeight();
-    const RS_Vector ucsViewportLeftBottom = viewport->toUCSFromGui(0, 0);
-    const RS_Vector ucsViewportRightTop = viewport->toUCSFromGui(width, height);
+    return prepareBoundingClipRect(0, 0, viewport->getWidth(), viewport->getHeight());
+}
+
+/**
+ * Bounding rect of the given part of the screen, in world coordinates
+ */
+LC_Rect LC_GraphicViewportRenderer::prepareBoundingClipRect(int left, int top, int right, int bottom) const{
+    const RS_Vector ucsViewportLeftBottom = viewport->toUCSFromGui(left, top);
+    const RS_Vector ucsViewportRightTop = viewport->toUCSFromGui(right, bottom);
 
     if (viewport->hasUCS()){
         // here were extend (enlarge) clipping rect to ensure that if there is shift/rotation in ucs, resulting bounding box cover the entire screen
@@ -121,7 +285,9 @@ void LC_GraphicViewportRenderer::justDrawEntity(RS_Painter *painter, RS_Entity *
     drawEntityCount++;
     drawTimer.start();
 #endif
-    e->draw(painter);
+    if (!drawBlockLine(painter, e)) {
+        e->draw(painter);
+    }
 #ifdef DEBUG_RENDERING
     qint64 elapsed = drawTimer.nsecsElapsed();
     entityDrawTime+= elapsed;
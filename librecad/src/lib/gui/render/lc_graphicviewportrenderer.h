@@ -23,8 +23,13 @@
 #ifndef LC_GRAPHICVIEWPORTRENDERER_H
 #define LC_GRAPHICVIEWPORTRENDERER_H
 
+#include <vector>
+
+#include <QTransform>
+
 #include "lc_rect.h"
 #include "rs_color.h"
+#include "rs_insert.h"
 #include "rs_pen.h"
 
 #define DEBUG_RENDERING_
@@ -36,6 +41,7 @@
 #endif
 
 class LC_GraphicViewport;
+class RS_Block;
 class RS_Entity;
 class RS_Painter;
 class RS_Graphic;
@@ -49,6 +55,7 @@ class LC_GraphicViewportRenderer{
     void render();
     virtual void renderEntity(RS_Painter* painter, RS_Entity* entity)  = 0;
     void renderEntityAsChild(RS_Painter *painter, RS_Entity *e) ;
+    void renderInsertBlock(RS_Painter *painter, RS_Insert *insert);
     void justDrawEntity(RS_Painter *painter, RS_Entity *e);
     void setBackground(const RS_Color &bg);
     const LC_Rect &getBoundingClipRect() const {return renderBoundingClipRect;}
@@ -76,7 +83,39 @@ protected:
 
     RS_Pen lastPaintEntityPen = {};
 
+    /**
+     * An insert drawn, the entities of its block take the attributes of their copies
+     * created by the insert, see RS_Insert::createEntities()
+     */
+    struct BlockContext{
+        RS_Insert* insert = nullptr;
+        RS_Block* block = nullptr;
+        RS_Insert::CopyAttributes attributes;
+        bool selected = false;
+        bool highlighted = false;
+        // the transformation and the clip rect before the insert is drawn
+        QTransform previousTransform;
+        LC_Rect previousClipRect;
+        // the copy drawn
+        int col = 0;
+        int row = 0;
+    };
+    // inserts drawn, the innermost last
+    std::vector<BlockContext> m_blockContexts;
+
+    bool isDrawingBlock() const {return !m_blockContexts.empty();}
+    RS_Insert::CopyAttributes getCopyAttributes(const RS_Entity *e) const;
+    RS_Pen getEntityPen(const RS_Entity *e) const;
+    bool isEntityVisible(const RS_Entity *e) const;
+    bool isEntityPrinted(const RS_Entity *e) const;
+    bool isEntityConstruction(const RS_Entity *e) const;
+    bool isEntitySelected(const RS_Entity *e) const;
+    bool isEntityHighlighted(const RS_Entity *e) const;
+    bool drawBlockLine(RS_Painter *painter, RS_Entity *e);
+    RS_Vector toDrawingCoordinates(RS_Vector blockPoint) const;
+
     LC_Rect prepareBoundingClipRect();
+    LC_Rect prepareBoundingClipRect(int left, int top, int right, int bottom) const;
     virtual void doRender() = 0;
 
     // painting cached values
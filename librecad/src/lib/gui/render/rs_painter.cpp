@@ -26,6 +26,7 @@
 #include<QPointF>
 
 #include "dxf_format.h"
+#include "lc_glyphrun.h"
 #include "lc_graphicviewport.h"
 #include "lc_graphicviewportrenderer.h"
 #include "lc_linemath.h"
@@ -1023,7 +1024,8 @@ void RS_Painter::drawImgUI(QImage& img, const RS_Vector& uiInsert,
     }
 
     wm->scale(factor.x, factor.y);
-    setWorldTransform(*wm);
+    // combined with the transformation of a block the image is in
+    setWorldTransform(*wm, true);
 
     drawImage(0,-img.height(), img);
 
@@ -1160,6 +1162,7 @@ void RS_Painter::setPen(const RS_Pen& pen) {
             p.setDashOffset(newDashOffset);
             p.setJoinStyle(penJoinStyle);
             p.setCapStyle(penCapStyle);
+            p.setCosmetic(drawingBlock);
             lastUsedPen = p;
             QPainter::setPen(p);
             return;
@@ -1180,6 +1183,11 @@ void RS_Painter::setPen(const RS_Pen& pen) {
         lastUsedPen.setStyle(style);
         changed = true;
     }
+    // the screen width is not scaled by the transformation of a block
+    if (lastUsedPen.isCosmetic() != drawingBlock){
+        lastUsedPen.setCosmetic(drawingBlock);
+        changed = true;
+    }
     lastUsedPen.setJoinStyle(penJoinStyle);
     lastUsedPen.setCapStyle(penCapStyle);
 
@@ -1435,8 +1443,64 @@ void RS_Painter::drawAsChild(RS_Entity* entity)
     renderer->renderEntityAsChild(this, entity);
 }
 
+void RS_Painter::drawInsertBlock(RS_Insert* insert)
+{
+    renderer->renderInsertBlock(this, insert);
+}
+
+/**
+ * Draws the outlines of the glyphs of a text as a single path. The layout of the glyphs is mapped to
+ * the screen by the transformation of the painter, the width of the pen stays in screen pixels.
+ */
+void RS_Painter::drawGlyphRun(const LC_GlyphRun &glyphRun)
+{
+    if (glyphRun.isEmpty()) {
+        return;
+    }
+    const RS_Vector uiOrigin = toGui(glyphRun.getOrigin());
+    const RS_Vector uiXAxis = toGui(glyphRun.getXAxis()) - uiOrigin;
+    const RS_Vector uiYAxis = toGui(glyphRun.getYAxis()) - uiOrigin;
+    const QTransform layoutToScreen{uiXAxis.x, uiXAxis.y, uiYAxis.x, uiYAxis.y, uiOrigin.x, uiOrigin.y};
+
+    const QTransform previousTransform = worldTransform();
+    const QPen previousPen = QPainter::pen();
+    QPen pen = previousPen;
+    pen.setCosmetic(true);
+    QPainter::setPen(pen);
+    setWorldTransform(layoutToScreen * previousTransform);
+    QPainter::drawPath(glyphRun.getOutline());
+    setWorldTransform(previousTransform);
+    QPainter::setPen(previousPen);
+}
+
+/**
+ * Sets the transformation of the screen coordinates, which draws the entities of a block as an insert
+ * transforms them. Widths of pens, sizes of points and minimal sizes of details stay in screen pixels.
+ * @param uiTransform complete world transformation of the painter
+ * @param block true while the entities of a block are drawn, false to end that
+ */
+void RS_Painter::setBlockTransform(const QTransform &uiTransform, bool block) {
+    if (block && !drawingBlock) {
+        unscaledLimits = {minCircleDrawingRadius, minArcDrawingRadius, minEllipseMajorRadius, minEllipseMinorRadius,
+                          minLineDrawingLen, arcRenderInterpolationMaxSagitta, screenPointsSize};
+    }
+    if (block || drawingBlock) {
+        blockDetailScale = block ? std::sqrt(std::abs(uiTransform.determinant())) : 1.0;
+        const double factor = 1.0 / blockDetailScale;
+        minCircleDrawingRadius = unscaledLimits.circleRadius * factor;
+        minArcDrawingRadius = unscaledLimits.arcRadius * factor;
+        minEllipseMajorRadius = unscaledLimits.ellipseMajorRadius * factor;
+        minEllipseMinorRadius = unscaledLimits.ellipseMinorRadius * factor;
+        minLineDrawingLen = unscaledLimits.lineLen * factor;
+        arcRenderInterpolationMaxSagitta = unscaledLimits.arcSagitta * factor;
+        screenPointsSize = static_cast<int>(std::lround(unscaledLimits.pointsSize * factor));
+    }
+    drawingBlock = block;
+    setWorldTransform(uiTransform);
+}
+
 bool RS_Painter::isTextLineNotRenderable(double wcsLineHeight) const {
-    double uiHeight = toGuiDY(wcsLineHeight);
+    double uiHeight = toGuiDY(wcsLineHeight) * blockDetailScale;
     return renderer->isTextLineNotRenderable(uiHeight);
 }
 
@@ -40,12 +40,14 @@
 #include "rs_vector.h"
 
 
+class LC_GlyphRun;
 class RS_Arc;
 class RS_Circle;
 class RS_Color;
 class RS_Ellipse;
 class RS_Entity;
 class RS_EntityContainer;
+class RS_Insert;
 class RS_Pen;
 class RS_Polyline;
 class RS_Spline;
@@ -153,6 +155,10 @@ public:
     // methods invoked from entity containers and printing
     void drawEntity(RS_Entity* entity);
     void drawAsChild(RS_Entity* entity);
+    void drawInsertBlock(RS_Insert* insert);
+    void drawGlyphRun(const LC_GlyphRun& glyphRun);
+    void setBlockTransform(const QTransform& uiTransform, bool block);
+    bool isDrawingBlock() const {return drawingBlock;}
     void drawInfiniteWCS(RS_Vector start, RS_Vector end);
 
     /**
@@ -285,6 +291,21 @@ protected:
     double arcRenderInterpolationMaxSagitta = 0.9;
     bool circleRenderSameAsArcs = false;
 
+    // minimal sizes in screen pixels, while the entities of a block are drawn through a transformation
+    struct DetailLimits{
+        double circleRadius = 0.;
+        double arcRadius = 0.;
+        double ellipseMajorRadius = 0.;
+        double ellipseMinorRadius = 0.;
+        double lineLen = 0.;
+        double arcSagitta = 0.;
+        int pointsSize = 0;
+    };
+    DetailLimits unscaledLimits;
+    bool drawingBlock = false;
+    // square root of the area scale of the block transformation
+    double blockDetailScale = 1.0;
+
     double minRenderableTextHeightInPx = 1;
     double defaultWidthFactor = 1.0;
 
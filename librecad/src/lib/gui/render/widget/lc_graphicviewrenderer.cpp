@@ -20,6 +20,10 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  ******************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include <QApplication>
 #include <QScreen>
 #include "lc_graphicviewrenderer.h"
@@ -30,6 +34,9 @@
 #include "rs_settings.h"
 #include "lc_overlayentitiescontainer.h"
 #include "lc_linemath.h"
+#include "rs_block.h"
+#include "rs_insert.h"
+#include "rs_line.h"
 
 LC_GraphicViewRenderer::LC_GraphicViewRenderer(LC_GraphicViewport *viewport, QPaintDevice* p)
    :LC_WidgetViewPortRenderer(viewport, p) {
@@ -64,6 +71,8 @@ void LC_GraphicViewRenderer::loadSettings() {
     {
         drawTextsAsDraftForPreview = LC_GET_BOOL("DrawTextsAsDraftInPreview", true);
         drawTextsAsDraftForPanning = LC_GET_BOOL("DrawTextsAsDraftInPanning", true);
+        m_batchLines = LC_GET_BOOL("BatchedRendering", false);
+        m_showFrameTime = LC_GET_BOOL("ShowFrameTime", false);
     }
     LC_GROUP_END();
 
@@ -89,14 +98,14 @@ void LC_GraphicViewRenderer::loadSettings() {
 
 void LC_GraphicViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
     // check for selected entity drawing
-    if (/*!e->isContainer() && */(e->getFlag(RS2::FlagSelected) != painter->shouldDrawSelected())) {
+    if (/*!e->isContainer() && */(isEntitySelected(e) != painter->shouldDrawSelected())) {
         return;
     }
 #ifdef DEBUG_RENDERING
     isVisibleTimer.start();
 #endif
     // entity is not visible:
-    bool visible = e->isVisible();
+    bool visible = isEntityVisible(e);
 #ifdef DEBUG_RENDERING
     isVisibleTime += isVisibleTimer.nsecsElapsed();
 #endif
@@ -107,7 +116,7 @@ void LC_GraphicViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
 #ifdef DEBUG_RENDERING
     isConstructionTimer.start();
 #endif
-    bool constructionEntity = e->isConstruction();
+    bool constructionEntity = isEntityConstruction(e);
 #ifdef DEBUG_RENDERING
     isConstructionTime += isConstructionTimer.nsecsElapsed();
 #endif
@@ -117,7 +126,33 @@ void LC_GraphicViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
     }
 
     RS2::EntityType entityType = e->rtti();
-    if (isDraftMode()) {
+    // level of detail: there is no point to draw every child of a container that covers a few pixels.
+    // The entities of a block are in block coordinates, their insert is checked instead
+    bool drawAsLod = !inOverlayDrawing && !isDrawingBlock() && getMinContainerSize() > 0.
+                     && (e->isContainer() || entityType == RS2::EntitySplinePoints)
+                     && isBelowLodSize(painter, e);
+
+    if (drawAsLod) {
+        drawLodEntity(painter, e);
+    }
+    else {
+        // the entity may cover points of the level of detail drawn before
+        m_lodRunOpen = false;
+        if (m_lineBatchingActive) {
+            // lines of blocks are drawn through the block transform, with the attributes of their insert
+            if (entityType == RS2::EntityLine && !constructionEntity && !isDrawingBlock()
+                && batchLine(painter, static_cast<RS_Line *>(e))) {
+                return;
+            }
+            // the lines batched so far are drawn before this entity, to keep the drawing order
+            flushLineBatch(painter);
+        }
+    }
+
+    if (drawAsLod) {
+        // already drawn
+    }
+    else if (isDraftMode()) {
         switch (entityType) {
             case RS2::EntityMText:
             case RS2::EntityText:
@@ -180,7 +215,7 @@ void LC_GraphicViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
     }
 
     // draw reference points:
-    if (e->getFlag(RS2::FlagSelected)) {
+    if (e->getFlag(RS2::FlagSelected) && !isDrawingBlock()) {
         if (!e->isParentSelected()) {
             drawEntityReferencePoints(painter, e);
         }
@@ -235,6 +270,9 @@ void LC_GraphicViewRenderer::doDrawLayerOverlays(RS_Painter *painter) {
     if (graphic != nullptr){ // fixme - sand - again, support for hatch dialog :(
         drawRelativeZero(painter);
     }
+    if (m_showFrameTime) {
+        drawFrameTime(painter);
+    }
     lastPaintEntityPen = RS_Pen();
     drawOverlay(painter);
 }
@@ -325,6 +363,21 @@ void LC_GraphicViewRenderer::drawDraftSign(RS_Painter *painter) {
     }
 }
 
+/**
+ * Shows the time of the latest entities drawing and of the previous frame in the bottom left corner
+ */
+void LC_GraphicViewRenderer::drawFrameTime(RS_Painter *painter) {
+    const QString text = QObject::tr("Entities: %1 ms, frame: %2 ms")
+        .arg(m_lastEntitiesTime * 1e-6, 0, 'f', 1)
+        .arg(m_lastFrameTime * 1e-6, 0, 'f', 1);
+    painter->setPen(m_colorForeground);
+    painter->setFont(m_draftSignFont);
+    const QSize &size = QFontMetrics(painter->font()).size(Qt::TextSingleLine, text);
+    int offset = 5;
+    QRect boundingRect{offset, viewport->getHeight() - size.height() - offset, size.width(), size.height()};
+    painter->drawText(boundingRect, text, nullptr);
+}
+
 void LC_GraphicViewRenderer::setPenForOverlayEntity(RS_Painter *painter, RS_Entity *e) {
     // todo - potentially, for overlays (preview etc) we may have simpler processing for pens rather than for normal drawing,
     // todo - therefore, review this later
@@ -377,13 +430,13 @@ void LC_GraphicViewRenderer::setPenForEntity(RS_Painter *painter, RS_Entity *e,
     getPenTimer.start();
 #endif
     // Getting pen from entity (or layer)
-    RS_Pen pen = e->getPenResolved();
+    RS_Pen pen = getEntityPen(e);
 #ifdef DEBUG_RENDERING
     getPenTime += getPenTimer.nsecsElapsed();
 #endif
     RS_Pen originalPen = pen;
-    bool highlighted = e->getFlag(RS2::FlagHighlighted);
-    bool selected = e->getFlag(RS2::FlagSelected);
+    bool highlighted = isEntityHighlighted(e);
+    bool selected = isEntitySelected(e);
     bool overlayPaint = inOverlay || inOverlayDrawing;
     // try to avoid pen setup if the pen and entity flags are the same as for previous entity. This is important for performance reasons, so we'll reuse
     // painter pen set previously. This check assumed that that all previous entity drawing were performed via this function and no
@@ -403,6 +456,31 @@ void LC_GraphicViewRenderer::setPenForEntity(RS_Painter *painter, RS_Entity *e,
 #ifdef DEBUG_RENDERING
     setPenTimer.start();
 #endif
+    prepareEntityPen(painter, e, pen, highlighted, selected, overlayPaint);
+
+    if (pen.getLineType() != RS2::SolidLine){
+        pen.setDashOffset(patternOffset * defaultWidthFactor);
+    }
+
+    // deleting not drawing:
+
+// LC_ERR << "PEN " << pen.getColor().name() << "Width: " << pen.getWidth() <<  " | " << pen.getScreenWidth() << " LT " << pen.getLineType();
+#ifdef DEBUG_RENDERING
+    setPenTime += setPenTimer.nsecsElapsed();
+    painterSetPenTimer.start();
+#endif
+    lastPaintEntityPen.updateBy(originalPen);
+    painter->setPen(pen);
+#ifdef DEBUG_RENDERING
+    painterSetPenTime +=painterSetPenTimer.nsecsElapsed();
+
+#endif
+}
+
+/**
+ * Screen width and color of the pen of an entity, drawn with scaled line widths
+ */
+void LC_GraphicViewRenderer::prepareEntityPen(RS_Painter *painter, RS_Entity *e, RS_Pen &pen, bool highlighted, bool selected, bool overlayPaint) const {
     // Avoid negative widths
 //    int w = std::max(static_cast<int>(pen.getWidth()), 0);
     double width = pen.getWidth();
@@ -466,34 +544,16 @@ void LC_GraphicViewRenderer::setPenForEntity(RS_Painter *painter, RS_Entity *e,
             pen.setColor(m_colorForeground);
         }
     }
-
-    if (pen.getLineType() != RS2::SolidLine){
-        pen.setDashOffset(patternOffset * defaultWidthFactor);
-    }
-
-    // deleting not drawing:
-
-// LC_ERR << "PEN " << pen.getColor().name() << "Width: " << pen.getWidth() <<  " | " << pen.getScreenWidth() << " LT " << pen.getLineType();
-#ifdef DEBUG_RENDERING
-    setPenTime += setPenTimer.nsecsElapsed();
-    painterSetPenTimer.start();
-#endif
-    lastPaintEntityPen.updateBy(originalPen);
-    painter->setPen(pen);
-#ifdef DEBUG_RENDERING
-    painterSetPenTime +=painterSetPenTimer.nsecsElapsed();
-
-#endif
 }
 
 void LC_GraphicViewRenderer::setPenForDraftEntity(RS_Painter *painter, RS_Entity *e, bool inOverlay) {
 #ifdef DEBUG_RENDERING
     setPenTimer.start();
 #endif
-    RS_Pen pen = e->getPenResolved();
+    RS_Pen pen = getEntityPen(e);
     RS_Pen originalPen = pen;
-    bool highlighted = e->getFlag(RS2::FlagHighlighted);
-    bool selected = e->getFlag(RS2::FlagSelected);
+    bool highlighted = isEntityHighlighted(e);
+    bool selected = isEntitySelected(e);
     bool overlayPaint = inOverlay || inOverlayDrawing;
 // try to avoid pen setup if the pen and entity flags are the same as for previous entity. This is important for performance reasons, so we'll reuse
     // painter pen set previously. This check assumed that that all previous entity drawing were performed via this function and no
@@ -509,6 +569,24 @@ void LC_GraphicViewRenderer::setPenForDraftEntity(RS_Painter *painter, RS_Entity
         lastPaintedSelected = selected;
         lastPaintOverlay = overlayPaint;
     }
+    prepareDraftEntityPen(e, pen, highlighted, selected, overlayPaint);
+
+    if (pen.getLineType() != RS2::SolidLine){
+        pen.setDashOffset(patternOffset * defaultWidthFactor);
+    }
+
+// LC_ERR << "PEN " << pen.getColor().name() << "Width: " << pen.getWidth() <<  " | " << pen.getScreenWidth() << " LT " << pen.getLineType();
+    lastPaintEntityPen.updateBy(originalPen);
+    painter->setPen(pen);
+#ifdef DEBUG_RENDERING
+    setPenTime += setPenTimer.nsecsElapsed();
+#endif
+}
+
+/**
+ * Screen width and color of the pen of an entity, drawn with 1 pixel lines
+ */
+void LC_GraphicViewRenderer::prepareDraftEntityPen(RS_Entity *e, RS_Pen &pen, bool highlighted, bool selected, bool overlayPaint) const {
     pen.setScreenWidth(0.0);
 
     if (overlayPaint) {
@@ -541,17 +619,230 @@ void LC_GraphicViewRenderer::setPenForDraftEntity(RS_Painter *painter, RS_Entity
             pen.setColor(m_colorForeground);
         }
     }
+}
 
-    if (pen.getLineType() != RS2::SolidLine){
-        pen.setDashOffset(patternOffset * defaultWidthFactor);
+/**
+ * @return true, if the screen size of the entity is less than the minimal container size
+ */
+bool LC_GraphicViewRenderer::isBelowLodSize(RS_Painter *painter, RS_Entity *e) const {
+    const RS_Vector &min = e->getMin();
+    const RS_Vector &max = e->getMax();
+    if (min.x > max.x || min.y > max.y) {
+        // no borders
+        return false;
+    }
+    double minSize = getMinContainerSize();
+    return std::abs(painter->toGuiDX(max.x - min.x)) < minSize && std::abs(painter->toGuiDY(max.y - min.y)) < minSize;
+}
+
+/**
+ * Draws an entity of a few pixels by its bounding box, or as a point if the box is within a pixel.
+ * Points of the same pen are drawn once per pixel, while nothing else is drawn in between.
+ * Containers of hidden entities only are not drawn.
+ */
+void LC_GraphicViewRenderer::drawLodEntity(RS_Painter *painter, RS_Entity *e) {
+    if (!hasVisibleEntities(e)) {
+        return;
+    }
+    RS_Pen pen = e->getPenResolved();
+    bool highlighted = e->getFlag(RS2::FlagHighlighted);
+    bool selected = e->getFlag(RS2::FlagSelected);
+    if (!isDraftMode() && m_scaleLineWidth) {
+        prepareEntityPen(painter, e, pen, highlighted, selected, false);
+    } else {
+        prepareDraftEntityPen(e, pen, highlighted, selected, false);
+    }
+    // no room for dashes within a few pixels
+    pen.setLineType(RS2::SolidLine);
+
+    const RS_Vector &min = e->getMin();
+    const RS_Vector &max = e->getMax();
+    const std::array<RS_Vector, 4> uiCorners{
+        painter->toGui(min), painter->toGui({max.x, min.y}), painter->toGui(max), painter->toGui({min.x, max.y})
+    };
+
+    QVector<QLineF> lines;
+    QVector<QPointF> points;
+    if (std::abs(painter->toGuiDX(max.x - min.x)) < 1. && std::abs(painter->toGuiDY(max.y - min.y)) < 1.) {
+        const RS_Vector uiCenter = (uiCorners[0] + uiCorners[2]) * 0.5;
+        if (!m_lodRunOpen || !isSamePen(m_lodRunPen, pen)) {
+            // a point of another pen is drawn over the points before, as any other entity
+            startLodRun(pen);
+        }
+        if (!coverLodPixel(static_cast<int>(std::floor(uiCenter.x)), static_cast<int>(std::floor(uiCenter.y)))) {
+            return;
+        }
+        points.append(QPointF(uiCenter.x, uiCenter.y));
+    } else {
+        for (size_t i = 0; i < uiCorners.size(); i++) {
+            const RS_Vector &p1 = uiCorners[i];
+            const RS_Vector &p2 = uiCorners[(i + 1) % uiCorners.size()];
+            lines.append(QLineF(p1.x, p1.y, p2.x, p2.y));
+        }
+        m_lodRunOpen = false;
     }
 
-// LC_ERR << "PEN " << pen.getColor().name() << "Width: " << pen.getWidth() <<  " | " << pen.getScreenWidth() << " LT " << pen.getLineType();
-    lastPaintEntityPen.updateBy(originalPen);
-    painter->setPen(pen);
-#ifdef DEBUG_RENDERING
-    setPenTime += setPenTimer.nsecsElapsed();
-#endif
+    if (m_lineBatchingActive) {
+        LineBatch &batch = lineBatchFor(painter, pen);
+        batch.lines.append(lines);
+        batch.points.append(points);
+    } else {
+        painter->setPen(pen);
+        if (!lines.isEmpty()) {
+            painter->drawLines(lines);
+        }
+        if (!points.isEmpty()) {
+            painter->drawPoints(points.constData(), points.size());
+        }
+        lastPaintEntityPen.setFlag(RS2::FlagInvalid);
+    }
+}
+
+/**
+ * Marks the pixel in the coverage raster by the current run of points.
+ * @return false, if the pixel is out of the view, or already covered by the run
+ */
+bool LC_GraphicViewRenderer::coverLodPixel(int x, int y) {
+    int width = viewport->getWidth();
+    int height = viewport->getHeight();
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return false;
+    }
+    size_t size = static_cast<size_t>(width) * static_cast<size_t>(height);
+    if (m_lodCoverage.size() != size) {
+        m_lodCoverage.assign(size, 0);
+    }
+    m_lodCoverageUsed = true;
+    size_t index = static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+    if (m_lodCoverage[index] == m_lodRun) {
+        return false;
+    }
+    m_lodCoverage[index] = m_lodRun;
+    return true;
+}
+
+/**
+ * Starts a run of points of the level of detail. Points of a run have the same pen, and no other entity
+ * is drawn between them, so a point is drawn once per pixel.
+ */
+void LC_GraphicViewRenderer::startLodRun(const RS_Pen &pen) {
+    m_lodRun++;
+    if (m_lodRun == 0) {
+        // the run numbers wrap around, the raster is cleared for them
+        std::fill(m_lodCoverage.begin(), m_lodCoverage.end(), 0);
+        m_lodRun = 1;
+    }
+    m_lodRunPen = pen;
+    m_lodRunOpen = true;
+}
+
+/**
+ * @return true, if the container has a visible entity, or it is no container. Inserts are checked
+ * by their block, once per frame, so inserts of the same block and deferred inserts are not expanded.
+ */
+bool LC_GraphicViewRenderer::hasVisibleEntities(RS_Entity *e) {
+    if (!e->isContainer()) {
+        return true;
+    }
+    if (e->rtti() == RS2::EntityInsert) {
+        RS_Block *block = static_cast<RS_Insert *>(e)->getBlockForInsert();
+        if (block != nullptr) {
+            auto cached = m_lodVisibleBlocks.constFind(block);
+            if (cached != m_lodVisibleBlocks.cend()) {
+                return cached.value();
+            }
+            // a block which inserts itself ends there
+            m_lodVisibleBlocks.insert(block, true);
+            bool visible = hasVisibleEntities(block);
+            m_lodVisibleBlocks.insert(block, visible);
+            return visible;
+        }
+    }
+    for (RS_Entity *child: *static_cast<RS_EntityContainer *>(e)) {
+        if (child->isVisible() && hasVisibleEntities(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @return true, if lines of the pens look the same
+ */
+bool LC_GraphicViewRenderer::isSamePen(const RS_Pen &pen, const RS_Pen &other) {
+    return pen == other && pen.getScreenWidth() == other.getScreenWidth() && pen.getAlpha() == other.getAlpha();
+}
+
+/**
+ * Adds a line to the batch, instead of drawing it.
+ * @return false, if the line should be drawn directly, as its pen is not solid
+ */
+bool LC_GraphicViewRenderer::batchLine(RS_Painter *painter, RS_Line *line) {
+    if (line->getFlag(RS2::FlagSelected)) {
+        return false;
+    }
+    const RS_Pen pen = line->getPenResolved();
+    bool highlighted = line->getFlag(RS2::FlagHighlighted);
+    bool transparent = line->getFlag(RS2::FlagTransparent);
+    // consecutive lines mostly share the pen, so the batch is resolved once per run of lines
+    if (m_lastBatchHighlighted != highlighted || m_lastBatchTransparent != transparent
+        || !m_lastBatchSourcePen.isSameAs(pen, pen.dashOffset())) {
+        RS_Pen resolvedPen = pen;
+        if (!isDraftMode() && m_scaleLineWidth) {
+            prepareEntityPen(painter, line, resolvedPen, highlighted, false, false);
+        } else {
+            prepareDraftEntityPen(line, resolvedPen, highlighted, false, false);
+        }
+        // dashes continue from the previous entity, they are drawn per entity
+        m_lastBatchSolid = resolvedPen.getLineType() == RS2::SolidLine;
+        m_lastBatchPen = resolvedPen;
+        m_lastBatchSourcePen.updateBy(pen);
+        m_lastBatchHighlighted = highlighted;
+        m_lastBatchTransparent = transparent;
+    }
+    if (!m_lastBatchSolid) {
+        return false;
+    }
+
+    LineBatch &batch = lineBatchFor(painter, m_lastBatchPen);
+    const RS_Vector uiStart = painter->toGui(line->getStartpoint());
+    const RS_Vector uiEnd = painter->toGui(line->getEndpoint());
+    // the same as RS_Painter::drawLineUI()
+    if (QPointF(uiEnd.x - uiStart.x, uiEnd.y - uiStart.y).manhattanLength() > getMinLineDrawingLen()) {
+        batch.lines.append(QLineF(uiStart.x, uiStart.y, uiEnd.x, uiEnd.y));
+    } else {
+        batch.points.append(QPointF(uiStart.x, uiStart.y));
+    }
+    return true;
+}
+
+/**
+ * @return the batch for lines of the pen. Lines batched with another pen are drawn first, so only runs of
+ * consecutive lines share a batch and the drawing order is kept.
+ */
+LC_GraphicViewRenderer::LineBatch &LC_GraphicViewRenderer::lineBatchFor(RS_Painter *painter, const RS_Pen &pen) {
+    if (!isSamePen(m_lineBatch.pen, pen)) {
+        flushLineBatch(painter);
+        m_lineBatch.pen = pen;
+    }
+    return m_lineBatch;
+}
+
+void LC_GraphicViewRenderer::flushLineBatch(RS_Painter *painter) {
+    if (m_lineBatch.lines.isEmpty() && m_lineBatch.points.isEmpty()) {
+        return;
+    }
+    painter->setPen(m_lineBatch.pen);
+    if (!m_lineBatch.lines.isEmpty()) {
+        painter->drawLines(m_lineBatch.lines);
+        m_lineBatch.lines.clear();
+    }
+    if (!m_lineBatch.points.isEmpty()) {
+        painter->drawPoints(m_lineBatch.points.constData(), m_lineBatch.points.size());
+        m_lineBatch.points.clear();
+    }
+    // the painter pen is changed, so it should be set for the next entity
+    lastPaintEntityPen.setFlag(RS2::FlagInvalid);
 }
 
 /**
@@ -606,4 +897,22 @@ void LC_GraphicViewRenderer::doSetupBeforeContainerDraw() {
     lastPaintedHighlighted = false;
     lastPaintedSelected = false;
     lastPaintOverlay = false;
+
+    m_lineBatchingActive = m_batchLines;
+    if (m_lodCoverageUsed) {
+        std::fill(m_lodCoverage.begin(), m_lodCoverage.end(), 0);
+        m_lodCoverageUsed = false;
+    }
+    m_lodRun = 0;
+    m_lodRunOpen = false;
+    // layers may be frozen or thawed between frames
+    m_lodVisibleBlocks.clear();
+    m_lastBatchSourcePen = RS_Pen{};
+    m_lastBatchSourcePen.setFlags(RS2::FlagInvalid);
+    m_lastBatchSolid = false;
+}
+
+void LC_GraphicViewRenderer::doFinishContainerDraw(RS_Painter *painter) {
+    flushLineBatch(painter);
+    m_lineBatchingActive = false;
 }
@@ -24,13 +24,21 @@
 #define LC_GRAPHICVIEWRENDERER_H
 
 
+#include <vector>
+
+#include <QHash>
+#include <QLineF>
+#include <QVector>
+
 #include "lc_widgetviewportrenderer.h"
 #include "lc_overlayrelativezero.h"
 #include "lc_overlayucszero.h"
 #include "lc_ucs_mark.h"
 #include "lc_overlayanglesbasemark.h"
 
+class RS_Block;
 class RS_EntityContainer;
+class RS_Line;
 class LC_OverlaysManager;
 
 class LC_GraphicViewRenderer:public LC_WidgetViewPortRenderer
@@ -98,6 +106,39 @@ protected:
     bool m_drawDrawSign = true;
     QFont m_draftSignFont;
 
+    /**
+     * Run of consecutive solid lines of the same resolved pen, drawn by a single drawLines() call, instead of
+     * a pen setup and a draw call per line. The run is drawn before any other entity.
+     */
+    struct LineBatch {
+        RS_Pen pen;
+        QVector<QLineF> lines;
+        // lines shorter than the minimal drawing length are drawn as points
+        QVector<QPointF> points;
+    };
+    bool m_batchLines = false;
+    bool m_lineBatchingActive = false;
+    LineBatch m_lineBatch;
+    // pen and flags of the previous batched line, to skip the pen resolving for runs of lines with the same pen
+    RS_Pen m_lastBatchSourcePen;
+    bool m_lastBatchHighlighted = false;
+    bool m_lastBatchTransparent = false;
+    // resolved pen of the previous line, which is batched if the pen is solid
+    RS_Pen m_lastBatchPen;
+    bool m_lastBatchSolid = false;
+
+    bool m_showFrameTime = false;
+
+    // pixels covered by entities drawn as a point for their small screen size, by the number of the run of
+    // points, so dense clusters of small entities are drawn once per pixel
+    std::vector<unsigned short> m_lodCoverage;
+    bool m_lodCoverageUsed = false;
+    unsigned short m_lodRun = 0;
+    bool m_lodRunOpen = false;
+    RS_Pen m_lodRunPen;
+    // blocks with visible entities, for the level of detail of inserts in the current frame
+    QHash<RS_Block*, bool> m_lodVisibleBlocks;
+
     LC_OverlayRelativeZero m_overlayRelZero = LC_OverlayRelativeZero(&m_relZeroOptions);
     LC_OverlayUCSZero m_overlayAbsZero = LC_OverlayUCSZero(&m_absZeroOptions);
     LC_OverlayUCSMark m_overlayUCSMark = LC_OverlayUCSMark(&m_ucsMarkOptions);
@@ -113,11 +154,24 @@ protected:
     void drawEntitiesInOverlay(LC_OverlaysManager *overlaysManager, RS_Painter *painter, RS2::OverlayGraphics overlayType);
     void drawOverlayEntitiesInOverlay(LC_OverlaysManager *overlaysManager, RS_Painter *painter, RS2::OverlayGraphics overlayType);
     void drawEntityReferencePoints(RS_Painter *painter, const RS_Entity *e) const;
+    void drawFrameTime(RS_Painter *painter);
     void setPenForEntity(RS_Painter *painter, RS_Entity *e, bool inOverlay);
     void setPenForDraftEntity(RS_Painter *painter, RS_Entity *e, bool inOverlay);
+    void prepareEntityPen(RS_Painter *painter, RS_Entity *e, RS_Pen &pen, bool highlighted, bool selected, bool overlayPaint) const;
+    void prepareDraftEntityPen(RS_Entity *e, RS_Pen &pen, bool highlighted, bool selected, bool overlayPaint) const;
+    bool isBelowLodSize(RS_Painter *painter, RS_Entity *e) const;
+    void drawLodEntity(RS_Painter *painter, RS_Entity *e);
+    bool coverLodPixel(int x, int y);
+    void startLodRun(const RS_Pen &pen);
+    bool hasVisibleEntities(RS_Entity *e);
+    static bool isSamePen(const RS_Pen &pen, const RS_Pen &other);
+    bool batchLine(RS_Painter *painter, RS_Line *line);
+    LineBatch &lineBatchFor(RS_Painter *painter, const RS_Pen &pen);
+    void flushLineBatch(RS_Painter *painter);
     void setPenForOverlayEntity(RS_Painter *painter, RS_Entity *e);
     void renderEntity(RS_Painter *painter, RS_Entity *e) override;
     void doSetupBeforeContainerDraw() override;
+    void doFinishContainerDraw(RS_Painter *painter) override;
 };
 
 #endif // LC_GRAPHICVIEWRENDERER_H
@@ -159,14 +159,14 @@ void LC_PrintPreviewViewRenderer::drawPaper(RS_Painter *painter) {
 void LC_PrintPreviewViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e) {
     // fixme - sand - ucs - is it really necessary for print preview??????
     // check for selected entity drawing
-    if (/*!e->isContainer() && */(e->getFlag(RS2::FlagSelected) != painter->shouldDrawSelected())) {
+    if (/*!e->isContainer() && */(isEntitySelected(e) != painter->shouldDrawSelected())) {
         return;
     }
 #ifdef DEBUG_RENDERING
     isVisibleTimer.start();
 #endif
     // entity is not visible:
-    bool visible = e->isVisible();
+    bool visible = isEntityVisible(e);
 #ifdef DEBUG_RENDERING
     isVisibleTime += isVisibleTimer.nsecsElapsed();
 #endif
@@ -177,12 +177,12 @@ void LC_PrintPreviewViewRenderer::renderEntity(RS_Painter *painter, RS_Entity *e
 #ifdef DEBUG_RENDERING
     isConstructionTimer.start();
 #endif
-    bool constructionEntity = e->isConstruction();
+    bool constructionEntity = isEntityConstruction(e);
 #ifdef DEBUG_RENDERING
     isConstructionTime += isConstructionTimer.nsecsElapsed();
 #endif
 
-    if (!e->isPrint() || constructionEntity)
+    if (!isEntityPrinted(e) || constructionEntity)
         return;
 
     if (isOutsideOfBoundingClipRect(e, constructionEntity)) {
@@ -199,7 +199,7 @@ void LC_PrintPreviewViewRenderer::setPenForPrintingEntity(RS_Painter *painter, R
     setPenTimer.start();
 #endif
     // Getting pen from entity (or layer)
-    RS_Pen pen = e->getPenResolved();
+    RS_Pen pen = getEntityPen(e);
     RS_Pen originalPen = pen;
 
     double patternOffset = painter->currentDashOffset();
@@ -20,8 +20,12 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  ******************************************************************************/
 
+#include <cstdlib>
 #include <memory>
 
+#include <QElapsedTimer>
+#include <QRegion>
+
 #include "lc_graphicviewport.h"
 #include "lc_widgetviewportrenderer.h"
 #include "rs_debug.h"
@@ -68,6 +72,9 @@ void LC_WidgetViewPortRenderer::loadSettings() {
         int minEllipseMinor100 = LC_GET_INT("MinEllipseMinor", 200);
         m_render_minEllipseMinorRadius = minEllipseMinor100 / 100.0;
 
+        int minContainerSize100 = LC_GET_INT("MinContainerSize", 200);
+        m_render_minContainerSize = minContainerSize100 / 100.0;
+
         m_render_arcsInterpolate = LC_GET_BOOL("ArcRenderInterpolate", false);
 
         m_render_arcsInterpolateAngleFixed = LC_GET_BOOL("ArcRenderInterpolateSegmentFixed", true);
@@ -101,6 +108,10 @@ void LC_WidgetViewPortRenderer::doRender() {
     drawLayerEntitiesTime = 0;
     drawLayerOverlaysTime = 0;
 #endif
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    m_entitiesDrawn = false;
+
     if (antialiasing){
         if (classicRenderer) {
             paintClassicalBuffered(pd);
@@ -113,6 +124,8 @@ void LC_WidgetViewPortRenderer::doRender() {
         paintClassicalBuffered(pd);
     }
 
+    m_lastFrameTime = frameTimer.nsecsElapsed();
+
 #ifdef DEBUG_RENDERING
     LC_ERR<<"Paint:"  << timer.elapsed() <<
     " Layer 1 - Background: "  << drawLayerBackgroundTime <<" Layer 2 - Entities:"  << drawLayerEntitiesTime  <<" Layer 3 - overlays: "  << drawLayerOverlaysTime
@@ -180,6 +193,22 @@ void LC_WidgetViewPortRenderer::paintClassicalBuffered(QPaintDevice* pd) {
         redrawMethod = RS2::RedrawAll;
     }
 
+    int offsetX = viewport->getOffsetX();
+    int offsetY = viewport->getOffsetY();
+    RS_Vector factor = viewport->getFactor();
+    if (!(redrawMethod & RS2::RedrawDrawing) &&
+        (offsetX != m_layer2OffsetX || offsetY != m_layer2OffsetY || factor != m_layer2Factor)) {
+        // the view was moved, but the drawing is unchanged. If it was only panned,
+        // shift the rendered drawing and render the exposed parts only
+        bool panned = factor == m_layer2Factor && panLayerDrawing(offsetX - m_layer2OffsetX, m_layer2OffsetY - offsetY);
+        if (!panned) {
+            redrawMethod = static_cast<RS2::RedrawMethod>(redrawMethod | RS2::RedrawDrawing);
+        }
+    }
+    m_layer2OffsetX = offsetX;
+    m_layer2OffsetY = offsetY;
+    m_layer2Factor = factor;
+
     // Draw Layer 1
     if (redrawMethod & RS2::RedrawGrid) {
         m_pixmapLayer1->fill(m_colorBackground);
@@ -211,6 +240,42 @@ void LC_WidgetViewPortRenderer::paintClassicalBuffered(QPaintDevice* pd) {
     wPainter.drawPixmap(0, 0, *m_pixmapLayer3);
 }
 
+/**
+ * Shifts the rendered drawing by the given screen distance, and renders
+ * the strips exposed by the shift only.
+ *
+ * @return false, if the drawing should be rendered as a whole instead
+ */
+bool LC_WidgetViewPortRenderer::panLayerDrawing(int dx, int dy) {
+    QRect rect = m_pixmapLayer2->rect();
+    // rendering most of the view again is about as expensive as the full one
+    if (std::abs(dx) > rect.width() / 2 || std::abs(dy) > rect.height() / 2) {
+        return false;
+    }
+
+    QRegion exposed;
+    m_pixmapLayer2->scroll(dx, dy, rect, &exposed);
+    exposed &= rect;
+
+    RS_Painter painterLayerDrawing(m_pixmapLayer2.get());
+    painterLayerDrawing.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const QRect &strip: exposed) {
+        painterLayerDrawing.fillRect(strip, Qt::transparent);
+    }
+    painterLayerDrawing.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    for (const QRect &strip: exposed) {
+        // only entities within the strip are drawn
+        renderBoundingClipRect = prepareBoundingClipRect(strip.left(), strip.top(), strip.right() + 1, strip.bottom() + 1);
+        painterLayerDrawing.setClipRect(strip);
+        setupPainter(&painterLayerDrawing);
+        drawLayerEntities(&painterLayerDrawing);
+        drawLayerEntitiesOver(&painterLayerDrawing);
+    }
+    renderBoundingClipRect = prepareBoundingClipRect();
+    return true;
+}
+
 void LC_WidgetViewPortRenderer::setupPainter(RS_Painter *painter) {
     LC_GraphicViewportRenderer::setupPainter(painter);
     painter->setMinCircleDrawingRadius(m_render_minCircleDrawingRadius);
@@ -252,14 +317,27 @@ void LC_WidgetViewPortRenderer::drawLayerEntities(RS_Painter* painter) {
     drawLayerEntitiesTimer.start();
 #endif
 
+    QElapsedTimer entitiesTimer;
+    entitiesTimer.start();
+
     RS_EntityContainer *container = viewport->getContainer();
     painter->setDrawSelectedOnly(false);
     doSetupBeforeContainerDraw();
     justDrawEntity(painter, container);
+    doFinishContainerDraw(painter);
 
     painter->setDrawSelectedOnly(true);
     doSetupBeforeContainerDraw();
     justDrawEntity(painter, container);
+    doFinishContainerDraw(painter);
+
+    // panning draws the exposed strips one by one, within the same frame
+    if (m_entitiesDrawn) {
+        m_lastEntitiesTime += entitiesTimer.nsecsElapsed();
+    } else {
+        m_lastEntitiesTime = entitiesTimer.nsecsElapsed();
+        m_entitiesDrawn = true;
+    }
 
 #ifdef DEBUG_RENDERING_DETAILS
     drawLayerEntitiesTime += drawLayerEntitiesTimer.elapsed();
@@ -36,11 +36,15 @@ public:
     void setupPainter(RS_Painter* painter) override;
     void setAntialiasing(bool state) {antialiasing = state;}
     void invalidate(RS2::RedrawMethod method) {redrawMethod = static_cast<RS2::RedrawMethod>(redrawMethod | method);}
+    /** @return the duration of the latest drawing of the entities layer, in nanoseconds */
+    qint64 getLastEntitiesTime() const {return m_lastEntitiesTime;}
 protected:
     void doRender() override;
 
     virtual void doSetupBeforeContainerDraw();
+    virtual void doFinishContainerDraw([[maybe_unused]]RS_Painter* painter){}
     void paintClassicalBuffered(QPaintDevice* pd);
+    bool panLayerDrawing(int dx, int dy);
     void paintSequental(QPaintDevice* pd);
 
     void drawLayerBackground(RS_Painter *painter);
@@ -53,6 +57,16 @@ protected:
     int getMinRenderableTextHeightInPx() const {
         return m_render_minRenderableTextHeightInPx;
     }
+    double getMinLineDrawingLen() const {
+        return m_render_minLineDrawingLen;
+    }
+    double getMinContainerSize() const {
+        return m_render_minContainerSize;
+    }
+
+    // duration of the previous frame, and of the latest drawing of the entities layer, in nanoseconds
+    qint64 m_lastFrameTime = 0;
+    qint64 m_lastEntitiesTime = 0;
 
 #ifdef DEBUG_RENDERING
     QElapsedTimer drawLayerBackgroundTimer;
@@ -73,12 +87,15 @@ private:
 
     RS2::RedrawMethod redrawMethod = RS2::RedrawAll;
 
+    bool m_entitiesDrawn = false;
+
     int m_render_minRenderableTextHeightInPx = 4;
     double m_render_minCircleDrawingRadius = 2.0;
     double m_render_minArcDrawingRadius = 0.5;
     double m_render_minEllipseMajorRadius = 2.;
     double m_render_minEllipseMinorRadius = 1.;
     double m_render_minLineDrawingLen = 2;
+    double m_render_minContainerSize = 2;
 
     bool m_render_arcsInterpolate = true;
     bool m_render_arcsInterpolateAngleFixed = true;
@@ -90,6 +107,11 @@ private:
     std::unique_ptr<QPixmap> m_pixmapLayer1;  // Used for grids and absolute 0
     std::unique_ptr<QPixmap> m_pixmapLayer2;  // Used for the actual CAD drawing
     std::unique_ptr<QPixmap> m_pixmapLayer3;  // Used for crosshair and actionitems
+
+    // view the CAD drawing in m_pixmapLayer2 was rendered for
+    int m_layer2OffsetX = 0;
+    int m_layer2OffsetY = 0;
+    RS_Vector m_layer2Factor{false};
 };
 
 #endif // LC_WIDGETVIEWPORTRENDERER_H
@@ -47,6 +47,7 @@
 #include "rs_settings.h"
 #include "rs_units.h"
 #include "lc_graphicviewport.h"
+#include "lc_snapworker.h"
 #include "lc_widgetviewportrenderer.h"
 #include "lc_shortcuts_manager.h"
 
@@ -60,7 +61,8 @@
  */
 RS_GraphicView::RS_GraphicView(QWidget *parent, Qt::WindowFlags f)
     :QWidget(parent, f), eventHandler{new RS_EventHandler{this}},
-    defaultSnapMode{std::make_unique<RS_SnapMode>()}{
+    defaultSnapMode{std::make_unique<RS_SnapMode>()},
+    m_snapWorker{std::make_unique<LC_SnapWorker>()}{
     viewport = new LC_GraphicViewport();
     viewport->addViewportListener(this);
 }
@@ -96,6 +98,7 @@ void RS_GraphicView::cleanUp() {
 void RS_GraphicView::setContainer(RS_EntityContainer *c) {
     container = c;
     viewport->setContainer(c);
+    m_snapWorker->setContainer(c);
 //adjustOffsetControls();
 }
 
@@ -245,7 +248,8 @@ void RS_GraphicView::onViewportChanged() {
     adjustZoomControls();
     QString info = viewport->getGrid()->getInfo();
     updateGridStatusWidget(info);
-    redraw();
+    // the renderer detects the moved view and reuses the drawing on pan
+    redraw(static_cast<RS2::RedrawMethod>(RS2::RedrawGrid | RS2::RedrawOverlay));
 }
 
 void RS_GraphicView::onViewportRedrawNeeded() {
@@ -317,6 +321,10 @@ RS_EntityContainer *RS_GraphicView::getContainer() const {
     return container;
 }
 
+LC_SnapWorker *RS_GraphicView::getSnapWorker() const {
+    return m_snapWorker.get();
+}
+
 bool RS_GraphicView::isCleanUp(void) const {
     return m_bIsCleanUp;
 }
@@ -384,3 +392,7 @@ void RS_GraphicView::setLineWidthScaling(bool state){
 bool RS_GraphicView::getLineWidthScaling() const{
     return renderer->getLineWidthScaling();
 }
+
+qint64 RS_GraphicView::getLastEntitiesTime() const{
+    return renderer->getLastEntitiesTime();
+}
@@ -56,6 +56,7 @@ class RS_Painter;
 struct RS_LineTypePattern;
 struct RS_SnapMode;
 class LC_GraphicViewport;
+class LC_SnapWorker;
 class LC_WidgetViewPortRenderer;
 
 /**
@@ -111,6 +112,8 @@ public:
     virtual void setMouseCursor(RS2::CursorType /*c*/) = 0;
 
     RS_EntityContainer *getContainer() const;
+    /** @return the worker solving intersections for the snapping of the actions */
+    LC_SnapWorker *getSnapWorker() const;
 
     void setDefaultAction(RS_ActionInterface *action);
     RS_ActionInterface *getDefaultAction();
@@ -159,6 +162,8 @@ public:
 
     void setLineWidthScaling(bool state);
     bool getLineWidthScaling() const;
+    /** @return the duration of the latest drawing of the entities, in nanoseconds */
+    qint64 getLastEntitiesTime() const;
 
     RS2::EntityType getTypeToSelect() const;
     void setTypeToSelect(RS2::EntityType mType);
@@ -197,6 +202,7 @@ protected:
      * actions.
      */
     std::unique_ptr<RS_SnapMode> defaultSnapMode;
+    std::unique_ptr<LC_SnapWorker> m_snapWorker;
  /**
   * Current default snap restriction for this graphic view. Used for new
   * actions.
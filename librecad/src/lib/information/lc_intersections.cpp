@@ -0,0 +1,183 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+
+#include <algorithm>
+#include <utility>
+
+#include "lc_entityiterator.h"
+#include "lc_intersections.h"
+#include "lc_rect.h"
+#include "rs_debug.h"
+#include "rs_entitycontainer.h"
+#include "rs_information.h"
+
+namespace {
+
+// an atomic entity to intersect, with the given entity it's resolved from
+struct Leaf {
+    RS_Entity* entity = nullptr;
+    RS_Entity* owner = nullptr;
+    LC_Rect box;
+    bool unbounded = false;
+};
+
+void addLeaf(RS_Entity* entity, RS_Entity* owner, std::vector<Leaf>& leaves){
+    Leaf leaf;
+    leaf.entity = entity;
+    leaf.owner = owner;
+    leaf.unbounded = RS_EntityContainer::isUnbounded(entity);
+    if (!leaf.unbounded) {
+        leaf.box = LC_Rect{entity->getMin(), entity->getMax()};
+    }
+    leaves.push_back(leaf);
+}
+
+std::vector<Leaf> collectLeaves(const std::vector<RS_Entity*>& entities, RS2::ResolveLevel level){
+    std::vector<Leaf> leaves;
+    leaves.reserve(entities.size());
+    for (RS_Entity* entity: entities) {
+        if (RS_EntityContainer::resolvesInto(entity, level)) {
+            auto* container = static_cast<RS_EntityContainer*>(entity);
+            for (RS_Entity* sub: LC_EntityRange{*container, level}) {
+                addLeaf(sub, entity, leaves);
+            }
+        } else {
+            addLeaf(entity, entity, leaves);
+        }
+    }
+    return leaves;
+}
+
+bool mayIntersect(const Leaf& first, const Leaf& second){
+    return first.unbounded || second.unbounded || first.box.intersects(second.box, RS_TOLERANCE);
+}
+
+void solve(const Leaf& first, const Leaf& second, std::vector<LC_Intersections::Intersection>& result){
+    const RS_VectorSolutions sol = RS_Information::getIntersection(first.entity, second.entity, true);
+    for (const RS_Vector& point: sol) {
+        if (point.valid) {
+            result.push_back({first.entity, second.entity, first.owner, second.owner, point});
+        }
+    }
+}
+}
+
+std::vector<LC_Intersections::Intersection> LC_Intersections::findAll(const std::vector<RS_Entity*>& entities,
+                                                                      RS2::ResolveLevel level){
+    const std::vector<Leaf> leaves = collectLeaves(entities, level);
+
+    // candidate pairs by the indexes of their leaves, the lower index first
+    std::vector<std::pair<size_t, size_t>> pairs;
+    std::vector<size_t> bounded;
+    std::vector<size_t> unbounded;
+    for (size_t i = 0; i < leaves.size(); i++) {
+        (leaves[i].unbounded ? unbounded : bounded).push_back(i);
+    }
+    auto addPair = [&](size_t i, size_t j){
+        if (leaves[i].owner != leaves[j].owner) {
+            pairs.emplace_back(std::min(i, j), std::max(i, j));
+        }
+    };
+
+    // infinite entities may intersect any other
+    for (size_t k = 0; k < unbounded.size(); k++) {
+        for (size_t j = k + 1; j < unbounded.size(); j++) {
+            addPair(unbounded[k], unbounded[j]);
+        }
+        for (size_t j: bounded) {
+            addPair(unbounded[k], j);
+        }
+    }
+
+    // sweep by x over the borders: an entity is only paired with the active entities,
+    // whose borders still overlap the sweep position
+    std::sort(bounded.begin(), bounded.end(), [&leaves](size_t i, size_t j){
+        return leaves[i].box.minP().x < leaves[j].box.minP().x;
+    });
+    std::vector<size_t> active;
+    for (size_t i: bounded) {
+        const double x = leaves[i].box.minP().x - RS_TOLERANCE;
+        active.erase(std::remove_if(active.begin(), active.end(), [&leaves, x](size_t j){
+            return leaves[j].box.maxP().x < x;
+        }), active.end());
+        for (size_t j: active) {
+            if (mayIntersect(leaves[i], leaves[j])) {
+                addPair(i, j);
+            }
+        }
+        active.push_back(i);
+    }
+
+    // solve in the order of the entities
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<Intersection> result;
+    for (const auto& [i, j]: pairs) {
+        solve(leaves[i], leaves[j], result);
+    }
+    RS_DEBUG->print(RS_Debug::D_DEBUGGING,
+                    "LC_Intersections::findAll: %zu entities, %zu pairs solved, %zu intersections",
+                    leaves.size(), pairs.size(), result.size());
+    return result;
+}
+
+std::vector<LC_Intersections::Intersection> LC_Intersections::findWith(RS_Entity* entity,
+                                                                       const std::vector<RS_Entity*>& entities,
+                                                                       RS2::ResolveLevel level){
+    std::vector<Intersection> result;
+    if (entity == nullptr) {
+        return result;
+    }
+    Leaf target;
+    target.entity = entity;
+    target.owner = entity;
+    target.unbounded = RS_EntityContainer::isUnbounded(entity);
+    if (!target.unbounded) {
+        target.box = LC_Rect{entity->getMin(), entity->getMax()};
+    }
+
+    for (const Leaf& leaf: collectLeaves(entities, level)) {
+        if (leaf.entity != entity && mayIntersect(target, leaf)) {
+            solve(target, leaf, result);
+        }
+    }
+    return result;
+}
+
+std::vector<LC_Intersections::Intersection> LC_Intersections::findWith(RS_Entity* entity,
+                                                                       RS_EntityContainer& container,
+                                                                       RS2::ResolveLevel level){
+    if (entity == nullptr) {
+        return {};
+    }
+    std::vector<RS_Entity*> candidates;
+    if (RS_EntityContainer::isUnbounded(entity)) {
+        candidates.assign(container.begin(), container.end());
+    } else {
+        candidates = container.getIntersectionCandidates(entity->getMin(), entity->getMax());
+    }
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const RS_Entity* candidate){
+        return candidate == nullptr || !candidate->isVisible();
+    }), candidates.end());
+    return findWith(entity, candidates, level);
+}
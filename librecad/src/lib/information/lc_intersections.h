@@ -0,0 +1,79 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+#ifndef LC_INTERSECTIONS_H
+#define LC_INTERSECTIONS_H
+
+#include <vector>
+
+#include "rs.h"
+#include "rs_vector.h"
+
+class RS_Entity;
+class RS_EntityContainer;
+
+/**
+ * Batch intersection of entities.
+ *
+ * Containers are resolved into their atomic entities, and only entities with
+ * overlapping borders are solved by RS_Information::getIntersection(). The
+ * pairs of a set are found by a sweep over the borders sorted by x, so the
+ * solver is called for the pairs which may intersect only, instead of all pairs.
+ * Construction lines and entities on construction layers are infinite and
+ * are checked with all others.
+ */
+class LC_Intersections {
+public:
+    struct Intersection {
+        /** the atomic entities which intersect */
+        RS_Entity* first = nullptr;
+        RS_Entity* second = nullptr;
+        /** the given entities, which are or contain the atomic entities */
+        RS_Entity* firstOwner = nullptr;
+        RS_Entity* secondOwner = nullptr;
+        RS_Vector point;
+    };
+
+    /**
+     * @return all intersections among the given entities. Entities resolved from the
+     * same given container are not intersected with each other.
+     */
+    static std::vector<Intersection> findAll(const std::vector<RS_Entity*>& entities,
+                                             RS2::ResolveLevel level = RS2::ResolveAll);
+    /**
+     * @return intersections of the entity with the given entities, in their order
+     */
+    static std::vector<Intersection> findWith(RS_Entity* entity, const std::vector<RS_Entity*>& entities,
+                                              RS2::ResolveLevel level = RS2::ResolveAll);
+    /**
+     * @return intersections of the entity with the visible entities of the container.
+     * The candidates are found by RS_EntityContainer::getIntersectionCandidates(): the
+     * entities within the borders of the entity in the container order, followed by the
+     * entities on construction layers outside of the borders. For an unbounded entity,
+     * all entities in the container order.
+     */
+    static std::vector<Intersection> findWith(RS_Entity* entity, RS_EntityContainer& container,
+                                              RS2::ResolveLevel level = RS2::ResolveAll);
+};
+
+#endif // LC_INTERSECTIONS_H
@@ -28,6 +28,7 @@
 #include <random>
 #include <vector>
 
+#include "lc_entityiterator.h"
 #include "lc_parabola.h"
 #include "lc_quadratic.h"
 #include "lc_rect.h"
@@ -952,7 +953,6 @@ RS_VectorSolutions RS_Information::getIntersectionEllipseLine(RS_Line* line,
     ret.rotate(center, angleVector);
 //    std::cout<<"found Ellipse-Line intersections: "<<ret.getNumber()<<std::endl;
 //    std::cout<<ret<<std::endl;
-    RS_DEBUG->print("RS_Information::getIntersectionEllipseLine(): done");
     return ret;
 }
 
@@ -1000,9 +1000,7 @@ bool RS_Information::isPointInsideContour(const RS_Vector& point,
             *onContour = false;
         }
 
-        for (RS_Entity* e = contour->firstEntity(RS2::ResolveAll);
-				e;
-                e = contour->nextEntity(RS2::ResolveAll)) {
+        for (RS_Entity* e: LC_EntityRange{*contour, RS2::ResolveAll}) {
 
             // intersection(s) from ray with contour entity:
             sol = RS_Information::getIntersection(&ray, e, true);
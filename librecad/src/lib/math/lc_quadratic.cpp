@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 **********************************************************************/
 
 #include <algorithm>
+#include <array>
 #include <cfloat>
 #include <numeric>
 
@@ -40,6 +41,22 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "emu_c99.h" /* C99 math */
 #endif
 
+namespace {
+// the coefficients in the order of LC_Quadratic::getCoefficients(), held by fixed size arrays
+RS_Math::QuadraticCoefficients quadraticCoefficients(const LC_Quadratic& lc)
+{
+    const auto& quad = lc.getQuad();
+    const auto& linear = lc.getLinear();
+    return {quad(0,0), quad(0,1) + quad(1,0), quad(1,1), linear(0), linear(1), lc.constTerm()};
+}
+
+std::array<double, 3> linearCoefficients(const LC_Quadratic& lc)
+{
+    const auto& linear = lc.getLinear();
+    return {linear(0), linear(1), lc.constTerm()};
+}
+}
+
 /**
  * Constructor.
  */
@@ -67,10 +84,8 @@ LC_Quadratic::LC_Quadratic(const LC_Quadratic& lc0):
 LC_Quadratic& LC_Quadratic::operator = (const LC_Quadratic& lc0)
 {
     if(lc0.isQuadratic()){
-        m_mQuad.resize(2,2,false);
         m_mQuad=lc0.getQuad();
     }
-    m_vLinear.resize(2);
     m_vLinear=lc0.getLinear();
     m_dConst=lc0.m_dConst;
     m_bIsQuadratic=lc0.isQuadratic();
@@ -237,22 +252,22 @@ bool LC_Quadratic::operator != (bool valid) const
     return m_bValid != valid;
 }
 
-boost::numeric::ublas::vector<double>& LC_Quadratic::getLinear()
+LC_Quadratic::LinearVector& LC_Quadratic::getLinear()
 {
     return m_vLinear;
 }
 
-const boost::numeric::ublas::vector<double>& LC_Quadratic::getLinear() const
+const LC_Quadratic::LinearVector& LC_Quadratic::getLinear() const
 {
     return m_vLinear;
 }
 
-boost::numeric::ublas::matrix<double>& LC_Quadratic::getQuad()
+LC_Quadratic::QuadMatrix& LC_Quadratic::getQuad()
 {
     return m_mQuad;
 }
 
-const boost::numeric::ublas::matrix<double>& LC_Quadratic::getQuad() const
+const LC_Quadratic::QuadMatrix& LC_Quadratic::getQuad() const
 {
     return m_mQuad;
 }
@@ -444,8 +459,8 @@ LC_Quadratic LC_Quadratic::move(const RS_Vector& v)
 LC_Quadratic LC_Quadratic::rotate(double angle)
 {
     using namespace boost::numeric::ublas;
-    matrix<double> m=rotationMatrix(angle);
-    matrix<double> t=trans(m);
+    QuadMatrix m=rotationMatrix(angle);
+    QuadMatrix t=trans(m);
     m_vLinear = prod(t, m_vLinear);
     if(m_bIsQuadratic){
         m_mQuad=prod(m_mQuad,m);
@@ -518,14 +533,11 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
     }
     if(!p1->isQuadratic()){
         //two lines
-        std::vector<std::vector<double> > ce(2,std::vector<double>(3,0.));
-        ce[0][0]=p1->m_vLinear(0);
-        ce[0][1]=p1->m_vLinear(1);
-        ce[0][2]=-p1->m_dConst;
-        ce[1][0]=p2->m_vLinear(0);
-        ce[1][1]=p2->m_vLinear(1);
-        ce[1][2]=-p2->m_dConst;
-        std::vector<double> sn(2,0.);
+        const std::array<std::array<double, 3>, 2> ce = {{
+            {p1->m_vLinear(0), p1->m_vLinear(1), -p1->m_dConst},
+            {p2->m_vLinear(0), p2->m_vLinear(1), -p2->m_dConst}
+        }};
+        std::array<double, 2> sn;
         if(RS_Math::linearSolver(ce,sn)){
             ret.push_back(RS_Vector(sn[0],sn[1]));
         }
@@ -542,14 +554,13 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
             //            }
             return ret;
         }
-        std::vector<std::vector<double> >  ce(0);
         if(std::abs(p2->m_vLinear(1))<RS_TOLERANCE){
             const double angle=0.25*M_PI;
             LC_Quadratic p11(*p1);
             LC_Quadratic p22(*p2);
-            ce.push_back(p11.rotate(angle).getCoefficients());
-            ce.push_back(p22.rotate(angle).getCoefficients());
-            ret=RS_Math::simultaneousQuadraticSolverMixed(ce);
+            p11.rotate(angle);
+            p22.rotate(angle);
+            ret=RS_Math::simultaneousQuadraticSolverMixed(linearCoefficients(p22), quadraticCoefficients(p11));
             ret.rotate(-angle);
             //            for(size_t j=0;j<ret.size();j++){
             //                DEBUG_HEADER
@@ -557,9 +568,7 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
             //            }
             return ret;
         }
-        ce.push_back(p1->getCoefficients());
-        ce.push_back(p2->getCoefficients());
-        ret=RS_Math::simultaneousQuadraticSolverMixed(ce);
+        ret=RS_Math::simultaneousQuadraticSolverMixed(linearCoefficients(*p2), quadraticCoefficients(*p1));
         //        for(size_t j=0;j<ret.size();j++){
         //            DEBUG_HEADER
         //            std::cout<<j<<": ("<<ret[j].x<<", "<< ret[j].y<<")"<<std::endl;
@@ -586,8 +595,7 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
         }
         return getIntersection(p1->flipXY(),p2->flipXY()).flipXY();
     }
-    std::vector<std::vector<double> >  ce = { p1->getCoefficients(),
-                                            p2->getCoefficients()};
+    const RS_Math::QuadraticEquations ce = {quadraticCoefficients(*p1), quadraticCoefficients(*p2)};
     if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
         DEBUG_HEADER
                 std::cout<<*p1<<std::endl;
@@ -600,16 +608,13 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
             valid=false;
             break;
         }
-        const std::vector<double> xyi = {v.x * v.x, v.x * v.y, v.y * v.y, v.x, v.y, 1.};
+        const std::array<double, 6> xyi = {v.x * v.x, v.x * v.y, v.y * v.y, v.x, v.y, 1.};
         const double e0 = std::inner_product(xyi.cbegin(), xyi.cend(), ce.front().cbegin(), 0.);
         const double e1 = std::inner_product(xyi.cbegin(), xyi.cend(), ce.back().cbegin(), 0.);
         LC_LOG<<__func__<<"(): "<<v.x<<","<<v.y<<": equ0= "<<e0;
         LC_LOG<<__func__<<"(): "<<v.x<<","<<v.y<<": equ1= "<<e1;
     }
     if(valid) return sol;
-    ce.clear();
-    ce.push_back(p1->getCoefficients());
-    ce.push_back(p2->getCoefficients());
     sol=RS_Math::simultaneousQuadraticSolverFull(ce);
     ret.clear();
     for(auto const& v: sol){
@@ -630,9 +635,9 @@ RS_VectorSolutions LC_Quadratic::getIntersection(const LC_Quadratic& l1, const L
    cos x, sin x
    -sin x, cos x
    */
-boost::numeric::ublas::matrix<double> LC_Quadratic::rotationMatrix(const double& angle)
+LC_Quadratic::QuadMatrix LC_Quadratic::rotationMatrix(const double& angle)
 {
-    boost::numeric::ublas::matrix<double> ret(2,2);
+    QuadMatrix ret;
     ret(0,0)=cos(angle);
     ret(0,1)=sin(angle);
     ret(1,0)=-ret(0,1);
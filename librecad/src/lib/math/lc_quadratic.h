@@ -40,6 +40,10 @@ class RS_AtomicEntity;
  */
 class LC_Quadratic {
 public:
+    /** fixed size storage of the coefficients, without heap allocations */
+    using QuadMatrix = boost::numeric::ublas::bounded_matrix<double, 2, 2>;
+    using LinearVector = boost::numeric::ublas::bounded_vector<double, 2>;
+
     LC_Quadratic();
     LC_Quadratic(const LC_Quadratic& lc0);
     LC_Quadratic& operator = (const LC_Quadratic& lc0);
@@ -85,10 +89,10 @@ public:
 	bool operator == (bool valid) const;
 	bool operator != (bool valid) const;
 
-	boost::numeric::ublas::vector<double>& getLinear();
-	 const boost::numeric::ublas::vector<double>& getLinear() const;
-	 boost::numeric::ublas::matrix<double>& getQuad();
-	 const boost::numeric::ublas::matrix<double>& getQuad() const;
+	LinearVector& getLinear();
+	 const LinearVector& getLinear() const;
+	 QuadMatrix& getQuad();
+	 const QuadMatrix& getQuad() const;
 	 double const& constTerm()const;
 	 double& constTerm();
 
@@ -105,7 +109,7 @@ public:
     LC_Quadratic getDualCurve() const;
 
     /** the matrix of rotation by angle **/
-    static boost::numeric::ublas::matrix<double> rotationMatrix(const double& angle);
+    static QuadMatrix rotationMatrix(const double& angle);
 
     static RS_VectorSolutions getIntersection(const LC_Quadratic& l1, const LC_Quadratic& l2);
 
@@ -113,8 +117,8 @@ public:
 
 private:
     // the equation form: {x, y}.m_mQuad.{{x},{y}} + m_vLinear.{{x},{y}}+m_dConst=0
-    boost::numeric::ublas::matrix<double> m_mQuad;
-    boost::numeric::ublas::vector<double> m_vLinear;
+    QuadMatrix m_mQuad;
+    LinearVector m_vLinear;
     double m_dConst = 0.;
     bool m_bIsQuadratic = false;
     /** whether this quadratic form is valid */
@@ -24,6 +24,7 @@
 **
 **********************************************************************/
 
+#include <array>
 #include <cmath>
 
 #include <boost/numeric/ublas/matrix.hpp>
@@ -64,6 +65,44 @@ const QRegularExpression unitreg(
                 R"((?:(?P<numer>\d+)\/(?P<denom>\d+))?)"                // rational inches
         R"((?:inches|inch|in|"))?$)))"
 	);
+
+// Gauss-Jordan elimination of a fixed size augmented matrix, the same as
+// RS_Math::linearSolver(), without heap allocations
+template<size_t N>
+bool linearSolverFixed(std::array<std::array<double, N + 1>, N> mt0, std::array<double, N>& sn)
+{
+    for(size_t i=0;i<N;++i){
+        size_t imax(i);
+        double cmax(std::abs(mt0[i][i]));
+        for(size_t j=i+1;j<N;++j) {
+            if(std::abs(mt0[j][i]) > cmax ) {
+                imax=j;
+                cmax=std::abs(mt0[j][i]);
+            }
+        }
+        if(cmax<RS_TOLERANCE) return false; //singular matrix
+        if(imax != i) {
+            std::swap(mt0[i],mt0[imax]);
+        }
+        for(size_t k=i+1;k<=N;++k) {
+            mt0[i][k] /= mt0[i][i];
+        }
+        mt0[i][i]=1.;
+        for(size_t j=0;j<N;++j) {
+            if(j != i ) {
+                double& a = mt0[j][i];
+                for(size_t k=i+1;k<=N;++k) {
+                    mt0[j][k] -= mt0[i][k]*a;
+                }
+                a=0.;
+            }
+        }
+    }
+    for(size_t i=0;i<N;++i) {
+        sn[i]=mt0[i][N];
+    }
+    return true;
+}
 }
 
 /**
@@ -529,11 +568,17 @@ void RS_Math::test() {
 //
 // @author Dongxu Li <dongxuli2011@gmail.com>
 std::vector<double> RS_Math::quadraticSolver(const std::vector<double>& ce)
+{
+    if (ce.size() != 2) return {};
+    const PolynomialRoots roots = quadraticSolver(std::array<double, 2>{ce[0], ce[1]});
+    return {roots.begin(), roots.end()};
+}
+
+RS_Math::PolynomialRoots RS_Math::quadraticSolver(const std::array<double, 2>& ce)
 //quadratic solver for
 // x^2 + ce[0] x + ce[1] =0
 {
-    std::vector<double> ans(0,0.);
-    if (ce.size() != 2) return ans;
+    PolynomialRoots ans;
     using LDouble = long double;
     LDouble const b = -0.5L * ce[0];
     LDouble const c = ce[1];
@@ -582,13 +627,18 @@ std::vector<double> RS_Math::quadraticSolver(const std::vector<double>& ce)
 
 
 std::vector<double> RS_Math::cubicSolver(const std::vector<double>& ce)
+{
+    if (ce.size() != 3) return {};
+    const PolynomialRoots roots = cubicSolver(std::array<double, 3>{ce[0], ce[1], ce[2]});
+    return {roots.begin(), roots.end()};
+}
+
+RS_Math::PolynomialRoots RS_Math::cubicSolver(const std::array<double, 3>& ce)
 //cubic equation solver
 // x^3 + ce[0] x^2 + ce[1] x + ce[2] = 0
 {
     //    std::cout<<"x^3 + ("<<ce[0]<<")*x^2+("<<ce[1]<<")*x+("<<ce[2]<<")==0"<<std::endl;
-    std::vector<double> ans;
-    if (ce.size() != 3)
-        return {};
+    PolynomialRoots ans;
 
     // depressed cubic, Tschirnhaus transformation, x= t - b/(3a)
     // t^3 + p t +q =0
@@ -617,8 +667,7 @@ std::vector<double> RS_Math::cubicSolver(const std::vector<double>& ce)
     }
     //std::cout<<"discriminant="<<discriminant<<std::endl;
     if(!std::signbit(discriminant)) {
-        std::vector<double> ce2 = { { q, -1./27*p*p*p } };
-        auto r=quadraticSolver(ce2);
+        auto r=quadraticSolver(std::array<double, 2>{ q, -1./27*p*p*p });
         if ( r.empty() ) { //should not happen
             LC_ERR<<__FILE__<<" : "<<__func__<<" : line"<<__LINE__<<" :cubicSolver()::Error cubicSolver("<<ce[0]<<' '<<ce[1]<<' '<<ce[2]<<")\n";
             return {};
@@ -665,19 +714,25 @@ std::vector<double> RS_Math::cubicSolver(const std::vector<double>& ce)
     return ans;
 }
 
-/** quartic solver
-* x^4 + ce[0] x^3 + ce[1] x^2 + ce[2] x + ce[3] = 0
-@ce, a vector of size 4 contains the coefficient in order
-@return, a vector contains real roots
-**/
 std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
 {
-    std::vector<double> ans(0,0.);
     if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
         DEBUG_HEADER
                 std::cout<<"expected array size=4, got "<<ce.size()<<std::endl;
     }
-    if(ce.size() != 4) return ans;
+    if(ce.size() != 4) return {};
+    const PolynomialRoots roots = quarticSolver(std::array<double, 4>{ce[0], ce[1], ce[2], ce[3]});
+    return {roots.begin(), roots.end()};
+}
+
+/** quartic solver
+* x^4 + ce[0] x^3 + ce[1] x^2 + ce[2] x + ce[3] = 0
+@ce, an array of size 4 contains the coefficient in order
+@return, the real roots
+**/
+RS_Math::PolynomialRoots RS_Math::quarticSolver(const std::array<double, 4>& ce)
+{
+    PolynomialRoots ans;
     if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
         std::cout<<"x^4+("<<ce[0]<<")*x^3+("<<ce[1]<<")*x^2+("<<ce[2]<<")*x+("<<ce[3]<<")==0"<<std::endl;
     }
@@ -727,11 +782,8 @@ std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
         return ans;
     }
     if ( std::abs(r)< 1.0e-75 ) {
-        std::vector<double> cubic(3,0.);
-        cubic[1]=p;
-        cubic[2]=q;
         ans.push_back(0.);
-        auto r=cubicSolver(cubic);
+        auto r=cubicSolver(std::array<double, 3>{0., p, q});
         std::copy(r.begin(),r.end(), std::back_inserter(ans));
         for(size_t i=0; i<ans.size(); i++) ans[i] -= shift;
         return ans;
@@ -747,11 +799,7 @@ std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
     //  y=u^2,
     //  y^3 + 2 p y^2 + ( p^2 - 4 r) y - q^2 =0
     //
-    std::vector<double> cubic(3,0.);
-    cubic[0]=2.*p;
-    cubic[1]=p*p-4.*r;
-    cubic[2]=-q*q;
-    auto r3= cubicSolver(cubic);
+    auto r3= cubicSolver(std::array<double, 3>{2.*p, p*p-4.*r, -q*q});
     if (r3.empty())
         return {};
     //std::cout<<"quartic_solver:: real roots from cubic: "<<ret<<std::endl;
@@ -765,7 +813,7 @@ std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
             return ans;
         }
         double sqrtz0=sqrt(r3[0]);
-        std::vector<double> ce2(2,0.);
+        std::array<double, 2> ce2;
         ce2[0]=	-sqrtz0;
         ce2[1]=0.5*(p+r3[0])+0.5*q/sqrtz0;
         auto r1=quadraticSolver(ce2);
@@ -781,7 +829,7 @@ std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
     }
     if ( r3[0]> 0. && r3[1] > 0. ) {
         double sqrtz0=sqrt(r3[0]);
-        std::vector<double> ce2(2,0.);
+        std::array<double, 2> ce2;
         ce2[0]=	-sqrtz0;
         ce2[1]=0.5*(p+r3[0])+0.5*q/sqrtz0;
         ans=quadraticSolver(ce2);
@@ -812,22 +860,27 @@ std::vector<double> RS_Math::quarticSolver(const std::vector<double>& ce)
     return ans;
 }
 
+std::vector<double> RS_Math::quarticSolverFull(const std::vector<double>& ce)
+{
+    if(ce.size()!=5) return {};
+    const PolynomialRoots roots = quarticSolverFull(std::array<double, 5>{ce[0], ce[1], ce[2], ce[3], ce[4]});
+    return {roots.begin(), roots.end()};
+}
+
 /** quartic solver
 * ce[4] x^4 + ce[3] x^3 + ce[2] x^2 + ce[1] x + ce[0] = 0
-@ce, a vector of size 5 contains the coefficient in order
-@return, a vector contains real roots
+@ce, an array of size 5 contains the coefficient in order
+@return, the real roots
 *ToDo, need a robust algorithm to locate zero terms, better handling of tolerances
 **/
-std::vector<double> RS_Math::quarticSolverFull(const std::vector<double>& ce)
+RS_Math::PolynomialRoots RS_Math::quarticSolverFull(const std::array<double, 5>& ce)
 {
     if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
         DEBUG_HEADER
                 std::cout<<ce[4]<<"*y^4+("<<ce[3]<<")*y^3+("<<ce[2]<<"*y^2+("<<ce[1]<<")*y+("<<ce[0]<<")==0"<<std::endl;
     }
 
-    std::vector<double> roots(0,0.);
-    if(ce.size()!=5) return roots;
-    std::vector<double> ce2(4,0.);
+    PolynomialRoots roots;
 
     if ( std::abs(ce[4]) < 1.0e-14) { // this should not happen
         if ( std::abs(ce[3]) < 1.0e-14) { // this should not happen
@@ -838,33 +891,24 @@ std::vector<double> RS_Math::quarticSolverFull(const std::vector<double>& ce)
                     return roots;
                 }
             } else {
-                ce2.resize(2);
-                ce2[0]=ce[1]/ce[2];
-                ce2[1]=ce[0]/ce[2];
+                const std::array<double, 2> ce2 = {ce[1]/ce[2], ce[0]/ce[2]};
                 //std::cout<<"ce2[2]={ "<<ce2[0]<<' '<<ce2[1]<<" }\n";
                 roots=RS_Math::quadraticSolver(ce2);
             }
         } else {
-            ce2.resize(3);
-            ce2[0]=ce[2]/ce[3];
-            ce2[1]=ce[1]/ce[3];
-            ce2[2]=ce[0]/ce[3];
+            const std::array<double, 3> ce2 = {ce[2]/ce[3], ce[1]/ce[3], ce[0]/ce[3]};
             //std::cout<<"ce2[3]={ "<<ce2[0]<<' '<<ce2[1]<<' '<<ce2[2]<<" }\n";
             roots=RS_Math::cubicSolver(ce2);
         }
     } else {
-        ce2[0]=ce[3]/ce[4];
-        ce2[1]=ce[2]/ce[4];
-        ce2[2]=ce[1]/ce[4];
-        ce2[3]=ce[0]/ce[4];
+        const std::array<double, 4> ce2 = {ce[3]/ce[4], ce[2]/ce[4], ce[1]/ce[4], ce[0]/ce[4]};
         if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
             DEBUG_HEADER
                     std::cout<<"ce2[4]={ "<<ce2[0]<<' '<<ce2[1]<<' '<<ce2[2]<<' '<<ce2[3]<<" }\n";
         }
         if(std::abs(ce2[3])<= RS_TOLERANCE15) {
             //constant term is zero, factor 0 out, solve a cubic equation
-            ce2.resize(3);
-            roots=RS_Math::cubicSolver(ce2);
+            roots=RS_Math::cubicSolver(std::array<double, 3>{ce2[0], ce2[1], ce2[2]});
             roots.push_back(0.);
         }else
             roots=RS_Math::quarticSolver(ce2);
@@ -982,6 +1026,11 @@ bool RS_Math::linearSolver(const std::vector<std::vector<double> >& mt, std::vec
     return true;
 }
 
+bool RS_Math::linearSolver(const std::array<std::array<double, 3>, 2>& m, std::array<double, 2>& sn)
+{
+    return linearSolverFixed<2>(m, sn);
+}
+
 /**
  * wrapper of elliptic integral of the second type, Legendre form
  * @param k the elliptic modulus or eccentricity
@@ -1046,12 +1095,20 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolver(const std::vector<double
   */
 RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const std::vector<std::vector<double> >& m)
 {
-    RS_VectorSolutions ret;
-    if(m.size()!=2)  return ret;
+    if(m.size()!=2)  return {};
     if( m[0].size() ==3 || m[1].size()==3 ){
         return simultaneousQuadraticSolverMixed(m);
     }
-    if(m[0].size()!=6 || m[1].size()!=6) return ret;
+    if(m[0].size()!=6 || m[1].size()!=6) return {};
+    QuadraticEquations mf;
+    std::copy(m[0].begin(), m[0].end(), mf[0].begin());
+    std::copy(m[1].begin(), m[1].end(), mf[1].begin());
+    return simultaneousQuadraticSolverFull(mf);
+}
+
+RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const QuadraticEquations& m)
+{
+    RS_VectorSolutions ret;
     /** eliminate x, quartic equation of y **/
     auto& a=m[0][0];
     auto& b=m[0][1];
@@ -1097,7 +1154,7 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const std::vector<st
     double  j2=j*j;
     double  k2=k*k;
     double  l2=l*l;
-    std::vector<double> qy(5,0.);
+    std::array<double, 5> qy;
     //y^4
     qy[4]=-c2*g2 + b*c*g*h - a*c*h2 - b2*g*i + 2.*a*c*g*i + a*b*h*i - a2*i2;
     //y^3
@@ -1126,7 +1183,7 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const std::vector<st
     if (roots.size()==0 ) { // no intersection found
         return ret;
     }
-    std::vector<double> ce(0,0.);
+    std::array<double, 3> ce;
 
     for(size_t i0=0;i0<roots.size();i0++){
         if(RS_DEBUG->getLevel()>=RS_Debug::D_INFORMATIONAL){
@@ -1136,7 +1193,6 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const std::vector<st
         /*
           Collect[Eliminate[{ a*x^2 + b*x*y+c*y^2+d*x+e*y+f==0,g*x^2+h*x*y+i*y^2+j*x+k*y+l==0},x],y]
           */
-        ce.resize(3);
         ce[0]=a;
         ce[1]=b*roots[i0]+d;
         ce[2]=c*roots[i0]*roots[i0]+e*roots[i0]+f;
@@ -1153,9 +1209,7 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverFull(const std::vector<st
         if(std::abs(ce[0])<1e-75 && std::abs(ce[1])<1e-75) continue;
 
         if(std::abs(a)>1e-75){
-            std::vector<double> ce2(2,0.);
-            ce2[0]=ce[1]/ce[0];
-            ce2[1]=ce[2]/ce[0];
+            const std::array<double, 2> ce2 = {ce[1]/ce[0], ce[2]/ce[0]};
             //                DEBUG_HEADER
             //                        std::cout<<"x^2 +("<<ce2[0]<<")*x+("<<ce2[1]<<")==0"<<std::endl;
             auto xRoots=quadraticSolver(ce2);
@@ -1187,32 +1241,42 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverMixed(const std::vector<s
     }
     if(p1->size()==3) {
         //linear
-        std::vector<double> sn(2,0.);
-        std::vector<std::vector<double> > ce;
-        ce.push_back(m[0]);
-        ce.push_back(m[1]);
-        ce[0][2]=-ce[0][2];
-        ce[1][2]=-ce[1][2];
-        if( RS_Math::linearSolver(ce,sn)) ret.push_back(RS_Vector(sn[0],sn[1]));
+        std::array<double, 2> sn;
+        const std::array<std::array<double, 3>, 2> ce = {{
+            {m[0][0], m[0][1], -m[0][2]},
+            {m[1][0], m[1][1], -m[1][2]}
+        }};
+        if( linearSolver(ce,sn)) ret.push_back(RS_Vector(sn[0],sn[1]));
         return ret;
     }
+    if(p0->size()!=3 || p1->size()!=6) return ret;
+    const std::array<double, 3> line = {(*p0)[0], (*p0)[1], (*p0)[2]};
+    QuadraticCoefficients quadratic;
+    std::copy(p1->begin(), p1->end(), quadratic.begin());
+    return simultaneousQuadraticSolverMixed(line, quadratic);
+}
+
+RS_VectorSolutions RS_Math::simultaneousQuadraticSolverMixed(const std::array<double, 3>& line,
+                                                             const QuadraticCoefficients& quadratic)
+{
+    RS_VectorSolutions ret;
     //    DEBUG_HEADER
-    //    std::cout<<"p0: size="<<p0->size()<<"\n Solve[{("<< p0->at(0)<<")*x + ("<<p0->at(1)<<")*y + ("<<p0->at(2)<<")==0,";
-    //    std::cout<<"("<< p1->at(0)<<")*x^2 + ("<<p1->at(1)<<")*x*y + ("<<p1->at(2)<<")*y^2 + ("<<p1->at(3)<<")*x +("<<p1->at(4)<<")*y+("
-    //            <<p1->at(5)<<")==0},{x,y}]"<<std::endl;
-    const double& a=p0->at(0);
-    const double& b=p0->at(1);
-    const double& c=p0->at(2);
-    const double& d=p1->at(0);
-    const double& e=p1->at(1);
-    const double& f=p1->at(2);
-    const double& g=p1->at(3);
-    const double& h=p1->at(4);
-    const double& i=p1->at(5);
+    //    std::cout<<"Solve[{("<< line[0]<<")*x + ("<<line[1]<<")*y + ("<<line[2]<<")==0,";
+    //    std::cout<<"("<< quadratic[0]<<")*x^2 + ("<<quadratic[1]<<")*x*y + ("<<quadratic[2]<<")*y^2 + ("<<quadratic[3]<<")*x +("<<quadratic[4]<<")*y+("
+    //            <<quadratic[5]<<")==0},{x,y}]"<<std::endl;
+    const double& a=line[0];
+    const double& b=line[1];
+    const double& c=line[2];
+    const double& d=quadratic[0];
+    const double& e=quadratic[1];
+    const double& f=quadratic[2];
+    const double& g=quadratic[3];
+    const double& h=quadratic[4];
+    const double& i=quadratic[5];
     /**
       y (2 b c d-a c e)-a c g+c^2 d = y^2 (a^2 (-f)+a b e-b^2 d)+y (a b g-a^2 h)+a^2 (-i)
       */
-    std::vector<double> ce(3,0.);
+    std::array<double, 3> ce;
     const double& a2=a*a;
     const double& b2=b*b;
     const double& c2=c*c;
@@ -1221,14 +1285,11 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverMixed(const std::vector<s
     ce[2]=a*c*g-c2*d-a2*i;
     //    DEBUG_HEADER
     //    std::cout<<"("<<ce[0]<<") y^2 + ("<<ce[1]<<") y + ("<<ce[2]<<")==0"<<std::endl;
-    std::vector<double> roots(0,0.);
+    PolynomialRoots roots;
     if( std::abs(ce[1])>RS_TOLERANCE15 && std::abs(ce[0]/ce[1])<RS_TOLERANCE15){
         roots.push_back( - ce[2]/ce[1]);
     }else{
-        std::vector<double> ce2(2,0.);
-        ce2[0]=ce[1]/ce[0];
-        ce2[1]=ce[2]/ce[0];
-        roots=quadraticSolver(ce2);
+        roots=quadraticSolver(std::array<double, 2>{ce[1]/ce[0], ce[2]/ce[0]});
     }
     //    for(size_t i=0;i<roots.size();i++){
     //    std::cout<<"x="<<roots.at(i)<<std::endl;
@@ -1247,12 +1308,21 @@ RS_VectorSolutions RS_Math::simultaneousQuadraticSolverMixed(const std::vector<s
 
 }
 
+bool RS_Math::simultaneousQuadraticVerify(const std::vector<std::vector<double> >& m, RS_Vector& v)
+{
+    if(m.size()!=2 || m[0].size()!=6 || m[1].size()!=6) return false;
+    QuadraticEquations mf;
+    std::copy(m[0].begin(), m[0].end(), mf[0].begin());
+    std::copy(m[1].begin(), m[1].end(), mf[1].begin());
+    return simultaneousQuadraticVerify(mf, v);
+}
+
 /** verify a solution for simultaneousQuadratic
   *@m the coefficient matrix
   *@v, a candidate to verify
   *@return true, for a valid solution
   **/
-bool RS_Math::simultaneousQuadraticVerify(const std::vector<std::vector<double> >& m, RS_Vector& v)
+bool RS_Math::simultaneousQuadraticVerify(const QuadraticEquations& m, RS_Vector& v)
 {
     RS_Vector v0=v;
     auto& a=m[0][0];
@@ -1289,8 +1359,8 @@ bool RS_Math::simultaneousQuadraticVerify(const std::vector<std::vector<double>
             if(amax0<std::abs(terms0[i])) amax0=std::abs(terms0[i]);
             sum0 += terms0[i];
         }
-        std::vector<std::vector<double>> nrCe;
-        nrCe.push_back(std::vector<double>{px, py, sum0});
+        std::array<std::array<double, 3>, 2> nrCe;
+        nrCe[0] = {px, py, sum0};
         px=2.*g*x+h*y+j;
         py=h*x+2.*i*y+k;
         sum1=0.;
@@ -1298,9 +1368,9 @@ bool RS_Math::simultaneousQuadraticVerify(const std::vector<std::vector<double>
             if(amax1<std::abs(terms0[i])) amax1=std::abs(terms0[i]);
             sum1 += terms0[i];
         }
-        nrCe.push_back(std::vector<double>{px, py, sum1});
-        std::vector<double> dn;
-        bool ret=linearSolver(nrCe, dn);
+        nrCe[1] = {px, py, sum1};
+        std::array<double, 2> dn;
+        bool ret=linearSolverFixed<2>(nrCe, dn);
         //		DEBUG_HEADER
         //		qDebug()<<"i0="<<i0<<"\tf=("<<sum0<<','<<sum1<<")\tdn=("<<dn[0]<<","<<dn[1]<<")";
         if(!i0){
@@ -27,9 +27,12 @@
 #ifndef RS_MATH_H
 #define RS_MATH_H
 
+#include <array>
 #include <cmath>
 #include <vector>
 
+#include <boost/container/static_vector.hpp>
+
 class QString;
 class QRegularExpressionMatch;
 
@@ -100,20 +103,33 @@ double eval(const QString &expr, double def = 0.0);
 double eval(const QString &expr, bool *ok);
 //! \}
 
+/** real roots of a polynomial equation up to the fourth degree, held without heap allocation */
+using PolynomialRoots = boost::container::static_vector<double, 4>;
+/** coefficients of a quadratic equation in the order of: x^2 xy y^2 x y 1 */
+using QuadraticCoefficients = std::array<double, 6>;
+/** a set of two quadratic equations */
+using QuadraticEquations = std::array<QuadraticCoefficients, 2>;
+
+// the solvers taking fixed size arrays avoid heap allocations,
+// the overloads taking vectors copy the coefficients and call them
 std::vector<double> quadraticSolver(const std::vector<double> &ce);
+PolynomialRoots quadraticSolver(const std::array<double, 2> &ce);
 std::vector<double> cubicSolver(const std::vector<double> &ce);
+PolynomialRoots cubicSolver(const std::array<double, 3> &ce);
 /** quartic solver
     * x^4 + ce[0] x^3 + ce[1] x^2 + ce[2] x + ce[3] = 0
     @ce, a vector of size 4 contains the coefficient in order
     @return, a vector contains real roots
     **/
 std::vector<double> quarticSolver(const std::vector<double> &ce);
+PolynomialRoots quarticSolver(const std::array<double, 4> &ce);
 /** quartic solver
 * ce[4] x^4 + ce[3] x^3 + ce[2] x^2 + ce[1] x + ce[0] = 0
     @ce, a vector of size 5 contains the coefficient in order
     @return, a vector contains real roots
     **/
 std::vector<double> quarticSolverFull(const std::vector<double> &ce);
+PolynomialRoots quarticSolverFull(const std::array<double, 5> &ce);
 //solver for linear equation set
 /**
       * Solve linear equation set
@@ -124,6 +140,8 @@ std::vector<double> quarticSolverFull(const std::vector<double> &ce);
 	  *@author: Dongxu Li
       */
 bool linearSolver(const std::vector<std::vector<double> > &m, std::vector<double> &sn);
+/** linear equation set of two unknowns, @param m holds the augmented matrix */
+bool linearSolver(const std::array<std::array<double, 3>, 2> &m, std::array<double, 2> &sn);
 
 /** solver quadratic simultaneous equations of a set of two **/
 /* solve the following quadratic simultaneous equations,
@@ -147,7 +165,10 @@ RS_VectorSolutions simultaneousQuadraticSolver(const std::vector<double> &m);
       *@return a RS_VectorSolutions contains real roots (x,y)
       */
 RS_VectorSolutions simultaneousQuadraticSolverFull(const std::vector<std::vector<double> > &m);
+RS_VectorSolutions simultaneousQuadraticSolverFull(const QuadraticEquations &m);
 RS_VectorSolutions simultaneousQuadraticSolverMixed(const std::vector<std::vector<double> > &m);
+/** a line, line[0] x + line[1] y + line[2] = 0, and a quadratic equation */
+RS_VectorSolutions simultaneousQuadraticSolverMixed(const std::array<double, 3> &line, const QuadraticCoefficients &quadratic);
 
 /** \brief verify simultaneousQuadraticVerify a solution for simultaneousQuadratic
 	  *@param m the coefficient matrix
@@ -155,6 +176,7 @@ RS_VectorSolutions simultaneousQuadraticSolverMixed(const std::vector<std::vecto
       *@return true, for a valid solution
       **/
 bool simultaneousQuadraticVerify(const std::vector<std::vector<double> > &m, RS_Vector &v);
+bool simultaneousQuadraticVerify(const QuadraticEquations &m, RS_Vector &v);
 /** wrapper for elliptic integral **/
 /**
      * wrapper of elliptic integral of the second type, Legendre form
@@ -27,6 +27,7 @@
 
 #include <QSet>
 
+#include "lc_entityiterator.h"
 #include "lc_graphicviewport.h"
 #include "lc_linemath.h"
 #include "lc_splinepoints.h"
@@ -109,8 +110,7 @@ namespace {
         if (limitEntity.isContainer()){
             auto ec = dynamic_cast<const RS_EntityContainer *>(&limitEntity);
 
-            for (RS_Entity *e = ec->firstEntity(RS2::ResolveAll); e != nullptr;
-                 e = ec->nextEntity(RS2::ResolveAll)) {
+            for (RS_Entity *e: LC_EntityRange{*ec, RS2::ResolveAll}) {
 
                 RS_VectorSolutions s2 = RS_Information::getIntersection(&trimEntity,
                                                                         e, false);
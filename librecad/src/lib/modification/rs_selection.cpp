@@ -24,6 +24,7 @@
 **
 **********************************************************************/
 
+#include <unordered_set>
 
 #include "qc_applicationwindow.h"
 
@@ -32,12 +33,20 @@
 #include "rs_block.h"
 #include "rs_dialogfactory.h"
 #include "rs_entity.h"
-#include "rs_information.h"
+#include "rs_graphic.h"
 #include "rs_insert.h"
 #include "rs_layer.h"
 #include "rs_line.h"
 #include "rs_selection.h"
 #include "lc_graphicviewport.h"
+#include "lc_endpointgraph.h"
+#include "lc_entityiterator.h"
+#include "lc_intersections.h"
+
+namespace {
+// end points closer than this connect the entities of a contour
+constexpr double contourTolerance = 1.0e-4;
+}
 
 /**
  * Default constructor.
@@ -150,39 +159,12 @@ void RS_Selection::selectWindow(const QList<RS2::EntityType> &typesToSelect, con
  */
 void RS_Selection::selectIntersected(const RS_Vector &v1, const RS_Vector &v2, bool select){
     RS_Line line{v1, v2};
-    bool inters;
-
-    for (auto e: *container) { // fixme - iteration over ALL entities, limit area
-        if (e && e->isVisible()){
-            inters = false;
-
-            // select containers / groups:
-            if (e->isContainer()){
-                auto *ec = (RS_EntityContainer *) e;
-
-                for (RS_Entity *e2 = ec->firstEntity(RS2::ResolveAll); e2;
-                     e2 = ec->nextEntity(RS2::ResolveAll)) {
-
-                    RS_VectorSolutions sol =
-                        RS_Information::getIntersection(&line, e2, true);
-
-                    if (sol.hasValid()){
-                        inters = true;
-                    }
-                }
-            } else {
-
-                RS_VectorSolutions sol =
-                    RS_Information::getIntersection(&line, e, true);
-
-                if (sol.hasValid()){
-                    inters = true;
-                }
-            }
-
-            if (inters){
-                e->setSelected(select);
-            }
+    // only entities with borders crossing the line are intersected
+    std::unordered_set<RS_Entity *> intersected;
+    for (const LC_Intersections::Intersection &info: LC_Intersections::findWith(&line, *container)) {
+        // select containers / groups:
+        if (intersected.insert(info.secondOwner).second) {
+            info.secondOwner->setSelected(select);
         }
     }
     graphicView->notifyChanged();
@@ -207,54 +189,45 @@ void RS_Selection::selectContour(RS_Entity *e){
     auto *ae = (RS_AtomicEntity *) e;
     RS_Vector p1 = ae->getStartpoint();
     RS_Vector p2 = ae->getEndpoint();
-    bool found = false;
 
     // (de)select 1st entity:
     e->setSelected(select);
 
-    do {// fixme - hm...iterating over all entities of drawing in cycle???? too nice for me...
-        found = false;
-        // fixme - iterating over all entities of drawing
-        for (auto en: *container) {
-
-            if (en && en->isVisible() &&
-                en->isAtomic() && en->isSelected() != select &&
-                (!(en->getLayer() && en->getLayer()->isLocked()))){
-
-                ae = (RS_AtomicEntity *) en;
-                bool doit = false;
-
-                // startpoint connects to 1st point
-                if (ae->getStartpoint().distanceTo(p1) < 1.0e-4){
-                    doit = true;
-                    p1 = ae->getEndpoint();
-                }
-
-                    // endpoint connects to 1st point
-                else if (ae->getEndpoint().distanceTo(p1) < 1.0e-4){
-                    doit = true;
-                    p1 = ae->getStartpoint();
-                }
-
-                    // startpoint connects to 2nd point
-                else if (ae->getStartpoint().distanceTo(p2) < 1.0e-4){
-                    doit = true;
-                    p2 = ae->getEndpoint();
-                }
-
-                    // endpoint connects to 1st point
-                else if (ae->getEndpoint().distanceTo(p2) < 1.0e-4){
-                    doit = true;
-                    p2 = ae->getStartpoint();
-                }
+    // the entities connected to an end of the contour are found by the endpoint graph of the
+    // container, so the contour is walked without iterating over all entities of the drawing
+    const LC_EndpointGraph &graph = container->getEndpointGraph(contourTolerance);
+    auto extendFrom = [&graph, select](RS_Vector &p){
+        bool found = false;
+        do {
+            found = false;
+            for (RS_Entity *en: graph.getConnected(p)) {
+                if (en->isVisible() &&
+                    en->isAtomic() && en->isSelected() != select &&
+                    (!(en->getLayer() && en->getLayer()->isLocked()))){
+
+                    auto *next = (RS_AtomicEntity *) en;
+
+                    // startpoint connects: continue from the endpoint
+                    if (next->getStartpoint().distanceTo(p) < contourTolerance){
+                        p = next->getEndpoint();
+                        found = true;
+                    }
+                        // endpoint connects: continue from the startpoint
+                    else if (next->getEndpoint().distanceTo(p) < contourTolerance){
+                        p = next->getStartpoint();
+                        found = true;
+                    }
 
-                if (doit){
-                    ae->setSelected(select);
-                    found = true;
+                    if (found){
+                        next->setSelected(select);
+                        break;
+                    }
                 }
             }
-        }
-    } while (found);
+        } while (found);
+    };
+    extendFrom(p1);
+    extendFrom(p2);
     graphicView->notifyChanged();
 }
 
@@ -278,6 +251,18 @@ void RS_Selection::selectLayer(RS_Entity *e){
  * Selects all entities on the given layer.
  */
 void RS_Selection::selectLayer(const QString &layerName, bool select){
+    if (graphic != nullptr && container == graphic) {
+        RS_Layer *layer = graphic->findLayer(layerName);
+        if (layer != nullptr && !layer->isLocked()) {
+            for (RS_Entity *en: graphic->getLayerEntities(layer)) {
+                if (en->isVisible() && en->isSelected() != select) {
+                    en->setSelected(select);
+                }
+            }
+        }
+        graphicView->notifyChanged();
+        return;
+    }
     for (auto en: *container) {
         // fixme - review and make more efficient... why check for locking upfront? Why just not use layer pointers but names?
         if (en && en->isVisible() &&
@@ -0,0 +1,123 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+
+#include <algorithm>
+#include <functional>
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QProcess>
+#include <QThread>
+
+#include "console_batch.h"
+
+namespace {
+    // files per process, so the start of a process is shared by a few files, while the
+    // processes still finish at about the same time
+    constexpr int maxBatchSize = 32;
+    constexpr int batchesPerJob = 4;
+}
+
+int consoleJobsCount(const QString& value){
+    if (value.isEmpty()) {
+        return 1;
+    }
+    bool ok = false;
+    int jobs = value.toInt(&ok);
+    if (!ok || jobs < 0) {
+        qDebug() << "WARNING: Ignoring bad number of jobs:" << value;
+        return 1;
+    }
+    if (jobs == 0) {
+        jobs = QThread::idealThreadCount();
+    }
+    return std::max(jobs, 1);
+}
+
+QStringList consoleForwardedOptions(const QCommandLineParser& parser,
+                                    const QList<const QCommandLineOption*>& options){
+    QStringList result;
+    for (const QCommandLineOption* option: options) {
+        if (!parser.isSet(*option)) {
+            continue;
+        }
+        result << "--" + option->names().constLast();
+        if (!option->valueName().isEmpty()) {
+            result << parser.value(*option);
+        }
+    }
+    return result;
+}
+
+int runConsoleBatch(const QString& tool, const QStringList& options, const QStringList& files, int jobs){
+    int batchSize = std::clamp(static_cast<int>(files.size()) / (jobs * batchesPerJob), 1, maxBatchSize);
+    QList<QStringList> batches;
+    for (int i = 0; i < files.size(); i += batchSize) {
+        batches.append(files.mid(i, batchSize));
+    }
+
+    QEventLoop loop;
+    int nextBatch = 0;
+    int running = 0;
+    bool failed = false;
+
+    std::function<void()> startNext = [&](){
+        while (running < jobs && nextBatch < batches.size()) {
+            auto *process = new QProcess(&loop);
+            process->setProcessChannelMode(QProcess::ForwardedChannels);
+            QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                             [&, process](int exitCode, QProcess::ExitStatus exitStatus){
+                                 if (exitStatus != QProcess::NormalExit || exitCode != EXIT_SUCCESS) {
+                                     failed = true;
+                                 }
+                                 running--;
+                                 process->deleteLater();
+                                 startNext();
+                                 if (running == 0) {
+                                     loop.quit();
+                                 }
+                             });
+
+            QStringList arguments;
+            arguments << tool << options << "--jobs" << "1" << batches.at(nextBatch++);
+            process->start(QCoreApplication::applicationFilePath(), arguments);
+            if (!process->waitForStarted()) {
+                qDebug() << "ERROR: Failed to start" << tool << "job:" << process->errorString();
+                failed = true;
+                delete process;
+                continue;
+            }
+            running++;
+        }
+    };
+
+    startNext();
+    if (running > 0) {
+        loop.exec();
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+**
+** This file was created for the LibreCAD project, a 2D CAD program.
+**
+** Copyright (C) 2024 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+******************************************************************************/
+#ifndef CONSOLE_BATCH_H
+#define CONSOLE_BATCH_H
+
+#include <QList>
+#include <QStringList>
+
+class QCommandLineOption;
+class QCommandLineParser;
+
+/**
+ * @return the number of jobs given by the value of the --jobs option, at least 1.
+ * A value of 0 means one job per processor.
+ */
+int consoleJobsCount(const QString& value);
+
+/**
+ * @return the given options which are set, with their values, to be passed to a batch job
+ */
+QStringList consoleForwardedOptions(const QCommandLineParser& parser,
+                                    const QList<const QCommandLineOption*>& options);
+
+/**
+ * Converts files by running the console tool in child processes of this executable,
+ * at most jobs processes at the same time. Each process converts a batch of the files,
+ * so the documents of different processes are loaded and rendered in parallel, while
+ * the memory of each process is bounded by the document it works on.
+ *
+ * @param tool - the console tool to run, e.g. dxf2pdf
+ * @param options - options of each run, without the input files
+ * @return EXIT_SUCCESS, if all processes succeeded
+ */
+int runConsoleBatch(const QString& tool, const QStringList& options, const QStringList& files, int jobs);
+
+#endif // CONSOLE_BATCH_H
@@ -35,6 +35,7 @@
 
 #include "main.h"
 
+#include "console_batch.h"
 #include "console_dxf2pdf.h"
 #include "pdf_print_loop.h"
 
@@ -76,6 +77,9 @@ int console_dxf2pdf(int argc, char* argv[])
     appDesc << "";
     appDesc << "  " + librecad + QObject::tr( " -o some.pdf *.dxf");
     appDesc << "    " + QObject::tr( "-- print all dxf files to 'some.pdf' file.");
+    appDesc << "";
+    appDesc << "  " + librecad + QObject::tr( " -j 4 *.dxf");
+    appDesc << "    " + QObject::tr( "-- print all dxf files to pdf files, four files at a time.");
     parser.setApplicationDescription( appDesc.join( "\n"));
 
     parser.addHelpOption();
@@ -125,6 +129,10 @@ int console_dxf2pdf(int argc, char* argv[])
         QObject::tr( "Target output directory."), "path");
     parser.addOption(outDirOpt);
 
+    QCommandLineOption jobsOpt(QStringList() << "j" << "jobs",
+        QObject::tr( "Number of dxf files printed at the same time to their own pdf files, 0 for one per processor. Ignored with an output PDF file."), "n");
+    parser.addOption(jobsOpt);
+
     parser.addPositionalArgument(QObject::tr( "<dxf_files>"), QObject::tr( "Input DXF file(s)"));
 
     parser.process(app);
@@ -176,6 +184,20 @@ int console_dxf2pdf(int argc, char* argv[])
         }
     }
 
+    int jobs = consoleJobsCount(parser.value(jobsOpt));
+    if (jobs > 1 && !params.outFile.isEmpty() && params.dxfFiles.size() > 1) {
+        // the pages of all files go to the single output file in order
+        qDebug() << "WARNING: Ignoring number of jobs, the files are printed one after another to"
+                 << params.outFile;
+    }
+    if (jobs > 1 && params.outFile.isEmpty() && params.dxfFiles.size() > 1) {
+        // each job is a process of its own, as documents share the font and pattern lists
+        QStringList options = consoleForwardedOptions(parser, {&fitOpt, &centerOpt, &grayOpt, &monoOpt,
+                                                               &pageSizeOpt, &resOpt, &scaleOpt, &marginsOpt,
+                                                               &pagesNumOpt, &outDirOpt});
+        return runConsoleBatch("dxf2pdf", options, params.dxfFiles, jobs);
+    }
+
     RS_FONTLIST->init();
     RS_PATTERNLIST->init();
 
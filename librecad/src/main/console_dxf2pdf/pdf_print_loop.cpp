@@ -22,6 +22,8 @@
 **
 ******************************************************************************/
 
+#include <memory>
+
 #include <QtCore>
 
 #include "rs.h"
@@ -92,72 +94,52 @@ void PdfPrintLoop::printOneDxfToOnePdf(const QString& dxfFile) {
 
 
 void PdfPrintLoop::printManyDxfToOnePdf() {
-    struct DxfContentItems {
-        RS_Document* doc;
-        RS_Graphic* graphic;
-        QString dxfFile;
-        QPageSize::PageSizeId paperSize;
-    };
-
     if (!params.outDir.isEmpty()) {
         QFileInfo outFileInfo(params.outFile);
         params.outFile = params.outDir + "/" + outFileInfo.fileName();
     }
 
-    QVector<DxfContentItems> contentItems;
-    int nrPages = 0;
+    QPrinter printer(QPrinter::HighResolution);
+    // The painter can only be created for a printer set up for the paper of the first
+    // opened dxf file. Each document is opened when its page is printed, and deleted
+    // right after, so only one document is in memory at a time.
+    std::unique_ptr<RS_Painter> painter;
 
-    // FIXME: Should probably open and print all dxf files in one 'for' loop.
-    // Tried but failed to do this. It looks like some 'chicken and egg'
-    // situation for the QPrinter and RS_PainterQt. Therefore, first open
-    // all dxf files and apply required actions. Then run another 'for'
-    // loop for actual printing.
     for (auto dxfFile : params.dxfFiles) {
-        DxfContentItems page;
-        page.dxfFile = dxfFile;
-        if (!openDocAndSetGraphic(&page.doc, &page.graphic, dxfFile))
+        RS_Document *doc;
+        RS_Graphic *graphic;
+        if (!openDocAndSetGraphic(&doc, &graphic, dxfFile))
             continue;
 
         qDebug() << "Opened" << dxfFile;
 
-        touchGraphic(page.graphic, params);
-        contentItems.append(page);
-        nrPages++;
-    }
-
-    QPrinter printer(QPrinter::HighResolution);
-
-    if (nrPages > 0) {
-        // FIXME: Is it possible to set up printer and paper for every
-        // opened dxf file and tie them with painter? For now just using
-        // data extracted from the first opened dxf file for all pages.
-        setupPrinterAndPaper(contentItems.at(0).graphic, printer, params);
-    }
-
-    RS_Painter painter(&printer);
-
-    if (params.monochrome)
-        painter.setDrawingMode(RS2::ModeBW);
-
-    // And now it's time to actually print all previously opened dxf files.
-    for (auto item : contentItems) {
-        nrPages--;
+        touchGraphic(graphic, params);
+
+        if (painter == nullptr) {
+            // FIXME: Is it possible to set up printer and paper for every
+            // opened dxf file and tie them with painter? For now just using
+            // data extracted from the first opened dxf file for all pages.
+            setupPrinterAndPaper(graphic, printer, params);
+            painter = std::make_unique<RS_Painter>(&printer);
+            if (params.monochrome)
+                painter->setDrawingMode(RS2::ModeBW);
+        } else {
+            printer.newPage();
+        }
 
-        qDebug() << "Printing" << item.dxfFile
+        qDebug() << "Printing" << dxfFile
                  << "to" << params.outFile << ">>>>";
 
-        drawGraphic(item.graphic, printer, painter);
+        drawGraphic(graphic, printer, *painter);
 
-        qDebug() << "Printing" << item.dxfFile
+        qDebug() << "Printing" << dxfFile
                  << "to" << params.outFile << "DONE";
 
-        delete item.doc;
-
-        if (nrPages > 0)
-            printer.newPage();
+        delete doc;
     }
 
-    painter.end();
+    if (painter != nullptr)
+        painter->end();
 }
 
 
@@ -33,6 +33,8 @@
 
 #include "main.h"
 
+#include "console_batch.h"
+
 #include "qc_applicationwindow.h"
 #include "qg_dialogfactory.h"
 
@@ -61,6 +63,9 @@ static void touchGraphic(RS_Graphic*);
 
 static QSize parsePngSizeArg(QString);
 
+static bool convertDxfFile(const QString& dxfFile, const QString& outFileName, const QString& extension,
+                           QSize pngSize);
+
 bool slotFileExport(RS_Graphic* graphic,
                     const QString& name,
                     const QString& format,
@@ -122,7 +127,7 @@ int console_dxf2png(int argc, char* argv[])
     appDesc += "\n\n";
     appDesc += "Examples:\n\n";
     appDesc += "  " + librecad + " dxf2png *.dxf";
-    appDesc += "    -- print a dxf file to a png file with the same name.\n";
+    appDesc += "    -- print dxf files to png files with the same names.\n";
     parser.setApplicationDescription(appDesc);
 
     parser.addHelpOption();
@@ -136,6 +141,10 @@ int console_dxf2png(int argc, char* argv[])
         "Output PNG size (Width x Height) in pixels.", "WxH");
     parser.addOption(pngSizeOpt);
 
+    QCommandLineOption jobsOpt(QStringList() << "j" << "jobs",
+        "Number of files converted at the same time, 0 for one per processor.", "n");
+    parser.addOption(jobsOpt);
+
     parser.addPositionalArgument("<dxf_files>", "Input DXF file");
 
     parser.process(app);
@@ -159,9 +168,43 @@ int console_dxf2png(int argc, char* argv[])
     if (dxfFiles.isEmpty())
         parser.showHelp(EXIT_FAILURE);
 
-    // Output setup
+    // dxf2png or dxf2svg, either the name of the executable, or its first argument
+    QString tool = allowed.count(args[0]) != 0 ? args[0] : prgInfo.baseName();
+
+    int jobs = consoleJobsCount(parser.value(jobsOpt));
+    if (jobs > 1 && dxfFiles.size() > 1) {
+        // each job is a process of its own, as documents share the font and pattern lists
+        QStringList options = consoleForwardedOptions(parser, {&pngSizeOpt});
+        return runConsoleBatch(tool, options, dxfFiles, jobs);
+    }
 
-    QString& dxfFile = dxfFiles[0];
+    // the output file name is for a single input file only
+    QString outFileName = parser.value(outFileOpt);
+    if (!outFileName.isEmpty() && dxfFiles.size() > 1) {
+        qDebug() << "WARNING: Ignoring output file name for many input files:" << outFileName;
+        outFileName.clear();
+    }
+
+    // The files are converted one after another, each document is deleted before the next one is opened
+    int ret = EXIT_SUCCESS;
+    for (const QString& dxfFile: dxfFiles) {
+        if (!convertDxfFile(dxfFile, outFileName, tool.mid(tool.size()-3), pngSize)) {
+            ret = EXIT_FAILURE;
+        }
+    }
+    return ret;
+}
+
+/////////
+/// \brief convertDxfFile converts a DXF file to an image file
+/// \param outFileName - output file name, or empty for the name of the DXF file
+/// \param extension - extension of the output file, if its name is not given
+/// \return true on success
+///
+static bool convertDxfFile(const QString& dxfFile, const QString& outFileName, const QString& extension,
+                           QSize pngSize)
+{
+    // Output setup
 
     QFileInfo dxfFileInfo(dxfFile);
     QString fn = dxfFileInfo.completeBaseName(); // original DXF file name
@@ -169,9 +212,9 @@ int console_dxf2png(int argc, char* argv[])
         fn = "unnamed";
 
     // Set output filename from user input if present
-    QString outFile = parser.value(outFileOpt);
+    QString outFile = outFileName;
     if (outFile.isEmpty()) {
-        outFile = dxfFileInfo.path() + "/" + fn + "." + args[0].mid(args[0].size()-3);
+        outFile = dxfFileInfo.path() + "/" + fn + "." + extension;
     } else {
         outFile = dxfFileInfo.path() + "/" + outFile;
     }
@@ -181,7 +224,7 @@ int console_dxf2png(int argc, char* argv[])
     std::unique_ptr<RS_Document> doc = openDocAndSetGraphic(dxfFile);
 
     if (doc == nullptr || doc->getGraphic() == nullptr)
-        return 1;
+        return false;
     RS_Graphic *graphic = doc->getGraphic();
 
     LC_LOG << "Printing" << dxfFile << "to" << outFile << ">>>>";
@@ -216,7 +259,7 @@ int console_dxf2png(int argc, char* argv[])
     }
 
     qDebug() << "Printing" << dxfFile << "to" << outFile << (ret ? "Done" : "Failed");
-    return 0;
+    return ret;
 }
 
 
@@ -308,6 +308,8 @@ HEADERS += \
     lib/engine/document/views/lc_viewslist.h \
     lib/engine/document/entities/lc_cachedlengthentity.h \
     lib/engine/overlays/crosshair/lc_crosshair.h \
+    lib/engine/document/container/lc_entityiterator.h \
+    lib/engine/document/container/lc_intersectionjob.h \
     lib/engine/document/container/lc_looputils.h \
     lib/engine/document/entities/lc_parabola.h \
     lib/engine/overlays/references/lc_refarc.h \
@@ -341,11 +343,13 @@ HEADERS += \
     lib/engine/document/entities/rs_entity.h \
     lib/engine/document/container/rs_entitycontainer.h \
     lib/engine/rs_flags.h \
+    lib/engine/document/fonts/lc_glyphrun.h \
     lib/engine/document/fonts/rs_font.h \
     lib/engine/document/fonts/rs_fontchar.h \
     lib/engine/document/fonts/rs_fontlist.h \
     lib/engine/document/rs_graphic.h \
     lib/engine/document/entities/rs_hatch.h \
+    lib/engine/document/entities/lc_hatchscanline.h \
     lib/engine/document/entities/lc_hyperbola.h \
     lib/engine/document/entities/rs_insert.h \
     lib/engine/document/entities/rs_image.h \
@@ -380,6 +384,7 @@ HEADERS += \
     lib/engine/document/variables/rs_variable.h \
     lib/engine/document/variables/rs_variabledict.h \
     lib/engine/rs_vector.h \
+    lib/fileio/lc_backgroundsave.h \
     lib/fileio/rs_fileio.h \
     lib/filters/rs_filtercxf.h \
     lib/filters/rs_filterdxfrw.h \
@@ -442,6 +447,7 @@ HEADERS += \
     lib/gui/rs_dialogfactoryinterface.h \
     lib/gui/rs_eventhandler.h \
     lib/gui/rs_graphicview.h \
+    lib/gui/lc_snapworker.h \
     lib/gui/grid/rs_grid.h \
     lib/gui/rs_linetypepattern.h \
     lib/gui/rs_mainwindowinterface.h \
@@ -451,18 +457,23 @@ HEADERS += \
     lib/information/rs_locale.h \
     lib/information/rs_information.h \
     lib/information/rs_infoarea.h \
+    lib/information/lc_intersections.h \
     lib/math/lc_convert.h \
     lib/math/lc_linemath.h \
     lib/modification/rs_modification.h \
     lib/modification/rs_selection.h \
     lib/math/rs_math.h \
     lib/math/lc_quadratic.h \
+    main/console_batch.h \
     main/console_dxf2png.h \
     test/lc_simpletests.h \
     lib/generators/lc_makercamsvg.h \
     lib/generators/lc_xmlwriterinterface.h \
     lib/generators/lc_xmlwriterqxmlstreamwriter.h \
     lib/engine/document/entities/lc_rect.h \
+    lib/engine/utils/lc_imagecache.h \
+    lib/engine/utils/lc_parallelupdate.h \
+    lib/engine/utils/lc_endpointgraph.h \
     lib/engine/utils/lc_rtree.h \
     lib/engine/undo/lc_undosection.h \
     lib/printing/lc_printing.h \
@@ -546,6 +557,8 @@ SOURCES += \
     lib/engine/document/views/lc_viewslist.cpp \
     lib/engine/document/entities/lc_cachedlengthentity.cpp \
     lib/engine/overlays/crosshair/lc_crosshair.cpp \
+    lib/engine/document/container/lc_entityiterator.cpp \
+    lib/engine/document/container/lc_intersectionjob.cpp \
     lib/engine/document/container/lc_looputils.cpp \
     lib/engine/document/entities/lc_parabola.cpp \
     lib/engine/overlays/references/lc_refarc.cpp \
@@ -570,10 +583,12 @@ SOURCES += \
     lib/engine/document/entities/rs_ellipse.cpp \
     lib/engine/document/entities/rs_entity.cpp \
     lib/engine/document/container/rs_entitycontainer.cpp \
+    lib/engine/document/fonts/lc_glyphrun.cpp \
     lib/engine/document/fonts/rs_font.cpp \
     lib/engine/document/fonts/rs_fontlist.cpp \
     lib/engine/document/rs_graphic.cpp \
     lib/engine/document/entities/rs_hatch.cpp \
+    lib/engine/document/entities/lc_hatchscanline.cpp \
     lib/engine/document/entities/lc_hyperbola.cpp \
     lib/engine/document/entities/rs_insert.cpp \
     lib/engine/document/entities/rs_image.cpp \
@@ -600,6 +615,7 @@ SOURCES += \
     lib/engine/utils/rs_utility.cpp \
     lib/engine/document/variables/rs_variabledict.cpp \
     lib/engine/rs_vector.cpp \
+    lib/fileio/lc_backgroundsave.cpp \
     lib/fileio/rs_fileio.cpp \
     lib/filters/rs_filtercxf.cpp \
     lib/filters/rs_filterdxfrw.cpp \
@@ -640,6 +656,7 @@ SOURCES += \
     lib/gui/rs_dialogfactory.cpp \
     lib/gui/rs_eventhandler.cpp \
     lib/gui/rs_graphicview.cpp \
+    lib/gui/lc_snapworker.cpp \
     lib/gui/grid/rs_grid.cpp \
     lib/gui/rs_linetypepattern.cpp \
     lib/gui/render/rs_painter.cpp \
@@ -648,6 +665,7 @@ SOURCES += \
     lib/information/rs_locale.cpp \
     lib/information/rs_information.cpp \
     lib/information/rs_infoarea.cpp \
+    lib/information/lc_intersections.cpp \
     lib/math/lc_convert.cpp \
     lib/math/lc_linemath.cpp \
     lib/math/rs_math.cpp \
@@ -656,6 +674,7 @@ SOURCES += \
     lib/modification/rs_selection.cpp \
     lib/engine/rs_color.cpp \
     lib/engine/rs_pen.cpp \
+    main/console_batch.cpp \
     main/console_dxf2png.cpp \
     test/lc_simpletests.cpp \
     lib/generators/lc_xmlwriterqxmlstreamwriter.cpp \
@@ -664,6 +683,9 @@ SOURCES += \
     lib/engine/undo/rs_undocycle.cpp \
     lib/engine/rs_flags.cpp \
     lib/engine/document/entities/lc_rect.cpp \
+    lib/engine/utils/lc_imagecache.cpp \
+    lib/engine/utils/lc_parallelupdate.cpp \
+    lib/engine/utils/lc_endpointgraph.cpp \
     lib/engine/utils/lc_rtree.cpp \
     lib/engine/undo/lc_undosection.cpp \
     lib/engine/rs.cpp \
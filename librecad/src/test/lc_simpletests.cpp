@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <QMenuBar>
 #include "lc_simpletests.h"
 #include "qc_applicationwindow.h"
@@ -21,11 +24,14 @@
 #include "rs_insert.h"
 #include "rs_mtext.h"
 #include "rs_point.h"
+#include "rs_polyline.h"
 #include "rs_text.h"
 #include "rs_entitycontainer.h"
 #include "rs_layer.h"
 #include "rs_graphicview.h"
 #include "rs_debug.h"
+#include "rs_settings.h"
+#include "lc_intersections.h"
 
 LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 	QObject(parent)
@@ -95,6 +101,26 @@ LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 				this, SLOT(slotTestMath01()));
 		testMenu->addAction(action);
 
+		action = new QAction("Check Intersections", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestIntersections()));
+		testMenu->addAction(action);
+
+		action = new QAction("Check Insert Copies", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestInsertCopies()));
+		testMenu->addAction(action);
+
+		action = new QAction("Check Remove Layer", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestRemoveLayer()));
+		testMenu->addAction(action);
+
+		action = new QAction("Time Batched Rendering", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestBatchedRendering()));
+		testMenu->addAction(action);
+
 		action = new QAction("Resize to 640x480", this);
 		connect(action, SIGNAL(triggered()),
 				this, SLOT(slotTestResize640()));
@@ -1074,6 +1100,369 @@ void LC_SimpleTests::slotTestMath01() {
 	RS_DEBUG->print("%s\n: end\n", __func__);
 }
 
+/**
+ * Testing function.
+ *
+ * Every intersection found by LC_Intersections::findAll() among the visible
+ * entities of the document has to be found by LC_Intersections::findWith()
+ * for its entity as well.
+ */
+void LC_SimpleTests::slotTestIntersections() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	RS_Document* d = QC_ApplicationWindow::getAppWindow()->getDocument();
+	if (d) {
+		std::vector<RS_Entity*> entities;
+		for (RS_Entity* e: *d) {
+			if (e->isVisible()) {
+				entities.push_back(e);
+			}
+		}
+		const auto all = LC_Intersections::findAll(entities);
+		size_t checked = 0;
+		size_t missing = 0;
+		for (const LC_Intersections::Intersection& info: all) {
+			// findWith() doesn't resolve the given entity
+			if (info.first != info.firstOwner) {
+				continue;
+			}
+			++checked;
+			const auto with = LC_Intersections::findWith(info.first, *d);
+			bool found = std::any_of(with.cbegin(), with.cend(),
+									 [&info](const LC_Intersections::Intersection& other) {
+				return other.second == info.second
+					   && other.point.distanceTo(info.point) < RS_TOLERANCE;
+			});
+			if (!found) {
+				++missing;
+				RS_DEBUG->print(RS_Debug::D_WARNING, "%s: (%g, %g) of entity %lu not found by findWith()",
+								__func__, info.point.x, info.point.y, info.first->getId());
+			}
+		}
+		RS_DEBUG->print(RS_Debug::D_WARNING, "%s: %zu entities, %zu intersections, %zu checked, %zu missing",
+						__func__, entities.size(), all.size(), checked, missing);
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+namespace {
+	using ToDrawing = std::function<RS_Vector(const RS_Vector&)>;
+
+	void checkInsertCopies(const RS_Insert* insert, const RS_Insert::CopyAttributes& attributes,
+						   RS_EntityContainer& copies, const ToDrawing& toDrawing,
+						   size_t& checked, size_t& failed);
+
+	/**
+	 * Compares the attributes of an entity of a block, as the block is drawn through the insert,
+	 * with the ones of its copy created by the insert
+	 */
+	void checkInsertCopy(const RS_Insert* insert, const RS_Insert::CopyAttributes& attributes,
+						 RS_Entity* blockEntity, RS_Entity* copy, const ToDrawing& toDrawing,
+						 size_t& checked, size_t& failed) {
+		const RS_Insert::CopyAttributes drawn = insert->getCopyAttributes(blockEntity, attributes);
+		const RS_Pen pen = copy->getPenResolved();
+		bool same = drawn.penResolved.getColor() == pen.getColor()
+					&& drawn.penResolved.getWidth() == pen.getWidth()
+					&& drawn.penResolved.getLineType() == pen.getLineType()
+					&& drawn.layerResolved == copy->getLayerResolved()
+					&& drawn.isVisible(blockEntity) == copy->isVisible()
+					&& drawn.isPrint() == copy->isPrint()
+					&& drawn.isConstruction(blockEntity) == copy->isConstruction();
+		if (blockEntity->rtti() == RS2::EntityLine && copy->rtti() == RS2::EntityLine) {
+			// the copies are moved, rotated and scaled step by step
+			constexpr double tolerance = 1.0e-6;
+			const auto* line = static_cast<RS_Line*>(blockEntity);
+			const auto* copyLine = static_cast<RS_Line*>(copy);
+			same = same
+				   && toDrawing(line->getStartpoint()).distanceTo(copyLine->getStartpoint()) < tolerance
+				   && toDrawing(line->getEndpoint()).distanceTo(copyLine->getEndpoint()) < tolerance;
+		}
+		++checked;
+		if (!same) {
+			++failed;
+			RS_DEBUG->print(RS_Debug::D_WARNING, "%s: entity %lu of block %s differs from its copy %lu",
+							__func__, blockEntity->getId(), insert->getName().toLatin1().data(), copy->getId());
+		}
+
+		if (blockEntity->rtti() == RS2::EntityInsert && copy->rtti() == RS2::EntityInsert) {
+			checkInsertCopies(static_cast<RS_Insert*>(blockEntity), drawn, *static_cast<RS_Insert*>(copy),
+							  toDrawing, checked, failed);
+		} else if (blockEntity->rtti() == RS2::EntityPolyline && copy->rtti() == RS2::EntityPolyline) {
+			auto* segments = static_cast<RS_EntityContainer*>(blockEntity);
+			auto* copySegments = static_cast<RS_EntityContainer*>(copy);
+			for (unsigned i = 0; i < std::min(segments->count(), copySegments->count()); ++i) {
+				checkInsertCopy(insert, attributes, segments->entityAt(i), copySegments->entityAt(i),
+								toDrawing, checked, failed);
+			}
+		}
+	}
+
+	/**
+	 * Compares the entities of the block of an insert with the copies, in the order created by
+	 * RS_Insert::createEntities()
+	 */
+	void checkInsertCopies(const RS_Insert* insert, const RS_Insert::CopyAttributes& attributes,
+						   RS_EntityContainer& copies, const ToDrawing& toDrawing,
+						   size_t& checked, size_t& failed) {
+		RS_Block* block = insert->getBlockForInsert();
+		if (block == nullptr) {
+			return;
+		}
+		int index = 0;
+		for (RS_Entity* e: *block) {
+			for (int c = 0; c < insert->getCols(); ++c) {
+				for (int r = 0; r < insert->getRows(); ++r) {
+					RS_Entity* copy = copies.entityAt(index++);
+					if (copy == nullptr) {
+						++failed;
+						RS_DEBUG->print(RS_Debug::D_WARNING, "%s: block %s has more entities than copies",
+										__func__, insert->getName().toLatin1().data());
+						return;
+					}
+					const ToDrawing toCopy = [&toDrawing, insert, block, c, r](const RS_Vector& v) {
+						return toDrawing(insert->toInsertCoordinates(v, block->getBasePoint(), c, r));
+					};
+					checkInsertCopy(insert, attributes, e, copy, toCopy, checked, failed);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Adds the blocks and inserts of the copies test, unless they are there: a nested block, pens by
+	 * block and by layer, a frozen and a construction layer, arrayed and rotated inserts
+	 */
+	void addInsertCopiesTest(RS_Graphic* graphic) {
+		if (graphic->findBlock("debugcopies") != nullptr) {
+			return;
+		}
+		auto* frozen = new RS_Layer("debug frozen");
+		frozen->freeze(true);
+		graphic->addLayer(frozen);
+		auto* construction = new RS_Layer("debug construction");
+		construction->toggleConstruction();
+		graphic->addLayer(construction);
+		auto* byLayer = new RS_Layer("debug pen");
+		byLayer->setPen(RS_Pen(RS_Color(0, 128, 255), RS2::Width05, RS2::DashLine));
+		graphic->addLayer(byLayer);
+		RS_Layer* layer0 = graphic->findLayer("0");
+		const RS_Pen penByBlock(RS_Color(RS2::FlagByBlock), RS2::WidthByBlock, RS2::LineByBlock);
+		const RS_Pen penByLayer(RS_Color(RS2::FlagByLayer), RS2::WidthByLayer, RS2::LineByLayer);
+
+		auto* nested = new RS_Block(graphic, RS_BlockData("debugnested", RS_Vector(5.0, 5.0), false));
+		auto* line = new RS_Line{nested, {0., 0.}, {10., 0.}};
+		line->setLayer(layer0);
+		line->setPen(penByBlock);
+		nested->addEntity(line);
+		line = new RS_Line{nested, {0., 0.}, {0., 10.}};
+		line->setLayer(construction);
+		line->setPen(penByLayer);
+		nested->addEntity(line);
+		auto* circle = new RS_Circle(nested, RS_CircleData({5.0, 5.0}, 2.5));
+		circle->setLayer(frozen);
+		circle->setPen(penByLayer);
+		nested->addEntity(circle);
+		graphic->addBlock(nested);
+
+		auto* block = new RS_Block(graphic, RS_BlockData("debugcopies", RS_Vector(0.0, 0.0), false));
+		line = new RS_Line{block, {0., 0.}, {50., 0.}};
+		line->setLayer(layer0);
+		line->setPen(penByBlock);
+		block->addEntity(line);
+		line = new RS_Line{block, {50., 0.}, {50., 50.}};
+		line->setLayer(byLayer);
+		line->setPen(penByLayer);
+		block->addEntity(line);
+		auto* polyline = new RS_Polyline(block);
+		polyline->setLayer(layer0);
+		polyline->setPen(penByBlock);
+		polyline->addVertex({0., 10.});
+		polyline->addVertex({20., 10.}, 0.5);
+		polyline->addVertex({20., 30.});
+		block->addEntity(polyline);
+		RS_InsertData nestedData("debugnested", RS_Vector(30.0, 30.0), RS_Vector(0.5, 0.5), M_PI/4.,
+								 2, 1, RS_Vector(15.0, 0.0), nullptr, RS2::NoUpdate);
+		auto* nestedInsert = new RS_Insert(block, nestedData);
+		nestedInsert->setLayer(layer0);
+		nestedInsert->setPen(penByBlock);
+		block->addEntity(nestedInsert);
+		graphic->addBlock(block);
+
+		struct {
+			RS_Layer* layer;
+			RS_Vector scale;
+			int cols;
+			int rows;
+		} inserts[] = {{byLayer, {1.0, 1.0}, 3, 2}, {frozen, {1.0, 1.0}, 1, 1},
+					   {construction, {2.0, 2.0}, 1, 1}, {byLayer, {-1.0, 1.0}, 2, 2}};
+		double y = 0.;
+		for (const auto& i: inserts) {
+			RS_InsertData data("debugcopies", RS_Vector(200.0, y), i.scale, M_PI/6.,
+							   i.cols, i.rows, RS_Vector(80.0, 80.0), nullptr, RS2::NoUpdate);
+			auto* insert = new RS_Insert(graphic, data);
+			insert->setLayer(i.layer);
+			insert->setPen(RS_Pen(RS_Color(255, 0, 255), RS2::Width02, RS2::SolidLine));
+			insert->update();
+			graphic->addEntity(insert);
+			y += 250.;
+		}
+	}
+}
+
+/**
+ * Checks the attributes and the positions of block entities, as the inserts draw them without
+ * copies, against the copies created by the inserts. Adds test inserts first.
+ */
+void LC_SimpleTests::slotTestInsertCopies() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	RS_Document* d = QC_ApplicationWindow::getAppWindow()->getDocument();
+	if (d && d->rtti()==RS2::EntityGraphic) {
+		auto* graphic = static_cast<RS_Graphic*>(d);
+		addInsertCopiesTest(graphic);
+		size_t inserts = 0;
+		size_t checked = 0;
+		size_t failed = 0;
+		for (RS_Entity* e: *graphic) {
+			if (e->rtti() != RS2::EntityInsert || e->isUndone()) {
+				continue;
+			}
+			++inserts;
+			auto* insert = static_cast<RS_Insert*>(e);
+			// the copies are created by a clone, the insert keeps drawing the block
+			std::unique_ptr<RS_Insert> copies{static_cast<RS_Insert*>(insert->clone())};
+			checkInsertCopies(insert, insert->getAttributes(), *copies,
+							  [](const RS_Vector& v) {return v;}, checked, failed);
+		}
+		RS_DEBUG->print(RS_Debug::D_WARNING, "%s: %zu inserts, %zu entities checked, %zu differ",
+						__func__, inserts, checked, failed);
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Removes a layer used by top level entities, by entities of a block and through an insert of
+ * that block, and checks that all of them move to layer 0, as they did before the entities of
+ * the graphic were kept by layer.
+ */
+void LC_SimpleTests::slotTestRemoveLayer() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	RS_Document* d = QC_ApplicationWindow::getAppWindow()->getDocument();
+	if (d && d->rtti()==RS2::EntityGraphic) {
+		auto* graphic = static_cast<RS_Graphic*>(d);
+		RS_Layer* layer0 = graphic->findLayer("0");
+		QString name;
+		for (int i = 1; name.isEmpty() || graphic->findLayer(name) != nullptr
+						|| graphic->findBlock(name) != nullptr; ++i) {
+			name = QString("debug removed %1").arg(i);
+		}
+		auto* layer = new RS_Layer(name);
+		graphic->addLayer(layer);
+		// a layer of the same name, not in the list, as for entities pasted from another drawing
+		std::unique_ptr<RS_Layer> pasted{new RS_Layer(name)};
+		// build the layer buckets first, so the entities below are added to them
+		graphic->getLayerEntities(layer);
+
+		auto* block = new RS_Block(graphic, RS_BlockData(name, RS_Vector(0.0, 0.0), false));
+		auto* onLayer = new RS_Line{block, {0., 0.}, {10., 0.}};
+		onLayer->setLayer(layer);
+		block->addEntity(onLayer);
+		auto* byBlock = new RS_Line{block, {0., 0.}, {0., 10.}};
+		byBlock->setLayer(nullptr);
+		block->addEntity(byBlock);
+		auto* onLayer0 = new RS_Line{block, {10., 0.}, {0., 10.}};
+		onLayer0->setLayer(layer0);
+		block->addEntity(onLayer0);
+		graphic->addBlock(block);
+
+		auto* insert = new RS_Insert(graphic, RS_InsertData(name, RS_Vector(0.0, -50.0), RS_Vector(1.0, 1.0),
+															 0., 1, 1, RS_Vector(0.0, 0.0), nullptr, RS2::NoUpdate));
+		insert->setLayer(layer);
+		insert->update();
+		graphic->addEntity(insert);
+		auto* line = new RS_Line{graphic, {0., -60.}, {10., -60.}};
+		line->setLayer(pasted.get());
+		graphic->addEntity(line);
+		auto* line0 = new RS_Line{graphic, {0., -70.}, {10., -70.}};
+		line0->setLayer(layer0);
+		graphic->addEntity(line0);
+
+		graphic->removeLayer(layer);
+
+		size_t failed = 0;
+		const auto check = [&failed](const char* what, bool ok) {
+			if (!ok) {
+				++failed;
+				RS_DEBUG->print(RS_Debug::D_WARNING, "slotTestRemoveLayer: %s", what);
+			}
+		};
+		check("the layer is still in the list", graphic->findLayer(name) == nullptr);
+		check("the insert is not on layer 0", insert->getLayer(false) == layer0 && insert->isUndone());
+		check("the pasted line is not on layer 0", line->getLayer(false) == layer0 && line->isUndone());
+		check("a line on layer 0 is removed", !line0->isUndone());
+		check("the block entity is not on layer 0", onLayer->getLayer(false) == layer0);
+		check("a block entity of layer 0 is removed", !onLayer0->isUndone());
+		check("a block entity by block got a layer", byBlock->getLayer(false) == nullptr && !byBlock->isUndone());
+		const std::vector<RS_Entity*> entities0 = graphic->getLayerEntities(layer0);
+		check("the insert is not in the entities of layer 0",
+			  std::find(entities0.begin(), entities0.end(), insert) != entities0.end());
+		RS_DEBUG->print(RS_Debug::D_WARNING, "%s: layer %s removed, %zu checks failed",
+						__func__, name.toLatin1().data(), failed);
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Adds 100k solid lines in runs of 250 lines with the same color, unless the drawing has that many
+ * entities already. Then draws the drawing several times with the batched rendering off and on,
+ * and prints the average time of drawing the entities for both.
+ */
+void LC_SimpleTests::slotTestBatchedRendering() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	auto& appWin=QC_ApplicationWindow::getAppWindow();
+	RS_Document* d = appWin->getDocument();
+	RS_GraphicView* v = appWin->getGraphicView();
+	if (d && v && d->rtti()==RS2::EntityGraphic) {
+		auto* graphic = static_cast<RS_Graphic*>(d);
+		constexpr int rows = 400;
+		constexpr int cols = 250;
+		if (graphic->count() < rows * cols) {
+			const RS_Color colors[] = {RS_Color(255, 255, 255), RS_Color(255, 0, 0),
+									   RS_Color(0, 255, 0), RS_Color(0, 128, 255)};
+			for (int r = 0; r < rows; ++r) {
+				const RS_Pen pen(colors[r % 4], RS2::Width00, RS2::SolidLine);
+				for (int c = 0; c < cols; ++c) {
+					const RS_Vector start(c * 4.0, r * 4.0);
+					auto* line = new RS_Line{graphic, start, start + RS_Vector(3.0, (c % 3) * 1.5)};
+					line->setLayerToActive();
+					line->setPen(pen);
+					graphic->addEntity(line);
+				}
+			}
+			v->zoomAuto();
+		}
+
+		constexpr int frames = 10;
+		const bool batched = LC_GET_ONE_BOOL("Render", "BatchedRendering", false);
+		qint64 times[2] = {0, 0};
+		for (int mode = 0; mode < 2; ++mode) {
+			LC_SET_ONE("Render", "BatchedRendering", mode == 1);
+			v->loadSettings();
+			for (int i = 0; i < frames; ++i) {
+				v->redraw(RS2::RedrawDrawing);
+				v->repaint();
+				times[mode] += v->getLastEntitiesTime();
+			}
+		}
+		LC_SET_ONE("Render", "BatchedRendering", batched);
+		v->loadSettings();
+		v->redraw();
+
+		RS_DEBUG->print(RS_Debug::D_WARNING, "%s: %u entities, %d frames: %.1f ms one by one, %.1f ms batched",
+						__func__, graphic->count(), frames,
+						times[0] * 1e-6 / frames, times[1] * 1e-6 / frames);
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
 /**
  * Testing function.
  */
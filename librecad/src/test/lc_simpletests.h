@@ -35,6 +35,14 @@ public slots:
 	void slotTestUnicode();
 	/** math experimental */
 	void slotTestMath01();
+	/** checks the batch intersections of the document against the intersections of each entity */
+	void slotTestIntersections();
+	/** checks the attributes of block entities drawn through inserts against the copies created by the inserts */
+	void slotTestInsertCopies();
+	/** removes a layer used directly, in a block and through an insert, and checks the entities moved to layer 0 */
+	void slotTestRemoveLayer();
+	/** draws 100k lines with and without the batched rendering, and prints the times of both */
+	void slotTestBatchedRendering();
 	/** resizes window to 640x480 for screen shots */
 	void slotTestResize640();
 	/** resizes window to 640x480 for screen shots */
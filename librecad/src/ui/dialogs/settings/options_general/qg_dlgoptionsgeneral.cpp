@@ -431,6 +431,9 @@ void QG_DlgOptionsGeneral::init(){
         double minLineLen = minLineLen100 / 100.0;
         sbRenderMinLineLen->setValue(minLineLen);
 
+        int minContainerSize100 = LC_GET_INT("MinContainerSize", 200);
+        sbRenderMinContainerSize->setValue(minContainerSize100 / 100.0);
+
         int minEllipseMajor100 = LC_GET_INT("MinEllipseMajor", 200);
         double minEllipseMajor = minEllipseMajor100 / 100.0;
         sbRenderMinEllipseMajor->setValue(minEllipseMajor);
@@ -461,6 +464,10 @@ void QG_DlgOptionsGeneral::init(){
 
         bool checked = LC_GET_BOOL("CircleRenderAsArcs", false);
         rbRenderCirclesAsArcs->setChecked(checked);
+
+        sbRegenerationThreads->setValue(LC_GET_INT("RegenerationThreads", 0));
+        cbBatchedRendering->setChecked(LC_GET_BOOL("BatchedRendering", false));
+        cbShowFrameTime->setChecked(LC_GET_BOOL("ShowFrameTime", false));
     }
 
     LC_GROUP("NewDrawingDefaults");
@@ -534,6 +541,8 @@ void QG_DlgOptionsGeneral::init(){
         bool autoBackup = LC_GET_BOOL("AutoBackupDocument", true);
         cbAutoBackup->setChecked(autoBackup);
         cbAutoSaveTime->setEnabled(autoBackup);
+        sbMaxUndoCycles->setValue(LC_GET_INT("MaxUndoCycles", 1000));
+        sbMaxUndoMemory->setValue(LC_GET_INT("MaxUndoMemory", 512));
         cbUseQtFileOpenDialog->setChecked(LC_GET_BOOL("UseQtFileOpenDialog", true));
         cbWheelScrollInvertH->setChecked(LC_GET_BOOL("WheelScrollInvertH"));
         cbWheelScrollInvertV->setChecked(LC_GET_BOOL("WheelScrollInvertV"));
@@ -768,6 +777,7 @@ void QG_DlgOptionsGeneral::ok(){
             LC_SET("MinLineLen", (int) (sbRenderMinLineLen->value() * 100));
             LC_SET("MinEllipseMajor", (int) (sbRenderMinEllipseMajor->value() * 100));
             LC_SET("MinEllipseMinor", (int) (sbRenderMinEllipseMinor->value() * 100));
+            LC_SET("MinContainerSize", (int) (sbRenderMinContainerSize->value() * 100));
             LC_SET("DrawTextsAsDraftInPanning", cbTextDraftOnPanning->isChecked());
             LC_SET("DrawTextsAsDraftInPreview", cbTextDraftInPreview->isChecked());
 
@@ -776,6 +786,9 @@ void QG_DlgOptionsGeneral::ok(){
             LC_SET("ArcRenderInterpolateSegmentAngle", sbRenderArcSegmentAngle->value() * 100);
             LC_SET("ArcRenderInterpolateSegmentSagitta", sbRenderArcMaxSagitta->value() * 100);
             LC_SET("CircleRenderAsArcs", rbRenderCirclesAsArcs->isChecked());
+            LC_SET("RegenerationThreads", sbRegenerationThreads->value());
+            LC_SET("BatchedRendering", cbBatchedRendering->isChecked());
+            LC_SET("ShowFrameTime", cbShowFrameTime->isChecked());
         }
 
         LC_GROUP("Colors"); {
@@ -831,6 +844,8 @@ void QG_DlgOptionsGeneral::ok(){
             LC_SET("Unit", RS_Units::unitToString(RS_Units::stringToUnit(cbUnit->currentText()), false/*untr.*/));
             LC_SET("AutoSaveTime", cbAutoSaveTime->value());
             LC_SET("AutoBackupDocument", cbAutoBackup->isChecked());
+            LC_SET("MaxUndoCycles", sbMaxUndoCycles->value());
+            LC_SET("MaxUndoMemory", sbMaxUndoMemory->value());
             LC_SET("UseQtFileOpenDialog", cbUseQtFileOpenDialog->isChecked());
             LC_SET("WheelScrollInvertH", cbWheelScrollInvertH->isChecked());
             LC_SET("WheelScrollInvertV", cbWheelScrollInvertV->isChecked());
@@ -1447,8 +1447,8 @@ void LC_LayerTreeWidget::deselectEntitiesOnLockedLayer(RS_Layer *layer){
     if (!layer) return;
     if (!layer->isLocked()) return;
 
-    for (auto e: *document) {
-        if (e && e->isVisible() && e->getLayer() == layer){
+    for (auto e: document->getLayerEntities(layer)) {
+        if (e->isVisible()){
             e->setSelected(false);
         }
     }
@@ -1463,8 +1463,8 @@ void LC_LayerTreeWidget::deselectEntitiesOnLockedLayer(RS_Layer *layer){
 void LC_LayerTreeWidget::deselectEntities(RS_Layer *layer){
     if (!layer) return;
 
-    for (auto e: *document) {
-        if (e && e->isVisible() && e->getLayer() == layer){
+    for (auto e: document->getLayerEntities(layer)) {
+        if (e->isVisible()){
             e->setSelected(false);
         }
     }
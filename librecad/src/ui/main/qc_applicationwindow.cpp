@@ -72,6 +72,7 @@
 
 #include "lc_actionfactory.h"
 #include "lc_actiongroupmanager.h"
+#include "lc_backgroundsave.h"
 #include "lc_centralwidget.h"
 #include "lc_penwizard.h"
 #include "qg_librarywidget.h"
@@ -1757,27 +1758,33 @@ void QC_ApplicationWindow::slotFileAutoSave() {
         return;
     }
 
-    statusBar()->showMessage(tr("Auto-saving drawing..."), 2000);
-
     QC_MDIWindow *w = getMDIWindow();
-    if (w) {
-        bool cancelled;
-        if (w->slotFileSave(cancelled, true)) {
-            // auto-save cannot be cancelled by user, so the
-            // "cancelled" parameter is a dummy
+    // the drawing is saved from a copy by a worker thread, editing continues
+    LC_BackgroundSave *autoSave = w != nullptr ? w->startAutoSave() : nullptr;
+    if (autoSave == nullptr) {
+        return;
+    }
+    statusBar()->showMessage(tr("Auto-saving drawing..."));
+    connect(autoSave, &LC_BackgroundSave::progress, this, [this](int percent) {
+        statusBar()->showMessage(tr("Auto-saving drawing... %1%").arg(percent));
+    });
+    connect(autoSave, &LC_BackgroundSave::finished, this, [this, fileName = autoSave->getFileName()](bool success) {
+        if (success) {
             statusBar()->showMessage(tr("Auto-saved drawing"), 2000);
         } else {
             // error
-            m_autosaveTimer->stop();
+            if (m_autosaveTimer != nullptr) {
+                m_autosaveTimer->stop();
+            }
             QMessageBox::information(this, QMessageBox::tr("Warning"),
                                      tr("Cannot auto-save the file\n%1\nPlease "
                                         "check the permissions.\n"
                                         "Auto-save disabled.")
-                                         .arg(w->getDocument()->getAutoSaveFilename()),
+                                         .arg(fileName),
                                      QMessageBox::Ok);
             statusBar()->showMessage(tr("Auto-saving failed"), 2000);
         }
-    }
+    });
 }
 
 
@@ -37,6 +37,7 @@
 #include <QMdiArea>
 #include <QPainter>
 
+#include "lc_backgroundsave.h"
 #include "qc_applicationwindow.h"
 #include "qc_mdiwindow.h"
 
@@ -452,6 +453,25 @@ bool QC_MDIWindow::slotFileSave(bool &cancelled, bool isAutoSave) {
 
 
 
+LC_BackgroundSave* QC_MDIWindow::startAutoSave() {
+    RS_Graphic* graphic = document != nullptr ? document->getGraphic() : nullptr;
+    if (graphic == nullptr || !graphic->isModified()
+        || (autoSave != nullptr && autoSave->isRunning())) {
+        return nullptr;
+    }
+    RS_DEBUG->print("QC_MDIWindow::startAutoSave");
+    document->setGraphicView(graphicView);
+    RS2::FormatType type = graphic->getFormatType();
+    if (type == RS2::FormatUnknown) {
+        type = RS2::FormatDXFRW;
+    }
+    autoSave = std::make_unique<LC_BackgroundSave>(*graphic, graphic->getAutoSaveFilename(), type);
+    autoSave->start();
+    return autoSave.get();
+}
+
+
+
 /**
  * Saves the current file. The user is asked for a new filename
  * and format.
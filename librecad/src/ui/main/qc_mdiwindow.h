@@ -27,6 +27,7 @@
 #ifndef QC_MDIWINDOW_H
 #define QC_MDIWINDOW_H
 
+#include <memory>
 #include <QMdiSubWindow>
 #include <QList>
 #include "rs.h"
@@ -34,6 +35,7 @@
 #include "rs_blocklistlistener.h"
 #include "lc_viewslist.h"
 
+class LC_BackgroundSave;
 class QG_GraphicView;
 class RS_Document;
 class RS_Graphic;
@@ -90,6 +92,13 @@ public:
 
     QC_MDIWindow* getPrintPreview();
 
+    /**
+     * Auto-saves a copy of the drawing by a worker thread, editing continues.
+     * @return the running save, nullptr if the drawing is not modified
+     * or the previous auto-save is still running
+     */
+    LC_BackgroundSave* startAutoSave();
+
     // Methods from RS_LayerListListener Interface:
     void layerListModified(bool) override {
         setWindowModified(document->isModified());
@@ -145,6 +154,8 @@ private:
      */
     QC_MDIWindow* parentWindow{nullptr};
     QMdiArea* cadMdiArea = nullptr;
+    /** Last auto-save, waited for when the window is closed */
+    std::unique_ptr<LC_BackgroundSave> autoSave;
 };
 
 
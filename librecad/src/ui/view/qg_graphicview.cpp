@@ -35,6 +35,7 @@
 #include <QNativeGestureEvent>
 #include <QPoint>
 #include <QPointingDevice>
+#include <QPointer>
 #include <QTimer>
 
 #include "qc_applicationwindow.h"
@@ -67,6 +68,7 @@
 #include "lc_graphicviewport.h"
 #include "lc_graphicviewrenderer.h"
 #include "lc_overlayentitiescontainer.h"
+#include "lc_snapworker.h"
 #include "lc_widgetviewportrenderer.h"
 
 #ifdef EMU_C99
@@ -307,6 +309,41 @@ struct QG_GraphicView::UCSHighlightData {
     }
 };
 
+// Mouse moves queued while the actions handle a previous move, e.g. snapping in a
+// large drawing, are stale: only the newest one is handled, once the queued input
+// events are processed. The last handled move is kept to be handled again when the
+// snap worker solved the intersections for it, by the same action only
+struct QG_GraphicView::MouseMoveData {
+    void post(QMouseEvent *event, QG_GraphicView &view){
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        pending.reset(event->clone());
+#else
+        pending = std::make_unique<QMouseEvent>(*event);
+#endif
+        if (timer == nullptr) {
+            timer = std::make_unique<QTimer>(&view);
+            timer->setSingleShot(true);
+            connect(timer.get(), &QTimer::timeout, &view, &QG_GraphicView::processMouseMove);
+        }
+        if (!timer->isActive()) {
+            timer->start(0);
+        }
+    }
+
+    std::unique_ptr<QMouseEvent> take(){
+        if (timer != nullptr) {
+            timer->stop();
+        }
+        return std::move(pending);
+    }
+
+    std::unique_ptr<QMouseEvent> pending;
+    std::unique_ptr<QMouseEvent> last;
+    // the action which handled the last move
+    QPointer<RS_ActionInterface> lastAction;
+    std::unique_ptr<QTimer> timer;
+};
+
 void createViewRenderer();
 
 /**
@@ -323,6 +360,7 @@ QG_GraphicView::QG_GraphicView(QWidget* parent, RS_Document* doc)
     ,isSmoothScrolling(false)
     , m_panData{std::make_unique<AutoPanData>()}
     , m_ucsHighlightData{std::make_unique<UCSHighlightData>()}
+    , m_mouseMoveData{std::make_unique<MouseMoveData>()}
 {
     RS_DEBUG->print("QG_GraphicView::QG_GraphicView()..");
 
@@ -331,6 +369,7 @@ QG_GraphicView::QG_GraphicView(QWidget* parent, RS_Document* doc)
         doc->setGraphicView(this);
         setDefaultAction(new RS_ActionDefault(*doc, *this));
     }
+    connect(getSnapWorker(), &LC_SnapWorker::intersectionsSolved, this, &QG_GraphicView::repeatMouseMove);
 
     viewport->justSetOffsetAndFactor(0,0,4.0);
     viewport->setBorders(10, 10, 10, 10);
@@ -489,6 +528,7 @@ void QG_GraphicView::resizeEvent(QResizeEvent* e) {
 }
 
 void QG_GraphicView::mousePressEvent(QMouseEvent* event){
+    processPendingMouseMove();
     // pan zoom with middle mouse button
     if (event->button()==Qt::MiddleButton){
         // fixme - sand - rework this and ensure there is not delay for pan start!!!
@@ -502,6 +542,7 @@ void QG_GraphicView::mousePressEvent(QMouseEvent* event){
 }
 
 void QG_GraphicView::mouseDoubleClickEvent(QMouseEvent* e){
+    processPendingMouseMove();
     switch(e->button()){
         default:
             break;
@@ -524,6 +565,7 @@ void QG_GraphicView::mouseDoubleClickEvent(QMouseEvent* e){
 void QG_GraphicView::mouseReleaseEvent(QMouseEvent* event){
     RS_DEBUG->print("QG_GraphicView::mouseReleaseEvent");
 
+    processPendingMouseMove();
     event->accept();
 
     switch (event->button()) {
@@ -616,6 +658,7 @@ void QG_GraphicView::addEditEntityEntry(QMouseEvent* event, QMenu& contextMenu){
 
 void QG_GraphicView::mouseMoveEvent(QMouseEvent* event){
     if (isAutoPan(event)) {
+        processPendingMouseMove();
         startAutoPanTimer(event);
         event->accept();
         return;
@@ -623,7 +666,40 @@ void QG_GraphicView::mouseMoveEvent(QMouseEvent* event){
     m_panData->panTimer.reset();
     // handle auto-panning
     event->accept();
-    eventHandler->mouseMoveEvent(event);
+    m_mouseMoveData->post(event, *this);
+}
+
+void QG_GraphicView::processPendingMouseMove(){
+    std::unique_ptr<QMouseEvent> event = m_mouseMoveData->take();
+    if (event != nullptr) {
+        eventHandler->mouseMoveEvent(event.get());
+    }
+    // the actions handle other input now, the last move is not repeated
+    m_mouseMoveData->last.reset();
+}
+
+void QG_GraphicView::processMouseMove(){
+    std::unique_ptr<QMouseEvent> event = m_mouseMoveData->take();
+    if (event != nullptr) {
+        eventHandler->mouseMoveEvent(event.get());
+        m_mouseMoveData->last = std::move(event);
+        m_mouseMoveData->lastAction = eventHandler->getCurrentAction();
+    }
+}
+
+void QG_GraphicView::repeatMouseMove(){
+    // a pending move finds the solved intersections anyway
+    QMouseEvent* last = m_mouseMoveData->last.get();
+    if (m_mouseMoveData->pending != nullptr || last == nullptr) {
+        return;
+    }
+    // moves with a button held drag, e.g. panning or drawing free lines, and change the
+    // action by each move; a new action waits for a move of its own
+    if (last->buttons() != Qt::NoButton
+        || m_mouseMoveData->lastAction != eventHandler->getCurrentAction()) {
+        return;
+    }
+    eventHandler->mouseMoveEvent(last);
 }
 
 bool QG_GraphicView::event(QEvent *event){
@@ -772,6 +848,9 @@ void QG_GraphicView::tabletEvent(QTabletEvent* e) {
 void QG_GraphicView::leaveEvent(QEvent* e) {
     // stop auto-panning
     m_panData->panTimer.reset();
+    // the cursor is gone, the pending move is stale
+    m_mouseMoveData->take();
+    m_mouseMoveData->last.reset();
     eventHandler->mouseLeaveEvent();
     QWidget::leaveEvent(e);
 }
@@ -795,6 +874,7 @@ void QG_GraphicView::focusInEvent(QFocusEvent* e) {
  * shift or ctrl is pressed.
  */
 void QG_GraphicView::wheelEvent(QWheelEvent *e) {
+    processPendingMouseMove();
     //RS_DEBUG->print("wheel: %d", e->delta());
 
     //printf("state: %d\n", e->state());
@@ -980,6 +1060,7 @@ void QG_GraphicView::keyPressEvent(QKeyEvent * e){
     if (container == nullptr) {
         return;
     }
+    processPendingMouseMove();
 
     bool scroll = false;
     RS2::Direction direction = RS2::Up;
@@ -1013,6 +1094,7 @@ void QG_GraphicView::keyPressEvent(QKeyEvent * e){
 }
 
 void QG_GraphicView::keyReleaseEvent(QKeyEvent * e){
+    processPendingMouseMove();
     eventHandler->keyReleaseEvent(e);
 }
 
@@ -139,6 +139,11 @@ protected:
     void paintEvent(QPaintEvent *)override;
     void resizeEvent(QResizeEvent* e) override;
     void autoPanStep();
+    // Mouse moves are coalesced: only the newest pending move is handled by the actions
+    void processPendingMouseMove();
+    void processMouseMove();
+    // handles the last move again, to snap to the intersections solved by the snap worker
+    void repeatMouseMove();
     void highlightUCSLocation(LC_UCS *ucs) override;
     void ucsHighlightStep();
 
@@ -191,6 +196,8 @@ private:
     std::unique_ptr<AutoPanData> m_panData;
     struct UCSHighlightData;
     std::unique_ptr<UCSHighlightData> m_ucsHighlightData;
+    struct MouseMoveData;
+    std::unique_ptr<MouseMoveData> m_mouseMoveData;
 
     // for scroll bar adjustment
     std::mutex m_scrollbarMutex;
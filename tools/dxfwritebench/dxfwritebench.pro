@@ -0,0 +1,32 @@
+#-------------------------------------------------
+#
+# Times libdxfrw writing a large generated drawing
+#
+#-------------------------------------------------
+
+include(../../common.pri)
+
+QT -= core gui svg
+CONFIG += console thread
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+GENERATED_DIR = ../../generated/tools/dxfwritebench
+
+INCLUDEPATH += ../../libraries/libdxfrw/src
+LIBS += -L../../generated/lib -ldxfrw
+
+SOURCES += main.cpp
+
+unix {
+    macx {
+        TARGET = ../../LibreCAD.app/Contents/MacOS/dxfwritebench
+    } else {
+        TARGET = ../../unix/dxfwritebench
+    }
+}
+
+win32 {
+    TARGET = ../../../windows/dxfwritebench
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2025 LibreCAD.org                                          **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+/**
+ * Times libdxfrw writing a large generated drawing of lines and circles.
+ *
+ * usage: dxfwritebench [output file] [entity count] [-b]
+ * -b writes a binary file instead of an ascii one.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "drw_interface.h"
+#include "libdxfrw.h"
+
+namespace {
+
+// reads nothing and writes the tables with their defaults and the generated entities
+class BenchWriter : public DRW_Interface {
+public:
+    BenchWriter(dxfRW& dxf, size_t count)
+        : m_dxf(dxf), m_count(count) {}
+
+    void addHeader(const DRW_Header*) override {}
+    void addLType(const DRW_LType&) override {}
+    void addLayer(const DRW_Layer&) override {}
+    void addDimStyle(const DRW_Dimstyle&) override {}
+    void addVport(const DRW_Vport&) override {}
+    void addView(const DRW_View&) override {}
+    void addUCS(const DRW_UCS&) override {}
+    void addTextStyle(const DRW_Textstyle&) override {}
+    void addAppId(const DRW_AppId&) override {}
+    void addBlock(const DRW_Block&) override {}
+    void setBlock(const int) override {}
+    void endBlock() override {}
+    void addPoint(const DRW_Point&) override {}
+    void addLine(const DRW_Line&) override {}
+    void addRay(const DRW_Ray&) override {}
+    void addXline(const DRW_Xline&) override {}
+    void addArc(const DRW_Arc&) override {}
+    void addCircle(const DRW_Circle&) override {}
+    void addEllipse(const DRW_Ellipse&) override {}
+    void addLWPolyline(const DRW_LWPolyline&) override {}
+    void addPolyline(const DRW_Polyline&) override {}
+    void addSpline(const DRW_Spline*) override {}
+    void addKnot(const DRW_Entity&) override {}
+    void addInsert(const DRW_Insert&) override {}
+    void addTrace(const DRW_Trace&) override {}
+    void add3dFace(const DRW_3Dface&) override {}
+    void addSolid(const DRW_Solid&) override {}
+    void addMText(const DRW_MText&) override {}
+    void addText(const DRW_Text&) override {}
+    void addDimAlign(const DRW_DimAligned*) override {}
+    void addDimLinear(const DRW_DimLinear*) override {}
+    void addDimRadial(const DRW_DimRadial*) override {}
+    void addDimDiametric(const DRW_DimDiametric*) override {}
+    void addDimAngular(const DRW_DimAngular*) override {}
+    void addDimAngular3P(const DRW_DimAngular3p*) override {}
+    void addDimOrdinate(const DRW_DimOrdinate*) override {}
+    void addLeader(const DRW_Leader*) override {}
+    void addHatch(const DRW_Hatch*) override {}
+    void addViewport(const DRW_Viewport&) override {}
+    void addImage(const DRW_Image*) override {}
+    void linkImage(const DRW_ImageDef*) override {}
+    void addComment(const char*) override {}
+    void addPlotSettings(const DRW_PlotSettings*) override {}
+
+    void writeHeader(DRW_Header&) override {}
+    void writeBlocks() override {}
+    void writeBlockRecords() override {}
+    void writeLTypes() override {}
+    void writeViews() override {}
+    void writeUCSs() override {}
+    void writeTextstyles() override {}
+    void writeVports() override {}
+    void writeDimstyles() override {}
+    void writeObjects() override {}
+    void writeAppId() override {}
+
+    void writeLayers() override {
+        DRW_Layer layer;
+        layer.name = "0";
+        m_dxf.writeLayer(&layer);
+    }
+
+    // a grid of squares, each with a circle inside, so the coordinates have many digits
+    void writeEntities() override {
+        const double step = 10.0 / 3.0;
+        DRW_Line line;
+        DRW_Circle circle;
+        for (size_t i = 0; i < m_count; ++i) {
+            const double x = (i % 1000) * step;
+            const double y = (i / 1000) * step;
+            if (i % 5 == 4) {
+                circle.basePoint = DRW_Coord(x + 0.5 * step, y + 0.5 * step, 0.);
+                circle.radious = 0.4 * step;
+                m_dxf.writeCircle(&circle);
+                continue;
+            }
+            const double dx = (i % 2 == 0) ? step : 0.;
+            const double dy = step - dx;
+            line.basePoint = DRW_Coord(x, y, 0.);
+            line.secPoint = DRW_Coord(x + dx, y + dy, 0.);
+            m_dxf.writeLine(&line);
+        }
+    }
+
+private:
+    dxfRW& m_dxf;
+    size_t m_count = 0;
+};
+}
+
+int main(int argc, char* argv[])
+{
+    const char* fileName = argc > 1 ? argv[1] : "dxfwritebench.dxf";
+    const size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    const bool binary = argc > 3 && std::strcmp(argv[3], "-b") == 0;
+
+    dxfRW dxf(fileName);
+    BenchWriter writer(dxf, count);
+    const auto start = std::chrono::steady_clock::now();
+    const bool success = dxf.write(&writer, DRW::AC1015, binary);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (!success) {
+        std::cerr << "writing " << fileName << " failed" << std::endl;
+        return 1;
+    }
+
+    std::ifstream written(fileName, std::ios::binary | std::ios::ate);
+    const double megabytes = written.tellg() / (1024. * 1024.);
+    std::cout << "wrote " << count << " entities, " << megabytes << " MB, to " << fileName
+              << " in " << elapsed.count() << " ms, "
+              << megabytes / (elapsed.count() / 1000.) << " MB/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2025 LibreCAD.org
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+**********************************************************************/
+
+/**
+ * Times the equation solvers of RS_Math, which find the intersections of
+ * quadratic curves. The same benchmark is built against the current sources,
+ * as solverbench, and against the sources of a previous revision, as
+ * solverbench_baseline, so that the timings of both can be compared:
+ *
+ *   git worktree add ../librecad-baseline <revision>
+ *   cmake -DSOLVERBENCH_BASELINE_DIR=../librecad-baseline ...
+ *   cmake --build . --target solverbench solverbench_baseline
+ *
+ * The baseline solvers take a std::vector for every coefficient set, as
+ * their callers built them for each call.
+ *
+ * usage: solverbench [count]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "rs_math.h"
+#include "rs_vector.h"
+
+namespace {
+
+#ifdef SOLVERBENCH_BASELINE
+const char* const sources = "baseline";
+#else
+const char* const sources = "current";
+#endif
+
+using QuadraticCoefficients = std::array<double, 6>;
+using QuadraticEquations = std::array<QuadraticCoefficients, 2>;
+
+// two random ellipses, rotated slightly, by the coefficients of their equations
+QuadraticEquations randomEllipses(std::mt19937& engine)
+{
+    std::uniform_real_distribution<double> position(-10., 10.);
+    std::uniform_real_distribution<double> scale(0.1, 5.);
+    QuadraticEquations ret;
+    for (QuadraticCoefficients& ce: ret) {
+        const double a = scale(engine);
+        const double c = scale(engine);
+        const double cx = position(engine);
+        const double cy = position(engine);
+        const double r = scale(engine) + 5.;
+        ce = {a, 0.01 * position(engine), c, -2. * a * cx, -2. * c * cy, a * cx * cx + c * cy * cy - r * r};
+    }
+    return ret;
+}
+
+template<typename Solve>
+void report(const char* name, size_t count, Solve solve)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const size_t roots = solve();
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << sources << " " << name << ": " << elapsed.count() << " ms, "
+              << 1.e6 * elapsed.count() / count << " ns per call, "
+              << roots << " roots" << std::endl;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::mt19937 engine{1};
+    std::uniform_real_distribution<double> coefficient(-5., 5.);
+
+    std::vector<QuadraticEquations> equations(count);
+    std::vector<std::array<double, 4>> quartics(count);
+    for (size_t i = 0; i < count; ++i) {
+        equations[i] = randomEllipses(engine);
+        for (double& ce: quartics[i]) {
+            ce = coefficient(engine);
+        }
+    }
+
+    report("quarticSolver", count, [&]() {
+        size_t roots = 0;
+        for (const auto& ce: quartics) {
+#ifdef SOLVERBENCH_BASELINE
+            roots += RS_Math::quarticSolver(std::vector<double>(ce.begin(), ce.end())).size();
+#else
+            roots += RS_Math::quarticSolver(ce).size();
+#endif
+        }
+        return roots;
+    });
+
+    report("simultaneousQuadraticSolverFull", count, [&]() {
+        size_t roots = 0;
+        for (const auto& m: equations) {
+#ifdef SOLVERBENCH_BASELINE
+            const std::vector<std::vector<double>> ce = {{m[0].begin(), m[0].end()},
+                                                         {m[1].begin(), m[1].end()}};
+            roots += RS_Math::simultaneousQuadraticSolverFull(ce).size();
+#else
+            roots += RS_Math::simultaneousQuadraticSolverFull(m).size();
+#endif
+        }
+        return roots;
+    });
+    return 0;
+}
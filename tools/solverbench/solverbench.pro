@@ -0,0 +1,50 @@
+#-------------------------------------------------
+#
+# Times the equation solvers of RS_Math
+#
+#-------------------------------------------------
+
+include(../../common.pri)
+include(../../librecad/src/muparser.pri)
+
+QT -= gui svg
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+GENERATED_DIR = ../../generated/tools/solverbench
+
+LC_SRC = ../../librecad/src/lib
+
+# qmake SOLVERBENCH_BASELINE_DIR=<checkout of a previous revision> builds the benchmark
+# against the solvers of that revision, to compare the timings with the current ones
+!isEmpty(SOLVERBENCH_BASELINE_DIR) {
+    LC_SRC = $$SOLVERBENCH_BASELINE_DIR/librecad/src/lib
+    DEFINES += SOLVERBENCH_BASELINE
+}
+
+INCLUDEPATH += \
+    $$LC_SRC/debug \
+    $$LC_SRC/engine \
+    $$LC_SRC/engine/document/entities \
+    $$LC_SRC/math
+
+SOURCES += \
+    main.cpp \
+    $$LC_SRC/debug/rs_debug.cpp \
+    $$LC_SRC/engine/document/entities/lc_rect.cpp \
+    $$LC_SRC/engine/rs_vector.cpp \
+    $$LC_SRC/math/rs_math.cpp
+
+unix {
+    macx {
+        TARGET = ../../LibreCAD.app/Contents/MacOS/solverbench
+    } else {
+        TARGET = ../../unix/solverbench
+    }
+}
+
+win32 {
+    TARGET = ../../../windows/solverbench
+}
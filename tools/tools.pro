@@ -29,3 +29,4 @@ win32 {
     }
 }
 
+SUBDIRS += solverbench dxfwritebench